@@ -0,0 +1,807 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "../Engine/Core/ArchetypeTable.h"
+#include "../Engine/Core/DeusExMachina.h"
+#include "../Engine/Core/EngineMetrics.h"
+#include "../Engine/Core/EngineTrace.h"
+#include "../Engine/Core/FleetSnapshot.h"
+#include "../Engine/Core/JournalReplay.h"
+#include "../Engine/Core/ShardedWorld.h"
+#include "../Engine/Core/TravelContext.h"
+#include "../Engine/Vehicles/ArchetypeVehicle.h"
+#include "../Engine/Vehicles/Vehicle.h"
+#include "Vehicles/Airplane.h"
+#include "Vehicles/Boat.h"
+#include "Vehicles/Boatplane.h"
+#include "Vehicles/Motorcycle.h"
+#include "Vehicles/Person.h"
+#include "Vehicles/Sedan.h"
+#include "Vehicles/SpeedKernels.h"
+#include "Vehicles/UBoat.h"
+#include "Vehicles/VehicleTypes.h"
+
+using namespace game::vehicles;
+using engine::core::ArchetypeTable;
+using engine::core::DeusExMachina;
+using engine::core::DutyCycleState;
+using engine::core::EngineMetrics;
+using engine::core::EngineTrace;
+using engine::core::FleetSnapshot;
+using engine::core::ShardedWorld;
+using engine::core::TravelContext;
+using engine::core::VehicleHandle;
+using engine::vehicles::ArchetypeVehicle;
+using engine::vehicles::Vehicle;
+
+// ---------------------------------------------------------------------------
+// Allocation counting: every global allocation in the process goes through
+// these replacements, so allocs/op covers engine, game and STL containers.
+// ---------------------------------------------------------------------------
+
+namespace {
+	std::atomic<unsigned long long> gAllocationCount(0);
+}
+
+void* operator new(size_t size)
+{
+	gAllocationCount.fetch_add(1, std::memory_order_relaxed);
+	void* ptr = std::malloc(size > 0 ? size : 1);
+	if (ptr == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	return ptr;
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+	std::free(ptr);
+}
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+struct BenchResult
+{
+	double nsPerOp;
+	double itemsPerSecond;
+	double allocationsPerOp;
+};
+
+// Runs `op` (which performs `opsPerRun` operations) until at least
+// MIN_RUN_TIME has elapsed. `setup` runs untimed before every repetition.
+const std::chrono::milliseconds MIN_RUN_TIME(200);
+
+BenchResult Measure(size_t opsPerRun, size_t itemsPerOp, const std::function<void()>& setup, const std::function<void()>& op)
+{
+	Clock::duration elapsed = Clock::duration::zero();
+	unsigned long long allocations = 0;
+	size_t runs = 0;
+
+	while (runs == 0 || elapsed < MIN_RUN_TIME)
+	{
+		if (setup)
+		{
+			setup();
+		}
+
+		unsigned long long allocationsBefore = gAllocationCount.load(std::memory_order_relaxed);
+		Clock::time_point start = Clock::now();
+		op();
+		elapsed += Clock::now() - start;
+		allocations += gAllocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+		++runs;
+	}
+
+	double totalOps = static_cast<double>(opsPerRun) * runs;
+	double totalNs = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+	BenchResult result;
+	result.nsPerOp = totalNs / totalOps;
+	result.itemsPerSecond = totalNs > 0.0 ? totalOps * itemsPerOp / (totalNs * 1e-9) : 0.0;
+	result.allocationsPerOp = static_cast<double>(allocations) / totalOps;
+	return result;
+}
+
+void PrintHeader()
+{
+	std::cout << std::left << std::setw(34) << "benchmark"
+		<< std::right << std::setw(10) << "fleet"
+		<< std::setw(16) << "ns/op"
+		<< std::setw(20) << "items/sec"
+		<< std::setw(14) << "allocs/op" << '\n';
+	std::cout << std::string(94, '-') << '\n';
+}
+
+void PrintRow(const std::string& name, size_t fleetSize, const BenchResult& result)
+{
+	std::cout << std::left << std::setw(34) << name
+		<< std::right << std::setw(10) << fleetSize
+		<< std::setw(16) << std::fixed << std::setprecision(2) << result.nsPerOp
+		<< std::setw(20) << std::setprecision(0) << result.itemsPerSecond
+		<< std::setw(14) << std::setprecision(3) << result.allocationsPerOp << '\n';
+}
+
+std::unique_ptr<Vehicle> MakeVehicle(size_t i)
+{
+	switch (i % 6)
+	{
+	case 0: return std::make_unique<Airplane>(5);
+	case 1: return std::make_unique<Boat>(5);
+	case 2: return std::make_unique<Boatplane>(5);
+	case 3: return std::make_unique<Motorcycle>();
+	case 4: return std::make_unique<Sedan>();
+	default: return std::make_unique<UBoat>();
+	}
+}
+
+template <typename Engine, typename T>
+void AddLoaded(Engine* engine, std::unique_ptr<T> vehicle, unsigned int weight)
+{
+	vehicle->AddPassenger(std::make_unique<Person>("Bench", weight));
+	engine->AddVehicle(std::move(vehicle));
+}
+
+// Mixed fleet with one passenger per vehicle, registered through the typed
+// AddVehicle path the game uses.
+template <typename Engine>
+void BuildFleet(Engine* engine, size_t fleetSize)
+{
+	engine->ReserveVehicles(fleetSize);
+	for (size_t i = 0; i < fleetSize; ++i)
+	{
+		unsigned int weight = 40 + static_cast<unsigned int>(i % 60);
+		switch (i % 6)
+		{
+		case 0: AddLoaded(engine, std::make_unique<Airplane>(5), weight); break;
+		case 1: AddLoaded(engine, std::make_unique<Boat>(5), weight); break;
+		case 2: AddLoaded(engine, std::make_unique<Boatplane>(5), weight); break;
+		case 3: AddLoaded(engine, std::make_unique<Motorcycle>(), weight); break;
+		case 4: AddLoaded(engine, std::make_unique<Sedan>(), weight); break;
+		default: AddLoaded(engine, std::make_unique<UBoat>(), weight); break;
+		}
+	}
+}
+
+void BenchTravel(size_t fleetSize, unsigned int hours, unsigned int threads)
+{
+	DeusExMachina::ResetInstance();
+	DeusExMachina* engine = DeusExMachina::GetInstance();
+	engine->SetTravelThreadCount(threads);
+	BuildFleet(engine, fleetSize);
+
+	TravelContext context(hours);
+	BenchResult result = Measure(1, fleetSize * hours, nullptr, [engine, &context]() { engine->Travel(context); });
+	PrintRow("DeusExMachina::Travel(" + std::to_string(hours) + "h)", fleetSize, result);
+	DeusExMachina::ResetInstance();
+}
+
+// LAZY mode: Travel only moves the clock for policy vehicles; the query row
+// pays for settling the fleet after each tick.
+void BenchLazyTravel(size_t fleetSize)
+{
+	DeusExMachina engine;
+	BuildFleet(&engine, fleetSize);
+	engine.SetTravelMode(DeusExMachina::TravelMode::LAZY);
+
+	TravelContext context(1);
+	BenchResult travel = Measure(1, fleetSize, nullptr, [&engine, &context]() { engine.Travel(context); });
+	PrintRow("DeusExMachina::Travel(1h) lazy", fleetSize, travel);
+
+	volatile const Vehicle* sink = nullptr;
+	BenchResult query = Measure(1, fleetSize, nullptr, [&engine, &context, &sink]()
+	{
+		engine.Travel(context);
+		sink = engine.GetFurthestTravelled();
+	});
+	(void)sink;
+	PrintRow("lazy Travel(1h)+GetFurthest", fleetSize, query);
+}
+
+// The BuildFleet mix again, once compiled and once as the archetypes that
+// restate it. The stale rows invalidate every max speed before each tick, as
+// a mass boarding would: compiled types recompute one vehicle at a time, the
+// archetype bucket one curve family at a time.
+void BenchArchetypeTravel(size_t fleetSize)
+{
+	ArchetypeTable archetypes;
+	if (!archetypes.Load(MACHINA_DATA_DIR "/Archetypes.txt"))
+	{
+		std::cerr << "Skipping archetype rows: cannot load " MACHINA_DATA_DIR "/Archetypes.txt\n";
+		return;
+	}
+
+	const char* names[] = { "Airplane", "Boat", "Boatplane", "Motorcycle", "Sedan", "UBoat" };
+	DeusExMachina compiled;
+	DeusExMachina restated;
+	BuildFleet(&compiled, fleetSize);
+	restated.ReserveVehicles(fleetSize);
+	for (size_t i = 0; i < fleetSize; ++i)
+	{
+		AddLoaded(&restated, ArchetypeVehicle::Create(archetypes, names[i % 6]), 40 + static_cast<unsigned int>(i % 60));
+	}
+
+	TravelContext context(1);
+	BenchResult travel = Measure(1, fleetSize, nullptr, [&restated, &context]() { restated.Travel(context); });
+	PrintRow("DeusExMachina::Travel(1h) archetype", fleetSize, travel);
+
+	for (DeusExMachina* engine : { &compiled, &restated })
+	{
+		BenchResult stale = Measure(1, fleetSize, [engine]()
+		{
+			for (unsigned int i = 0; i < engine->GetVehicleCount(); ++i)
+			{
+				engine->GetVehicle(engine->GetVehicleHandle(i))->InvalidateMaxSpeed();
+			}
+		}, [engine, &context]() { engine->Travel(context); });
+		PrintRow(engine == &compiled ? "Travel(1h) all stale, compiled" : "Travel(1h) all stale, archetype", fleetSize, stale);
+	}
+}
+
+// One op = a TravelAsync tick awaited, including its view publish; then 1000
+// view reads made while further ticks run in the background.
+void BenchTravelAsync(size_t fleetSize)
+{
+	DeusExMachina engine;
+	BuildFleet(&engine, fleetSize);
+
+	TravelContext context(1);
+	BenchResult tick = Measure(1, fleetSize, nullptr, [&engine, &context]() { engine.TravelAsync(context).get(); });
+	PrintRow("DeusExMachina::TravelAsync(1h)", fleetSize, tick);
+
+	const size_t reads = 1000;
+	VehicleHandle handle = engine.GetVehicleHandle(static_cast<unsigned int>(fleetSize / 2));
+	std::future<void> pending = engine.TravelAsync(context);
+	volatile unsigned int sink = 0;
+	BenchResult read = Measure(reads, 1, nullptr, [&engine, &context, &pending, &sink, handle, reads]()
+	{
+		for (size_t i = 0; i < reads; ++i)
+		{
+			DutyCycleState state;
+			if (engine.GetTravelView()->TryGetState(handle, state))
+			{
+				sink = state.odo;
+			}
+		}
+		if (pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+		{
+			pending = engine.TravelAsync(context);
+		}
+	});
+	(void)sink;
+	pending.get();
+	PrintRow("GetTravelView+TryGetState", fleetSize, read);
+}
+
+// The same fleet split across `shards` engines, each travelling on its own
+// thread.
+void BenchShardedTravel(size_t fleetSize, unsigned int hours, unsigned int shards)
+{
+	ShardedWorld world(shards);
+	BuildFleet(&world, fleetSize);
+
+	TravelContext context(hours);
+	BenchResult result = Measure(1, fleetSize * hours, nullptr, [&world, &context]() { world.Travel(context); });
+	PrintRow("ShardedWorld::Travel(" + std::to_string(hours) + "h)x" + std::to_string(shards), fleetSize, result);
+}
+
+void BenchFurthest(size_t fleetSize)
+{
+	DeusExMachina::ResetInstance();
+	DeusExMachina* engine = DeusExMachina::GetInstance();
+	BuildFleet(engine, fleetSize);
+	engine->Travel(TravelContext(7));
+
+	const size_t queries = 1000;
+	volatile const Vehicle* sink = nullptr;
+	BenchResult result = Measure(queries, 1, nullptr, [engine, &sink, queries]()
+	{
+		for (size_t i = 0; i < queries; ++i)
+		{
+			sink = engine->GetFurthestTravelled();
+		}
+	});
+	(void)sink;
+	PrintRow("DeusExMachina::GetFurthestTravelled", fleetSize, result);
+	DeusExMachina::ResetInstance();
+}
+
+// One op = a tick of a polled leaderboard: Travel(1h), then the furthest
+// vehicle, the top ten and one vehicle's rank.
+void BenchLeaderboard(size_t fleetSize)
+{
+	DeusExMachina engine;
+	BuildFleet(&engine, fleetSize);
+	VehicleHandle tracked = engine.GetVehicleHandle(static_cast<unsigned int>(fleetSize / 2));
+
+	volatile size_t sink = 0;
+	BenchResult result = Measure(1, fleetSize, nullptr, [&engine, &sink, tracked]()
+	{
+		engine.Travel(TravelContext(1));
+		sink = engine.GetFurthestTravelled()->GetOdo();
+		sink = engine.GetTopTravelled(10).size();
+		sink = engine.GetTravelRank(tracked);
+	});
+	(void)sink;
+	PrintRow("Travel(1h)+furthest/top10/rank", fleetSize, result);
+}
+
+// Fastest diver under a weight limit: from the capability store, and by
+// the dynamic_cast scan over the whole fleet it replaces.
+void BenchCapabilityQuery(size_t fleetSize)
+{
+	DeusExMachina engine;
+	BuildFleet(&engine, fleetSize);
+
+	const size_t queries = 100;
+	volatile const Vehicle* sink = nullptr;
+	BenchResult store = Measure(queries, 1, nullptr, [&engine, &sink, queries]()
+	{
+		for (size_t i = 0; i < queries; ++i)
+		{
+			sink = engine.GetFastestCapable(engine::capabilities::Capability::DIVING, 80);
+		}
+	});
+	PrintRow("DeusExMachina::GetFastestCapable", fleetSize, store);
+
+	BenchResult scan = Measure(queries, 1, nullptr, [&engine, &sink, queries]()
+	{
+		for (size_t q = 0; q < queries; ++q)
+		{
+			const UBoat* fastest = nullptr;
+			for (unsigned int i = 0; i < engine.GetVehicleCount(); ++i)
+			{
+				const UBoat* uboat = dynamic_cast<const UBoat*>(engine.GetVehicle(engine.GetVehicleHandle(i)));
+				if (uboat != nullptr && uboat->GetPassengersWeight() <= 80 && (fastest == nullptr || uboat->GetDiveSpeed() > fastest->GetDiveSpeed()))
+				{
+					fastest = uboat;
+				}
+			}
+			sink = fastest;
+		}
+	});
+	(void)sink;
+	PrintRow("dynamic_cast diver scan", fleetSize, scan);
+}
+
+// One op = one vehicle written to / restored from a checkpoint file.
+void BenchSnapshot(size_t fleetSize)
+{
+	const char* path = "machina_bench.snapshot";
+	engine::core::VehicleTypeRegistry vehicleTypes;
+	RegisterVehicleTypes(vehicleTypes);
+	FleetSnapshot snapshot(vehicleTypes);
+
+	DeusExMachina::ResetInstance();
+	DeusExMachina* engine = DeusExMachina::GetInstance();
+	BuildFleet(engine, fleetSize);
+	engine->Travel(TravelContext(7));
+
+	BenchResult save = Measure(fleetSize, 1, nullptr, [&snapshot, engine, path]() { snapshot.Save(*engine, path); });
+	PrintRow("FleetSnapshot::Save", fleetSize, save);
+
+	BenchResult restore = Measure(fleetSize, 1, []() { DeusExMachina::ResetInstance(); }, [&snapshot, path]()
+	{
+		snapshot.Restore(*DeusExMachina::GetInstance(), path);
+	});
+	PrintRow("FleetSnapshot::Restore", fleetSize, restore);
+
+	std::remove(path);
+	DeusExMachina::ResetInstance();
+}
+
+// Travel with a journal attached, then one op = one vehicle rebuilt from a
+// journal of its addition and 24 one-hour ticks.
+void BenchJournal(size_t fleetSize)
+{
+	const char* path = "machina_bench.journal";
+	const unsigned int ticks = 24;
+	engine::core::VehicleTypeRegistry vehicleTypes;
+	RegisterVehicleTypes(vehicleTypes);
+
+	DeusExMachina::ResetInstance();
+	DeusExMachina* engine = DeusExMachina::GetInstance();
+	BuildFleet(engine, fleetSize);
+	engine->StartJournal(path, vehicleTypes);
+
+	TravelContext context(1);
+	BenchResult travel = Measure(1, fleetSize, nullptr, [engine, &context]() { engine->Travel(context); });
+	PrintRow("DeusExMachina::Travel(1h)+journal", fleetSize, travel);
+
+	engine->StartJournal(path, vehicleTypes);
+	for (unsigned int tick = 0; tick < ticks; ++tick)
+	{
+		engine->Travel(context);
+	}
+	engine->StopJournal();
+
+	engine::core::JournalReplay replay(vehicleTypes);
+	BenchResult result = Measure(fleetSize, 1, []() { DeusExMachina::ResetInstance(); }, [&replay, path]()
+	{
+		replay.Replay(*DeusExMachina::GetInstance(), path);
+	});
+	PrintRow("JournalReplay::Replay(24x1h)", fleetSize, result);
+
+	std::remove(path);
+	DeusExMachina::ResetInstance();
+}
+
+// One op = one loaded vehicle removed, as seen by the tick thread: buried and
+// handed to the reclaim thread by the next Travel, or (the old inline cost)
+// destroyed on the spot. The reclaim thread finishes during the next setup.
+void BenchGraveyard(size_t fleetSize)
+{
+	using engine::core::Graveyard;
+
+	std::unique_ptr<DeusExMachina> engine;
+	for (Graveyard::ReclaimMode mode : { Graveyard::ReclaimMode::BACKGROUND, Graveyard::ReclaimMode::IDLE })
+	{
+		BenchResult result = Measure(fleetSize, 1, [&engine, fleetSize, mode]()
+		{
+			engine.reset();
+			engine = std::make_unique<DeusExMachina>();
+			engine->GetGraveyard().SetReclaimMode(mode);
+			BuildFleet(engine.get(), fleetSize);
+		}, [&engine, mode]()
+		{
+			while (engine->GetVehicleCount() > 0)
+			{
+				engine->RemoveVehicle(engine->GetVehicleCount() - 1);
+			}
+			engine->Travel(TravelContext(1));
+			if (mode == Graveyard::ReclaimMode::IDLE)
+			{
+				engine->GetGraveyard().ReclaimAll();
+			}
+		});
+		PrintRow(mode == Graveyard::ReclaimMode::BACKGROUND ? "RemoveVehicle, graveyard" : "RemoveVehicle, destroyed inline", fleetSize, result);
+	}
+	engine.reset();
+}
+
+// Travel while a trace session records every scope; compare with the plain
+// Travel(1h) row. Allocations include the flusher thread's. Skipped when
+// --trace already holds the session.
+void BenchTrace(size_t fleetSize, unsigned int threads)
+{
+	const char* path = "machina_bench_trace.json";
+	DeusExMachina engine;
+	engine.SetTravelThreadCount(threads);
+	BuildFleet(&engine, fleetSize);
+	if (!EngineTrace::Start(path))
+	{
+		return;
+	}
+
+	TravelContext context(1);
+	BenchResult travel = Measure(1, fleetSize, nullptr, [&engine, &context]() { engine.Travel(context); });
+	EngineTrace::Stop();
+	std::remove(path);
+	PrintRow("DeusExMachina::Travel(1h)+trace", fleetSize, travel);
+}
+
+// One op = board one passenger and release it again, spread over the fleet.
+void BenchPassengers(size_t fleetSize)
+{
+	std::vector<std::unique_ptr<Vehicle>> fleet;
+	fleet.reserve(fleetSize);
+	for (size_t i = 0; i < fleetSize; ++i)
+	{
+		fleet.push_back(MakeVehicle(i));
+	}
+
+	BenchResult result = Measure(fleetSize, 1, nullptr, [&fleet]()
+	{
+		for (std::unique_ptr<Vehicle>& vehicle : fleet)
+		{
+			vehicle->AddPassenger(std::make_unique<Person>("Bench", 70));
+		}
+		for (std::unique_ptr<Vehicle>& vehicle : fleet)
+		{
+			vehicle->ReleasePassenger(vehicle->GetPassengersCount() - 1);
+		}
+	});
+	PrintRow("Vehicle::AddPassenger+Release", fleetSize, result);
+}
+
+// The same boarding routed through the command queue: enqueue one passenger
+// per vehicle, apply the batch, then drop them again directly.
+void BenchCommandQueue(size_t fleetSize)
+{
+	DeusExMachina engine;
+	BuildFleet(&engine, fleetSize);
+	std::vector<VehicleHandle> handles;
+	for (size_t i = 0; i < fleetSize; ++i)
+	{
+		handles.push_back(engine.GetVehicleHandle(static_cast<unsigned int>(i)));
+	}
+
+	BenchResult result = Measure(fleetSize, 1, nullptr, [&engine, &handles]()
+	{
+		for (VehicleHandle handle : handles)
+		{
+			engine.EnqueueAddPassenger(handle, std::make_unique<Person>("Bench", 70));
+		}
+		engine.ApplyCommands();
+		for (VehicleHandle handle : handles)
+		{
+			Vehicle* vehicle = engine.GetVehicle(handle);
+			vehicle->ReleasePassenger(vehicle->GetPassengersCount() - 1);
+		}
+	});
+	PrintRow("EnqueueAddPassenger+Apply", fleetSize, result);
+}
+
+// One op = a seat plan for a pool as large as the fleet.
+void BenchBoardingPlan(size_t fleetSize, unsigned int threads)
+{
+	DeusExMachina engine;
+	engine.SetTravelThreadCount(threads);
+	BuildFleet(&engine, fleetSize);
+
+	std::vector<std::unique_ptr<const engine::interfaces::IPassenger>> pool;
+	for (size_t i = 0; i < fleetSize; ++i)
+	{
+		pool.push_back(std::make_unique<Person>("Bench", 30 + static_cast<unsigned int>(i * 37 % 90)));
+	}
+
+	volatile double sink = 0.0;
+	BenchResult result = Measure(1, fleetSize, nullptr, [&engine, &pool, &sink]()
+	{
+		sink = engine.PlanBoarding(pool).distancePerTick;
+	});
+	(void)sink;
+	PrintRow("DeusExMachina::PlanBoarding", fleetSize, result);
+}
+
+// One op = merging one loaded Airplane/Boat pair into a Boatplane.
+void BenchMerge(size_t fleetSize)
+{
+	std::vector<Airplane> planes;
+	std::vector<Boat> boats;
+	std::vector<Boatplane> merged;
+
+	// The merged vehicles are kept, as a game would, and freed untimed.
+	std::function<void()> setup = [&planes, &boats, &merged, fleetSize]()
+	{
+		merged.clear();
+		merged.shrink_to_fit();
+		planes.clear();
+		boats.clear();
+		planes.reserve(fleetSize);
+		boats.reserve(fleetSize);
+		for (size_t i = 0; i < fleetSize; ++i)
+		{
+			planes.emplace_back(5);
+			boats.emplace_back(5);
+			planes.back().AddPassenger(std::make_unique<Person>("Pilot", 80));
+			planes.back().AddPassenger(std::make_unique<Person>("Guest", 60));
+			boats.back().AddPassenger(std::make_unique<Person>("Sailor", 75));
+		}
+	};
+
+	BenchResult result = Measure(fleetSize, 1, setup, [&planes, &boats, &merged, fleetSize]()
+	{
+		merged.reserve(fleetSize);
+		for (size_t i = 0; i < fleetSize; ++i)
+		{
+			merged.push_back(planes[i] + boats[i]);
+		}
+	});
+	PrintRow("Airplane::operator+(Boat&)", fleetSize, result);
+
+	BenchResult convoy = Measure(fleetSize, 1, setup, [&planes, &boats, &merged]()
+	{
+		merged = Boatplane::MergeConvoy(planes, boats);
+	});
+	PrintRow("Boatplane::MergeConvoy", fleetSize, convoy);
+}
+
+// Cold = recompute the speed curve every call; warm = memoized read.
+template <typename T, typename Factory>
+void BenchMaxSpeed(const char* typeName, size_t fleetSize, Factory factory)
+{
+	std::vector<std::unique_ptr<T>> fleet;
+	fleet.reserve(fleetSize);
+	for (size_t i = 0; i < fleetSize; ++i)
+	{
+		fleet.push_back(factory());
+		fleet.back()->AddPassenger(std::make_unique<Person>("Bench", 40 + static_cast<unsigned int>(i % 60)));
+	}
+
+	volatile unsigned int sink = 0;
+	BenchResult cold = Measure(fleetSize, 1, nullptr, [&fleet, &sink]()
+	{
+		for (std::unique_ptr<T>& vehicle : fleet)
+		{
+			vehicle->InvalidateMaxSpeed();
+			sink = vehicle->GetMaxSpeed();
+		}
+	});
+	BenchResult warm = Measure(fleetSize, 1, nullptr, [&fleet, &sink]()
+	{
+		for (std::unique_ptr<T>& vehicle : fleet)
+		{
+			sink = vehicle->GetMaxSpeed();
+		}
+	});
+	(void)sink;
+
+	PrintRow(std::string(typeName) + "::GetMaxSpeed (cold)", fleetSize, cold);
+	PrintRow(std::string(typeName) + "::GetMaxSpeed (warm)", fleetSize, warm);
+}
+
+// One op = one vehicle reweighed, through its virtual per-vehicle curve or
+// through the batch kernel for its type.
+template <typename T>
+void BenchSpeedKernel(const char* typeName, size_t fleetSize, const T& prototype)
+{
+	std::vector<unsigned int> weights;
+	weights.reserve(fleetSize);
+	for (size_t i = 0; i < fleetSize; ++i)
+	{
+		weights.push_back(40 + static_cast<unsigned int>(i * 37 % 400));
+	}
+	std::vector<unsigned int> speeds(fleetSize);
+
+	const Vehicle& vehicle = prototype;
+	BenchResult perVehicle = Measure(fleetSize, 1, nullptr, [&vehicle, &weights, &speeds]()
+	{
+		for (size_t i = 0; i < weights.size(); ++i)
+		{
+			speeds[i] = vehicle.EstimateMaxSpeed(weights[i]);
+		}
+	});
+	BenchResult batch = Measure(fleetSize, 1, nullptr, [&prototype, &weights, &speeds]()
+	{
+		kernels::EstimateMaxSpeeds(prototype, weights.data(), speeds.data(), weights.size());
+	});
+
+	PrintRow(std::string(typeName) + "::EstimateMaxSpeed", fleetSize, perVehicle);
+	PrintRow(std::string(typeName) + (kernels::IsVectorized() ? " kernel (AVX2)" : " kernel (scalar)"), fleetSize, batch);
+}
+
+void PrintUsage()
+{
+	std::cout << "Usage: MachinaBench [--max-fleet N] [--threads N] [--shards N] [--metrics text|json] [--trace PATH]\n"
+		<< "  --max-fleet N   largest fleet size (default 1000000); sizes step by 10x from 10\n"
+		<< "  --threads N     DeusExMachina travel threads (default 1)\n"
+		<< "  --shards N      also travel the fleet as a ShardedWorld of N shards\n"
+		<< "  --metrics FMT   dump the engine metrics gathered over the run\n"
+		<< "  --trace PATH    record the whole run as a Chrome trace (open in ui.perfetto.dev)\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+	size_t maxFleet = 1000000;
+	unsigned int threads = 1;
+	unsigned int shards = 0;
+	const char* metricsFormat = nullptr;
+	const char* tracePath = nullptr;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--max-fleet") == 0 && i + 1 < argc)
+		{
+			maxFleet = static_cast<size_t>(std::strtoull(argv[++i], nullptr, 10));
+		}
+		else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+		{
+			threads = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else if (std::strcmp(argv[i], "--shards") == 0 && i + 1 < argc)
+		{
+			shards = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else if (std::strcmp(argv[i], "--metrics") == 0 && i + 1 < argc
+			&& (std::strcmp(argv[i + 1], "text") == 0 || std::strcmp(argv[i + 1], "json") == 0))
+		{
+			metricsFormat = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+		{
+			tracePath = argv[++i];
+		}
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	std::vector<size_t> fleetSizes;
+	for (size_t size = 10; size <= maxFleet; size *= 10)
+	{
+		fleetSizes.push_back(size);
+	}
+
+	if (tracePath != nullptr && !EngineTrace::Start(tracePath))
+	{
+		std::cerr << "Cannot trace to " << tracePath << (EngineTrace::IS_ENABLED ? "\n" : " (MACHINA_ENABLE_TRACING=OFF)\n");
+		return 1;
+	}
+
+	PrintHeader();
+	for (size_t fleetSize : fleetSizes)
+	{
+		BenchTravel(fleetSize, 1, threads);
+		BenchTravel(fleetSize, 24, threads);
+		BenchLazyTravel(fleetSize);
+		BenchArchetypeTravel(fleetSize);
+		BenchTravelAsync(fleetSize);
+		if (shards > 0)
+		{
+			BenchShardedTravel(fleetSize, 1, shards);
+			BenchShardedTravel(fleetSize, 24, shards);
+		}
+		BenchFurthest(fleetSize);
+		BenchLeaderboard(fleetSize);
+		BenchCapabilityQuery(fleetSize);
+		BenchSnapshot(fleetSize);
+		BenchJournal(fleetSize);
+		BenchTrace(fleetSize, threads);
+		BenchPassengers(fleetSize);
+		BenchCommandQueue(fleetSize);
+		BenchGraveyard(fleetSize);
+		BenchBoardingPlan(fleetSize, threads);
+		BenchMerge(fleetSize);
+		BenchMaxSpeed<Airplane>("Airplane", fleetSize, []() { return std::make_unique<Airplane>(5); });
+		BenchMaxSpeed<Boat>("Boat", fleetSize, []() { return std::make_unique<Boat>(5); });
+		BenchMaxSpeed<Boatplane>("Boatplane", fleetSize, []() { return std::make_unique<Boatplane>(5); });
+		BenchMaxSpeed<Motorcycle>("Motorcycle", fleetSize, []() { return std::make_unique<Motorcycle>(); });
+		BenchMaxSpeed<Sedan>("Sedan", fleetSize, []() { return std::make_unique<Sedan>(); });
+		BenchMaxSpeed<UBoat>("UBoat", fleetSize, []() { return std::make_unique<UBoat>(); });
+		BenchSpeedKernel("Airplane", fleetSize, Airplane(5));
+		BenchSpeedKernel("Boatplane", fleetSize, Boatplane(5));
+		BenchSpeedKernel("Motorcycle", fleetSize, Motorcycle());
+		BenchSpeedKernel("UBoat", fleetSize, UBoat());
+		std::cout << '\n';
+	}
+
+	if (tracePath != nullptr)
+	{
+		EngineTrace::Stop();
+		std::cout << "trace: " << tracePath << " (" << EngineTrace::GetDroppedCount() << " events dropped)\n";
+	}
+
+	if (metricsFormat != nullptr)
+	{
+		std::cout << (std::strcmp(metricsFormat, "json") == 0 ? EngineMetrics::ToJson() + "\n" : EngineMetrics::ToText());
+	}
+
+	return 0;
+}
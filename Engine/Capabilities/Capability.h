@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+
+namespace engine {
+namespace capabilities {
+
+// Ways a vehicle can move; one per capability class.
+enum class Capability : uint8_t
+{
+	DRIVING,
+	FLYING,
+	SAILING,
+	DIVING,
+};
+
+static constexpr unsigned int CAPABILITY_COUNT = 4;
+
+// One bit per Capability.
+typedef uint8_t CapabilityMask;
+
+constexpr CapabilityMask ToMask(Capability capability)
+{
+	return static_cast<CapabilityMask>(1u << static_cast<unsigned int>(capability));
+}
+
+} // namespace capabilities
+} // namespace engine
@@ -1,13 +1,27 @@
 #include "DivingCapability.h"
+#include "../Vehicles/Vehicle.h"
 
 namespace engine {
 namespace capabilities {
 
-DivingCapability::DivingCapability(unsigned int diveSpeed)
+DivingCapability::DivingCapability(unsigned int diveSpeed, vehicles::Vehicle* owner)
 	: mDiveSpeed(diveSpeed)
+	, mOwner(owner)
 {
 }
 
+DivingCapability::DivingCapability(const DivingCapability& other)
+	: mDiveSpeed(other.mDiveSpeed)
+	, mOwner(nullptr)
+{
+}
+
+DivingCapability& DivingCapability::operator=(const DivingCapability& rhs)
+{
+	SetDiveSpeed(rhs.mDiveSpeed);
+	return *this;
+}
+
 unsigned int DivingCapability::GetDiveSpeed() const
 {
 	return mDiveSpeed;
@@ -16,6 +30,10 @@ unsigned int DivingCapability::GetDiveSpeed() const
 void DivingCapability::SetDiveSpeed(unsigned int speed)
 {
 	mDiveSpeed = speed;
+	if (mOwner != nullptr)
+	{
+		mOwner->InvalidateMaxSpeed();
+	}
 }
 
 } // namespace capabilities
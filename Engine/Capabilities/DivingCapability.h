@@ -1,23 +1,30 @@
 #pragma once
 
 namespace engine {
+namespace vehicles {
+class Vehicle;
+} // namespace vehicles
+
 namespace capabilities {
 
 class DivingCapability
 {
 public:
-	explicit DivingCapability(unsigned int diveSpeed);
+	// The owner, if any, has its memoized max speed invalidated whenever the
+	// speed parameter changes.
+	explicit DivingCapability(unsigned int diveSpeed, vehicles::Vehicle* owner = nullptr);
 	~DivingCapability() = default;
 
-	// Copyable
-	DivingCapability(const DivingCapability&) = default;
-	DivingCapability& operator=(const DivingCapability&) = default;
+	// Copyable. Copies take the parameter but not the owner.
+	DivingCapability(const DivingCapability& other);
+	DivingCapability& operator=(const DivingCapability& rhs);
 
 	unsigned int GetDiveSpeed() const;
 	void SetDiveSpeed(unsigned int speed);
 
 private:
 	unsigned int mDiveSpeed;
+	vehicles::Vehicle* mOwner;
 };
 
 } // namespace capabilities
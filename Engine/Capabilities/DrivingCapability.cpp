@@ -1,13 +1,27 @@
 #include "DrivingCapability.h"
+#include "../Vehicles/Vehicle.h"
 
 namespace engine {
 namespace capabilities {
 
-DrivingCapability::DrivingCapability(unsigned int driveSpeed)
+DrivingCapability::DrivingCapability(unsigned int driveSpeed, vehicles::Vehicle* owner)
 	: mDriveSpeed(driveSpeed)
+	, mOwner(owner)
 {
 }
 
+DrivingCapability::DrivingCapability(const DrivingCapability& other)
+	: mDriveSpeed(other.mDriveSpeed)
+	, mOwner(nullptr)
+{
+}
+
+DrivingCapability& DrivingCapability::operator=(const DrivingCapability& rhs)
+{
+	SetDriveSpeed(rhs.mDriveSpeed);
+	return *this;
+}
+
 unsigned int DrivingCapability::GetDriveSpeed() const
 {
 	return mDriveSpeed;
@@ -16,6 +30,10 @@ unsigned int DrivingCapability::GetDriveSpeed() const
 void DrivingCapability::SetDriveSpeed(unsigned int speed)
 {
 	mDriveSpeed = speed;
+	if (mOwner != nullptr)
+	{
+		mOwner->InvalidateMaxSpeed();
+	}
 }
 
 } // namespace capabilities
@@ -1,23 +1,30 @@
 #pragma once
 
 namespace engine {
+namespace vehicles {
+class Vehicle;
+} // namespace vehicles
+
 namespace capabilities {
 
 class DrivingCapability
 {
 public:
-	explicit DrivingCapability(unsigned int driveSpeed);
+	// The owner, if any, has its memoized max speed invalidated whenever the
+	// speed parameter changes.
+	explicit DrivingCapability(unsigned int driveSpeed, vehicles::Vehicle* owner = nullptr);
 	~DrivingCapability() = default;
 
-	// Copyable
-	DrivingCapability(const DrivingCapability&) = default;
-	DrivingCapability& operator=(const DrivingCapability&) = default;
+	// Copyable. Copies take the parameter but not the owner.
+	DrivingCapability(const DrivingCapability& other);
+	DrivingCapability& operator=(const DrivingCapability& rhs);
 
 	unsigned int GetDriveSpeed() const;
 	void SetDriveSpeed(unsigned int speed);
 
 private:
 	unsigned int mDriveSpeed;
+	vehicles::Vehicle* mOwner;
 };
 
 } // namespace capabilities
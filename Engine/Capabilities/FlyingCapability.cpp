@@ -1,13 +1,27 @@
 #include "FlyingCapability.h"
+#include "../Vehicles/Vehicle.h"
 
 namespace engine {
 namespace capabilities {
 
-FlyingCapability::FlyingCapability(unsigned int flySpeed)
+FlyingCapability::FlyingCapability(unsigned int flySpeed, vehicles::Vehicle* owner)
 	: mFlySpeed(flySpeed)
+	, mOwner(owner)
 {
 }
 
+FlyingCapability::FlyingCapability(const FlyingCapability& other)
+	: mFlySpeed(other.mFlySpeed)
+	, mOwner(nullptr)
+{
+}
+
+FlyingCapability& FlyingCapability::operator=(const FlyingCapability& rhs)
+{
+	SetFlySpeed(rhs.mFlySpeed);
+	return *this;
+}
+
 unsigned int FlyingCapability::GetFlySpeed() const
 {
 	return mFlySpeed;
@@ -16,6 +30,10 @@ unsigned int FlyingCapability::GetFlySpeed() const
 void FlyingCapability::SetFlySpeed(unsigned int speed)
 {
 	mFlySpeed = speed;
+	if (mOwner != nullptr)
+	{
+		mOwner->InvalidateMaxSpeed();
+	}
 }
 
 } // namespace capabilities
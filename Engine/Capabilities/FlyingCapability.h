@@ -1,23 +1,30 @@
 #pragma once
 
 namespace engine {
+namespace vehicles {
+class Vehicle;
+} // namespace vehicles
+
 namespace capabilities {
 
 class FlyingCapability
 {
 public:
-	explicit FlyingCapability(unsigned int flySpeed);
+	// The owner, if any, has its memoized max speed invalidated whenever the
+	// speed parameter changes.
+	explicit FlyingCapability(unsigned int flySpeed, vehicles::Vehicle* owner = nullptr);
 	~FlyingCapability() = default;
 
-	// Copyable
-	FlyingCapability(const FlyingCapability&) = default;
-	FlyingCapability& operator=(const FlyingCapability&) = default;
+	// Copyable. Copies take the parameter but not the owner.
+	FlyingCapability(const FlyingCapability& other);
+	FlyingCapability& operator=(const FlyingCapability& rhs);
 
 	unsigned int GetFlySpeed() const;
 	void SetFlySpeed(unsigned int speed);
 
 private:
 	unsigned int mFlySpeed;
+	vehicles::Vehicle* mOwner;
 };
 
 } // namespace capabilities
@@ -1,13 +1,27 @@
 #include "SailingCapability.h"
+#include "../Vehicles/Vehicle.h"
 
 namespace engine {
 namespace capabilities {
 
-SailingCapability::SailingCapability(unsigned int sailSpeed)
+SailingCapability::SailingCapability(unsigned int sailSpeed, vehicles::Vehicle* owner)
 	: mSailSpeed(sailSpeed)
+	, mOwner(owner)
 {
 }
 
+SailingCapability::SailingCapability(const SailingCapability& other)
+	: mSailSpeed(other.mSailSpeed)
+	, mOwner(nullptr)
+{
+}
+
+SailingCapability& SailingCapability::operator=(const SailingCapability& rhs)
+{
+	SetSailSpeed(rhs.mSailSpeed);
+	return *this;
+}
+
 unsigned int SailingCapability::GetSailSpeed() const
 {
 	return mSailSpeed;
@@ -16,6 +30,10 @@ unsigned int SailingCapability::GetSailSpeed() const
 void SailingCapability::SetSailSpeed(unsigned int speed)
 {
 	mSailSpeed = speed;
+	if (mOwner != nullptr)
+	{
+		mOwner->InvalidateMaxSpeed();
+	}
 }
 
 } // namespace capabilities
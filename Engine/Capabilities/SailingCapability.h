@@ -1,23 +1,30 @@
 #pragma once
 
 namespace engine {
+namespace vehicles {
+class Vehicle;
+} // namespace vehicles
+
 namespace capabilities {
 
 class SailingCapability
 {
 public:
-	explicit SailingCapability(unsigned int sailSpeed);
+	// The owner, if any, has its memoized max speed invalidated whenever the
+	// speed parameter changes.
+	explicit SailingCapability(unsigned int sailSpeed, vehicles::Vehicle* owner = nullptr);
 	~SailingCapability() = default;
 
-	// Copyable
-	SailingCapability(const SailingCapability&) = default;
-	SailingCapability& operator=(const SailingCapability&) = default;
+	// Copyable. Copies take the parameter but not the owner.
+	SailingCapability(const SailingCapability& other);
+	SailingCapability& operator=(const SailingCapability& rhs);
 
 	unsigned int GetSailSpeed() const;
 	void SetSailSpeed(unsigned int speed);
 
 private:
 	unsigned int mSailSpeed;
+	vehicles::Vehicle* mOwner;
 };
 
 } // namespace capabilities
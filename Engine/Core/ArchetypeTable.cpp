@@ -0,0 +1,498 @@
+#include <atomic>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#include "ArchetypeTable.h"
+
+namespace engine {
+namespace core {
+
+using capabilities::Capability;
+using capabilities::ToMask;
+
+namespace {
+
+	unsigned int RoundSpeed(double speed, double floor)
+	{
+		double clamped = speed > floor ? speed : floor;
+		if (!(clamped < static_cast<double>(UINT_MAX)))
+		{
+			// Also catches NaN, which fails every comparison.
+			return clamped > 0.0 ? UINT_MAX : 0;
+		}
+		return static_cast<unsigned int>(clamped + 0.5);
+	}
+
+	std::vector<std::string_view> SplitWords(std::string_view line, char separator)
+	{
+		std::vector<std::string_view> words;
+		size_t i = 0;
+		while (i < line.size())
+		{
+			if (line[i] == separator || (separator == ' ' && line[i] == '\t'))
+			{
+				++i;
+				continue;
+			}
+			size_t end = i;
+			while (end < line.size() && line[end] != separator && !(separator == ' ' && line[end] == '\t'))
+			{
+				++end;
+			}
+			words.push_back(line.substr(i, end - i));
+			i = end;
+		}
+		return words;
+	}
+
+	bool ParseUnsigned(std::string_view word, unsigned int& outValue)
+	{
+		std::string text(word);
+		char* end = nullptr;
+		unsigned long value = std::strtoul(text.c_str(), &end, 10);
+		if (text.empty() || text[0] == '-' || *end != '\0' || value > UINT_MAX)
+		{
+			return false;
+		}
+		outValue = static_cast<unsigned int>(value);
+		return true;
+	}
+
+	bool ParseDouble(std::string_view word, double& outValue)
+	{
+		std::string text(word);
+		char* end = nullptr;
+		double value = std::strtod(text.c_str(), &end);
+		if (text.empty() || *end != '\0' || !std::isfinite(value))
+		{
+			return false;
+		}
+		outValue = value;
+		return true;
+	}
+
+	bool ParseCapability(std::string_view word, Capability& outCapability)
+	{
+		static const char* const NAMES[capabilities::CAPABILITY_COUNT] = { "driving", "flying", "sailing", "diving" };
+		for (unsigned int i = 0; i < capabilities::CAPABILITY_COUNT; ++i)
+		{
+			if (word == NAMES[i])
+			{
+				outCapability = static_cast<Capability>(i);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool ParseFamily(std::string_view word, ArchetypeTable::CurveFamily& outFamily)
+	{
+		static const char* const NAMES[ArchetypeTable::CURVE_FAMILY_COUNT] = { "linear", "exponential", "logarithmic", "cubic", "tiered" };
+		for (size_t i = 0; i < ArchetypeTable::CURVE_FAMILY_COUNT; ++i)
+		{
+			if (word == NAMES[i])
+			{
+				outFamily = static_cast<ArchetypeTable::CurveFamily>(i);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// "80:0,160:22,*:180", appended to `outTiers`; limits must rise.
+	bool ParseTiers(std::string_view text, std::vector<ArchetypeTable::Tier>& outTiers)
+	{
+		std::vector<std::string_view> entries = SplitWords(text, ',');
+		size_t first = outTiers.size();
+		if (entries.empty())
+		{
+			return false;
+		}
+
+		for (std::string_view entry : entries)
+		{
+			size_t colon = entry.find(':');
+			if (colon == std::string_view::npos)
+			{
+				return false;
+			}
+
+			ArchetypeTable::Tier tier;
+			std::string_view limit = entry.substr(0, colon);
+			if (limit == "*")
+			{
+				tier.maxWeight = UINT_MAX;
+			}
+			else if (!ParseUnsigned(limit, tier.maxWeight))
+			{
+				return false;
+			}
+			if (!ParseUnsigned(entry.substr(colon + 1), tier.cut))
+			{
+				return false;
+			}
+			if (outTiers.size() > first && tier.maxWeight <= outTiers.back().maxWeight)
+			{
+				return false;
+			}
+			outTiers.push_back(tier);
+		}
+		return true;
+	}
+
+	// `speed <capability> <family> key=value...`, minus the first word.
+	bool ParseCurve(const std::vector<std::string_view>& words, ArchetypeTable::Curve& outCurve, std::vector<ArchetypeTable::Tier>& tiers)
+	{
+		typedef ArchetypeTable::CurveFamily CurveFamily;
+
+		if (words.size() < 4 || !ParseCapability(words[1], outCurve.capability) || !ParseFamily(words[2], outCurve.family))
+		{
+			return false;
+		}
+
+		// Which of slope/scale (a) and divisor/falloff/offset (b) the family takes.
+		const char* aName = nullptr;
+		const char* bName = nullptr;
+		switch (outCurve.family)
+		{
+		case CurveFamily::LINEAR: aName = "slope"; bName = "divisor"; break;
+		case CurveFamily::EXPONENTIAL: aName = "scale"; bName = "falloff"; break;
+		case CurveFamily::LOGARITHMIC: aName = "scale"; bName = "offset"; break;
+		case CurveFamily::CUBIC: aName = "slope"; bName = "divisor"; break;
+		case CurveFamily::TIERED: break;
+		}
+
+		bool isBaseSet = false;
+		outCurve.a = outCurve.family == CurveFamily::EXPONENTIAL || outCurve.family == CurveFamily::LOGARITHMIC ? 1.0 : 0.0;
+		outCurve.b = outCurve.family == CurveFamily::LOGARITHMIC ? 0.0 : 1.0;
+		outCurve.floor = 0.0;
+		outCurve.firstTier = static_cast<uint32_t>(tiers.size());
+		outCurve.tierCount = 0;
+		for (size_t i = 3; i < words.size(); ++i)
+		{
+			size_t equals = words[i].find('=');
+			if (equals == std::string_view::npos)
+			{
+				return false;
+			}
+
+			std::string_view key = words[i].substr(0, equals);
+			std::string_view value = words[i].substr(equals + 1);
+			bool isParsed = false;
+			if (key == "base")
+			{
+				isParsed = ParseDouble(value, outCurve.baseSpeed) && outCurve.baseSpeed >= 0.0;
+				isBaseSet = true;
+			}
+			else if (key == "floor")
+			{
+				isParsed = ParseDouble(value, outCurve.floor) && outCurve.floor >= 0.0;
+			}
+			else if (aName != nullptr && key == aName)
+			{
+				isParsed = ParseDouble(value, outCurve.a);
+			}
+			else if (bName != nullptr && key == bName)
+			{
+				isParsed = ParseDouble(value, outCurve.b);
+			}
+			else if (outCurve.family == CurveFamily::TIERED && key == "tiers" && outCurve.tierCount == 0)
+			{
+				isParsed = ParseTiers(value, tiers);
+				outCurve.tierCount = static_cast<uint32_t>(tiers.size()) - outCurve.firstTier;
+			}
+			if (!isParsed)
+			{
+				return false;
+			}
+		}
+
+		if (!isBaseSet)
+		{
+			return false;
+		}
+		switch (outCurve.family)
+		{
+		case CurveFamily::LINEAR:
+		case CurveFamily::EXPONENTIAL:
+		case CurveFamily::CUBIC:
+			return outCurve.b != 0.0;
+		case CurveFamily::LOGARITHMIC:
+			return outCurve.baseSpeed > 0.0;
+		case CurveFamily::TIERED:
+			return outCurve.tierCount > 0;
+		}
+		return false;
+	}
+
+	// Generations are drawn process-wide so no two tables ever share one.
+	uint64_t NextGeneration()
+	{
+		static std::atomic<uint64_t> next(1);
+		return next.fetch_add(1, std::memory_order_relaxed);
+	}
+
+} // namespace
+
+	ArchetypeTable::ArchetypeTable()
+		: mErrorLine(0)
+		, mGeneration(NextGeneration())
+	{
+	}
+
+	bool ArchetypeTable::Load(const char* path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file)
+		{
+			mErrorLine = 0;
+			return false;
+		}
+
+		std::ostringstream text;
+		text << file.rdbuf();
+		if (file.bad())
+		{
+			mErrorLine = 0;
+			return false;
+		}
+		return Parse(text.str());
+	}
+
+	bool ArchetypeTable::Parse(std::string_view text)
+	{
+		std::vector<std::string> names;
+		std::vector<Archetype> archetypes;
+		std::vector<Curve> curves;
+		std::vector<Tier> tiers;
+
+		// An archetype is complete once it has a capacity, a duty cycle and
+		// at least one curve; checked when the next one starts and at the end.
+		bool hasCapacity = false;
+		bool hasDuty = false;
+		auto isComplete = [&]()
+		{
+			return archetypes.empty() || (hasCapacity && hasDuty && archetypes.back().curveCount > 0);
+		};
+
+		size_t lineNumber = 0;
+		size_t lastArchetypeLine = 0;
+		size_t position = 0;
+		while (position < text.size())
+		{
+			size_t end = text.find('\n', position);
+			if (end == std::string_view::npos)
+			{
+				end = text.size();
+			}
+			std::string_view line = text.substr(position, end - position);
+			position = end + 1;
+			++lineNumber;
+
+			size_t comment = line.find('#');
+			if (comment != std::string_view::npos)
+			{
+				line = line.substr(0, comment);
+			}
+			if (!line.empty() && line.back() == '\r')
+			{
+				line.remove_suffix(1);
+			}
+
+			std::vector<std::string_view> words = SplitWords(line, ' ');
+			if (words.empty())
+			{
+				continue;
+			}
+
+			bool isValid = false;
+			if (words[0] == "archetype")
+			{
+				if (!isComplete())
+				{
+					mErrorLine = lastArchetypeLine;
+					return false;
+				}
+
+				isValid = words.size() == 2;
+				for (const std::string& name : names)
+				{
+					isValid = isValid && name != words[1];
+				}
+				if (isValid)
+				{
+					names.emplace_back(words[1]);
+					archetypes.push_back(Archetype{ 0, 0, 0, 0, static_cast<uint32_t>(curves.size()), 0 });
+					hasCapacity = false;
+					hasDuty = false;
+					lastArchetypeLine = lineNumber;
+				}
+			}
+			else if (archetypes.empty())
+			{
+				isValid = false;
+			}
+			else if (words[0] == "capacity")
+			{
+				isValid = !hasCapacity && words.size() == 2 && ParseUnsigned(words[1], archetypes.back().capacity);
+				hasCapacity = true;
+			}
+			else if (words[0] == "duty")
+			{
+				Archetype& archetype = archetypes.back();
+				isValid = !hasDuty && words.size() == 3
+					&& ParseUnsigned(words[1], archetype.moveTime) && ParseUnsigned(words[2], archetype.idleTime)
+					&& static_cast<unsigned long long>(archetype.moveTime) + archetype.idleTime > 0;
+				hasDuty = true;
+			}
+			else if (words[0] == "speed")
+			{
+				Archetype& archetype = archetypes.back();
+				Curve curve;
+				isValid = ParseCurve(words, curve, tiers) && (archetype.capabilities & ToMask(curve.capability)) == 0;
+				if (isValid)
+				{
+					archetype.capabilities |= ToMask(curve.capability);
+					++archetype.curveCount;
+					curves.push_back(curve);
+				}
+			}
+
+			if (!isValid)
+			{
+				mErrorLine = lineNumber;
+				return false;
+			}
+		}
+
+		if (!isComplete())
+		{
+			mErrorLine = lastArchetypeLine;
+			return false;
+		}
+
+		mNames = std::move(names);
+		mArchetypes = std::move(archetypes);
+		mCurves = std::move(curves);
+		mTiers = std::move(tiers);
+		mErrorLine = 0;
+		mGeneration = NextGeneration();
+		return true;
+	}
+
+	size_t ArchetypeTable::GetErrorLine() const
+	{
+		return mErrorLine;
+	}
+
+	uint32_t ArchetypeTable::Find(std::string_view name) const
+	{
+		for (size_t i = 0; i < mNames.size(); ++i)
+		{
+			if (mNames[i] == name)
+			{
+				return static_cast<uint32_t>(i);
+			}
+		}
+		return NONE;
+	}
+
+	const std::string& ArchetypeTable::GetName(uint32_t archetype) const
+	{
+		return mNames[archetype];
+	}
+
+	size_t ArchetypeTable::GetArchetypeCount() const
+	{
+		return mArchetypes.size();
+	}
+
+	unsigned int ArchetypeTable::EvaluateCurve(uint32_t curve, unsigned int passengersWeight) const
+	{
+		unsigned int speed;
+		EvaluateCurve(curve, &passengersWeight, &speed, 1);
+		return speed;
+	}
+
+	unsigned int ArchetypeTable::EvaluateCapabilitySpeed(uint32_t archetype, Capability capability, unsigned int passengersWeight) const
+	{
+		const Archetype& entry = mArchetypes[archetype];
+		for (uint32_t curve = entry.firstCurve; curve < entry.firstCurve + entry.curveCount; ++curve)
+		{
+			if (mCurves[curve].capability == capability)
+			{
+				return EvaluateCurve(curve, passengersWeight);
+			}
+		}
+		return 0;
+	}
+
+	unsigned int ArchetypeTable::EvaluateMaxSpeed(uint32_t archetype, unsigned int passengersWeight) const
+	{
+		const Archetype& entry = mArchetypes[archetype];
+		unsigned int maxSpeed = 0;
+		for (uint32_t curve = entry.firstCurve; curve < entry.firstCurve + entry.curveCount; ++curve)
+		{
+			unsigned int speed = EvaluateCurve(curve, passengersWeight);
+			maxSpeed = speed > maxSpeed ? speed : maxSpeed;
+		}
+		return maxSpeed;
+	}
+
+	void ArchetypeTable::EvaluateCurve(uint32_t curve, const unsigned int* weights, unsigned int* outSpeeds, size_t count) const
+	{
+		const Curve& entry = mCurves[curve];
+		const double base = entry.baseSpeed;
+		const double a = entry.a;
+		const double b = entry.b;
+		const double floor = entry.floor;
+		switch (entry.family)
+		{
+		case CurveFamily::LINEAR:
+			for (size_t i = 0; i < count; ++i)
+			{
+				outSpeeds[i] = RoundSpeed(base - weights[i] * a / b, floor);
+			}
+			break;
+		case CurveFamily::EXPONENTIAL:
+			for (size_t i = 0; i < count; ++i)
+			{
+				outSpeeds[i] = RoundSpeed(a * exp((base - weights[i]) / b), floor);
+			}
+			break;
+		case CurveFamily::LOGARITHMIC:
+			for (size_t i = 0; i < count; ++i)
+			{
+				outSpeeds[i] = RoundSpeed(a * log((weights[i] + base) / base) + b, floor);
+			}
+			break;
+		case CurveFamily::CUBIC:
+			for (size_t i = 0; i < count; ++i)
+			{
+				double weight = static_cast<double>(weights[i]);
+				outSpeeds[i] = RoundSpeed(base + (weight * a) - pow(weight / b, 3), floor);
+			}
+			break;
+		case CurveFamily::TIERED:
+		{
+			const Tier* first = &mTiers[entry.firstTier];
+			const Tier* last = first + entry.tierCount - 1;
+			for (size_t i = 0; i < count; ++i)
+			{
+				const Tier* tier = first;
+				while (tier != last && weights[i] > tier->maxWeight)
+				{
+					++tier;
+				}
+				outSpeeds[i] = RoundSpeed(base - tier->cut, floor);
+			}
+			break;
+		}
+		}
+	}
+
+} // namespace core
+} // namespace engine
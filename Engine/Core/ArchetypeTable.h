@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../Capabilities/Capability.h"
+
+namespace engine {
+namespace core {
+
+// Vehicle types defined by data rather than code: capacity, duty cycle and,
+// per capability, a speed curve from one of a few parameterized families.
+// Loaded once into flat arrays that ArchetypeVehicles point into, so a fleet
+// of any size shares one copy of every parameter, and a type can be added or
+// retuned by editing the file.
+//
+// The file is line based; `#` starts a comment. Each archetype is a block:
+//
+//     archetype Hovercraft
+//     capacity 8
+//     duty 3 1                   # ticks moving, ticks idle
+//     speed driving linear base=300 slope=2 floor=40
+//     speed sailing exponential base=600 scale=180 falloff=400
+//
+// With w the passengers' weight and B the base speed, the families are
+//
+//     linear        max(B - w * slope / divisor, floor)
+//     exponential   max(scale * exp((B - w) / falloff), floor)
+//     logarithmic   max(scale * log((w + B) / B) + offset, floor)
+//     cubic         max(B + w * slope - (w / divisor)^3, floor)
+//     tiered        max(B - cut, floor), cut from the first tier with
+//                   w <= limit: tiers=80:0,160:22,*:180. `*` is no limit;
+//                   weights past the last limit take the last tier.
+//
+// rounded half up. Parameters left out default to slope 0, divisor 1, scale 1,
+// falloff 1, offset 0 and floor 0. A vehicle's max speed is the fastest of
+// its curves.
+class ArchetypeTable
+{
+public:
+	enum class CurveFamily : uint8_t
+	{
+		LINEAR,
+		EXPONENTIAL,
+		LOGARITHMIC,
+		CUBIC,
+		TIERED,
+	};
+
+	static constexpr size_t CURVE_FAMILY_COUNT = 5;
+	static constexpr uint32_t NONE = 0xFFFFFFFFu;
+
+	struct Curve
+	{
+		capabilities::Capability capability;
+		CurveFamily family;
+		double baseSpeed;
+		double a;                   // slope or scale
+		double b;                   // divisor, falloff or offset
+		double floor;
+		uint32_t firstTier;         // TIERED only
+		uint32_t tierCount;
+	};
+
+	struct Tier
+	{
+		unsigned int maxWeight;     // UINT_MAX for `*`
+		unsigned int cut;
+	};
+
+	struct Archetype
+	{
+		unsigned int capacity;
+		unsigned int moveTime;
+		unsigned int idleTime;
+		capabilities::CapabilityMask capabilities;
+		uint32_t firstCurve;
+		uint32_t curveCount;
+	};
+
+	ArchetypeTable();
+
+	ArchetypeTable(const ArchetypeTable&) = delete;
+	ArchetypeTable& operator=(const ArchetypeTable&) = delete;
+
+	// Replaces the table's contents. All or nothing: on failure the table is
+	// left as it was and GetErrorLine tells which line was rejected (0 when
+	// the file could not be read). Must not be called while vehicles use it.
+	bool Load(const char* path);
+	bool Parse(std::string_view text);
+	size_t GetErrorLine() const;
+
+	// NONE for names the table does not define.
+	uint32_t Find(std::string_view name) const;
+	const std::string& GetName(uint32_t archetype) const;
+	size_t GetArchetypeCount() const;
+	// Changes whenever the contents do, and differs between tables, so a
+	// cache built from a table can tell it is stale even if a new table now
+	// sits at the same address.
+	uint64_t GetGeneration() const { return mGeneration; }
+	const Archetype& GetArchetype(uint32_t archetype) const { return mArchetypes[archetype]; }
+	const Curve& GetCurve(uint32_t curve) const { return mCurves[curve]; }
+
+	// Speed of one curve, of the archetype's `capability` curve (0 if it has
+	// none), or of the archetype's fastest curve, with `passengersWeight` aboard.
+	unsigned int EvaluateCurve(uint32_t curve, unsigned int passengersWeight) const;
+	unsigned int EvaluateCapabilitySpeed(uint32_t archetype, capabilities::Capability capability, unsigned int passengersWeight) const;
+	unsigned int EvaluateMaxSpeed(uint32_t archetype, unsigned int passengersWeight) const;
+	// Batch kernel: one curve at weights[i] into outSpeeds[i]. The family and
+	// its coefficients are resolved once per call, leaving the loop a single
+	// formula over the weights; the scalar overload goes through here too, so
+	// both agree exactly.
+	void EvaluateCurve(uint32_t curve, const unsigned int* weights, unsigned int* outSpeeds, size_t count) const;
+
+private:
+	std::vector<std::string> mNames;
+	std::vector<Archetype> mArchetypes;
+	std::vector<Curve> mCurves;
+	std::vector<Tier> mTiers;
+	size_t mErrorLine;
+	uint64_t mGeneration;
+};
+
+} // namespace core
+} // namespace engine
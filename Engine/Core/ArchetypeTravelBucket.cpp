@@ -0,0 +1,234 @@
+#include <vector>
+
+#include "ArchetypeTravelBucket.h"
+#include "../Vehicles/ArchetypeVehicle.h"
+
+namespace engine {
+namespace core {
+
+using vehicles::ArchetypeVehicle;
+
+namespace {
+
+	// Runtime counterpart of DutyCycleTable, one per archetype of a table:
+	// where `hours` ticks take a vehicle from each position of its cycle.
+	// Cycles longer than MAX_CYCLE are not tabulated and advance directly.
+	class CycleTables
+	{
+	public:
+		static constexpr unsigned int MAX_CYCLE = 64;
+		static constexpr uint32_t NONE = 0xFFFFFFFFu;
+
+		CycleTables()
+			: mGeneration(0)
+			, mHours(0)
+		{
+		}
+
+		// Keyed on the table's generation rather than its address, so a
+		// reparsed table, or a new one at a freed table's address, rebuilds.
+		void Build(const ArchetypeTable& table, unsigned int hours)
+		{
+			if (mGeneration == table.GetGeneration() && mHours == hours)
+			{
+				return;
+			}
+
+			mGeneration = table.GetGeneration();
+			mHours = hours;
+			mOffsets.assign(table.GetArchetypeCount(), NONE);
+			mMovingTicks.clear();
+			mEndPositions.clear();
+			for (uint32_t i = 0; i < table.GetArchetypeCount(); ++i)
+			{
+				const ArchetypeTable::Archetype& archetype = table.GetArchetype(i);
+				unsigned long long cycle = static_cast<unsigned long long>(archetype.moveTime) + archetype.idleTime;
+				if (cycle > MAX_CYCLE)
+				{
+					continue;
+				}
+
+				mOffsets[i] = static_cast<uint32_t>(mMovingTicks.size());
+				for (unsigned int position = 0; position < cycle; ++position)
+				{
+					unsigned int moved = position < archetype.moveTime ? position : archetype.moveTime;
+					DutyCycleState end = AdvanceDutyCycle(DutyCycleState{ 0, moved, position - moved }, hours, archetype.moveTime, archetype.idleTime, 1);
+					mMovingTicks.push_back(end.odo);
+					mEndPositions.push_back(end.moveTime + end.idleTime);
+				}
+			}
+		}
+
+		DutyCycleState Advance(uint32_t archetypeIndex, const ArchetypeTable::Archetype& archetype, DutyCycleState state, unsigned int speed) const
+		{
+			uint32_t offset = mOffsets[archetypeIndex];
+			if (offset == NONE)
+			{
+				return AdvanceDutyCycle(state, mHours, archetype.moveTime, archetype.idleTime, speed);
+			}
+
+			// A vehicle's cycle never changes, so its position is already in
+			// range unless its state was set from outside.
+			unsigned int cycle = archetype.moveTime + archetype.idleTime;
+			unsigned int start = state.moveTime < archetype.moveTime ? state.moveTime : archetype.moveTime + state.idleTime;
+			if (start >= cycle)
+			{
+				start %= cycle;
+			}
+
+			unsigned int position = mEndPositions[offset + start];
+			unsigned int moved = position < archetype.moveTime ? position : archetype.moveTime;
+			return DutyCycleState{ state.odo + mMovingTicks[offset + start] * speed, moved, position - moved };
+		}
+
+	private:
+		uint64_t mGeneration;      // 0 before the first Build
+		unsigned int mHours;
+		std::vector<uint32_t> mOffsets;
+		std::vector<unsigned int> mMovingTicks;
+		std::vector<unsigned int> mEndPositions;
+	};
+
+	// Per travel thread, so ranges reuse their buffers instead of allocating.
+	struct RangeScratch
+	{
+		// Stale vehicles of one archetype: bucket positions and weights.
+		struct Group
+		{
+			std::vector<uint32_t> positions;
+			std::vector<unsigned int> weights;
+		};
+
+		CycleTables cycles;
+		std::vector<uint32_t> stale;
+		std::vector<uint32_t> otherTables;
+		std::vector<Group> groups;
+		std::vector<unsigned int> maxSpeeds;
+		std::vector<unsigned int> speeds;
+	};
+
+	RangeScratch& GetRangeScratch()
+	{
+		thread_local RangeScratch scratch;
+		return scratch;
+	}
+
+} // namespace
+
+	ArchetypeTravelBucket::ArchetypeTravelBucket()
+		: TravelBucket(EngineMetrics::RegisterType(typeid(ArchetypeVehicle)))
+	{
+	}
+
+	void ArchetypeTravelBucket::TravelRange(const TravelContext& context, TravelStateStore& travelState, size_t begin, size_t end) const
+	{
+		CycleTables& cycles = GetRangeScratch().cycles;
+		uint64_t moving = 0;
+		for (size_t i = begin; i < end; ++i)
+		{
+			// Refresh a block ahead, so its vehicles are still in cache when
+			// the loop reaches them.
+			if ((i - begin) % REFRESH_BLOCK == 0)
+			{
+				RefreshMaxSpeeds(travelState, i, i + REFRESH_BLOCK < end ? i + REFRESH_BLOCK : end);
+			}
+
+			const ArchetypeVehicle& vehicle = *static_cast<const ArchetypeVehicle*>(mVehicles[i]);
+			const ArchetypeTable& table = vehicle.GetTable();
+			uint32_t archetype = vehicle.GetArchetype();
+			uint32_t slot = mDenseIndices[i];
+			cycles.Build(table, context.hours);
+
+			DutyCycleState state{ travelState.GetOdo(slot), travelState.GetMoveTime(slot), travelState.GetIdleTime(slot) };
+			DutyCycleState next = cycles.Advance(archetype, table.GetArchetype(archetype), state, travelState.GetMaxSpeed(slot));
+			travelState.SetOdo(slot, next.odo);
+			travelState.SetMoveTime(slot, next.moveTime);
+			travelState.SetIdleTime(slot, next.idleTime);
+			if constexpr (EngineMetrics::IS_ENABLED)
+			{
+				moving += next.odo != state.odo;
+			}
+		}
+		RecordTravelled(end - begin, moving);
+	}
+
+	bool ArchetypeTravelBucket::GetDutyCycle(size_t position, unsigned int& outMoveTime, unsigned int& outIdleTime) const
+	{
+		const ArchetypeVehicle& vehicle = *static_cast<const ArchetypeVehicle*>(mVehicles[position]);
+		const ArchetypeTable::Archetype& archetype = vehicle.GetTable().GetArchetype(vehicle.GetArchetype());
+		outMoveTime = archetype.moveTime;
+		outIdleTime = archetype.idleTime;
+		return true;
+	}
+
+	void ArchetypeTravelBucket::RefreshMaxSpeeds(TravelStateStore& travelState, size_t begin, size_t end) const
+	{
+		RangeScratch& scratch = GetRangeScratch();
+		scratch.stale.clear();
+		for (size_t i = begin; i < end; ++i)
+		{
+			if (!travelState.IsMaxSpeedValid(mDenseIndices[i]))
+			{
+				scratch.stale.push_back(static_cast<uint32_t>(i));
+			}
+		}
+
+		// Vehicles of one archetype share every curve, so each curve runs as
+		// one kernel call over all of them. A pass takes one table's vehicles
+		// and leaves the rest for the next; in practice there is one table.
+		while (!scratch.stale.empty())
+		{
+			const ArchetypeTable& table = static_cast<const ArchetypeVehicle*>(mVehicles[scratch.stale.front()])->GetTable();
+			if (scratch.groups.size() < table.GetArchetypeCount())
+			{
+				scratch.groups.resize(table.GetArchetypeCount());
+			}
+
+			scratch.otherTables.clear();
+			for (uint32_t position : scratch.stale)
+			{
+				const ArchetypeVehicle& vehicle = *static_cast<const ArchetypeVehicle*>(mVehicles[position]);
+				if (&vehicle.GetTable() != &table)
+				{
+					scratch.otherTables.push_back(position);
+					continue;
+				}
+
+				RangeScratch::Group& group = scratch.groups[vehicle.GetArchetype()];
+				group.positions.push_back(position);
+				group.weights.push_back(vehicle.GetPassengersWeight());
+			}
+
+			for (uint32_t archetypeIndex = 0; archetypeIndex < table.GetArchetypeCount(); ++archetypeIndex)
+			{
+				RangeScratch::Group& group = scratch.groups[archetypeIndex];
+				size_t count = group.positions.size();
+				if (count == 0)
+				{
+					continue;
+				}
+
+				const ArchetypeTable::Archetype& archetype = table.GetArchetype(archetypeIndex);
+				scratch.maxSpeeds.assign(count, 0);
+				scratch.speeds.resize(count);
+				for (uint32_t curve = archetype.firstCurve; curve < archetype.firstCurve + archetype.curveCount; ++curve)
+				{
+					table.EvaluateCurve(curve, group.weights.data(), scratch.speeds.data(), count);
+					for (size_t k = 0; k < count; ++k)
+					{
+						scratch.maxSpeeds[k] = scratch.speeds[k] > scratch.maxSpeeds[k] ? scratch.speeds[k] : scratch.maxSpeeds[k];
+					}
+				}
+				for (size_t k = 0; k < count; ++k)
+				{
+					travelState.SetMaxSpeed(mDenseIndices[group.positions[k]], scratch.maxSpeeds[k]);
+				}
+				group.positions.clear();
+				group.weights.clear();
+			}
+			scratch.stale.swap(scratch.otherTables);
+		}
+	}
+
+} // namespace core
+} // namespace engine
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+
+#include "TravelBucket.h"
+
+namespace engine {
+namespace core {
+
+// Bucket for vehicles::ArchetypeVehicle. The formulas live in tables rather
+// than code, so the bucket works from the parameters: it walks a range in
+// blocks, recomputing every stale max speed in a block together (one batch
+// ArchetypeTable::EvaluateCurve call per curve of each archetype present) and
+// then advancing each vehicle by its archetype's duty cycle straight on the
+// travel state columns. The duty cycle also lets LAZY engines settle these
+// vehicles instead of travelling them.
+class ArchetypeTravelBucket final : public TravelBucket
+{
+public:
+	ArchetypeTravelBucket();
+
+	virtual void TravelRange(const TravelContext& context, TravelStateStore& travelState, size_t begin, size_t end) const override;
+	virtual bool HasDutyCycle() const override { return true; }
+	virtual bool GetDutyCycle(size_t position, unsigned int& outMoveTime, unsigned int& outIdleTime) const override;
+
+private:
+	static constexpr size_t REFRESH_BLOCK = 1024;
+
+	void RefreshMaxSpeeds(TravelStateStore& travelState, size_t begin, size_t end) const;
+};
+
+} // namespace core
+} // namespace engine
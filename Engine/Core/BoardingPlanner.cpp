@@ -0,0 +1,297 @@
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+#include "BoardingPlanner.h"
+#include "WorkStealingPool.h"
+#include "../Vehicles/Vehicle.h"
+
+namespace engine {
+namespace core {
+
+namespace {
+
+	// Improvements smaller than this are rounding noise.
+	const double MIN_GAIN = 1e-9;
+	const size_t PLAN_CHUNK_SIZE = 256;
+
+	struct HeapEntry
+	{
+		double gain;
+		uint32_t candidate;
+	};
+
+	// Max-heap on gain; the lower candidate wins ties so plans are repeatable.
+	bool IsLowerPriority(const HeapEntry& lhs, const HeapEntry& rhs)
+	{
+		return lhs.gain < rhs.gain || (lhs.gain == rhs.gain && lhs.candidate > rhs.candidate);
+	}
+
+	// Distinct weights among `passengers`; weightless ones never need moving.
+	void CollectWeights(const std::vector<uint32_t>& passengers, const std::vector<unsigned int>& passengerWeights, std::vector<unsigned int>& outWeights)
+	{
+		outWeights.clear();
+		for (uint32_t passenger : passengers)
+		{
+			if (passengerWeights[passenger] != 0)
+			{
+				outWeights.push_back(passengerWeights[passenger]);
+			}
+		}
+		std::sort(outWeights.begin(), outWeights.end());
+		outWeights.erase(std::unique(outWeights.begin(), outWeights.end()), outWeights.end());
+	}
+
+} // namespace
+
+	BoardingPlanner::BoardingPlanner(std::vector<Candidate> candidates, WorkStealingPool* pool)
+		: mCandidates(std::move(candidates))
+		, mPool(pool)
+	{
+	}
+
+	void BoardingPlanner::Plan(const std::vector<unsigned int>& passengerWeights)
+	{
+		mPassengerWeights = passengerWeights;
+		mAssignment.assign(passengerWeights.size(), NONE);
+		mPlanned.assign(mCandidates.size(), std::vector<uint32_t>());
+		mScores.resize(mCandidates.size());
+		RunChunked(mCandidates.size(), PLAN_CHUNK_SIZE, [this](size_t begin, size_t end)
+		{
+			for (size_t c = begin; c < end; ++c)
+			{
+				mScores[c] = Score(static_cast<uint32_t>(c), mCandidates[c].weight);
+			}
+		});
+
+		size_t freeSeats = 0;
+		for (const Candidate& candidate : mCandidates)
+		{
+			freeSeats += candidate.freeSeats;
+		}
+
+		// The lightest passengers get the seats; they board heaviest first.
+		std::vector<uint32_t> passengers(passengerWeights.size());
+		std::iota(passengers.begin(), passengers.end(), 0u);
+		std::stable_sort(passengers.begin(), passengers.end(), [&passengerWeights](uint32_t lhs, uint32_t rhs)
+		{
+			return passengerWeights[lhs] < passengerWeights[rhs];
+		});
+		passengers.resize(std::min(passengers.size(), freeSeats));
+		std::reverse(passengers.begin(), passengers.end());
+
+		BoardGreedily(passengers);
+		Improve();
+	}
+
+	const std::vector<uint32_t>& BoardingPlanner::GetAssignment() const
+	{
+		return mAssignment;
+	}
+
+	double BoardingPlanner::GetDistancePerTick() const
+	{
+		return std::accumulate(mScores.begin(), mScores.end(), 0.0);
+	}
+
+	double BoardingPlanner::Score(uint32_t candidate, unsigned int weight) const
+	{
+		const Candidate& c = mCandidates[candidate];
+		return c.moveShare * c.vehicle->EstimateMaxSpeed(weight);
+	}
+
+	void BoardingPlanner::RunChunked(size_t count, size_t chunkSize, const std::function<void(size_t begin, size_t end)>& body)
+	{
+		if (mPool == nullptr)
+		{
+			body(0, count);
+			return;
+		}
+		mPool->ParallelFor(count, chunkSize, body);
+	}
+
+	void BoardingPlanner::BoardGreedily(const std::vector<uint32_t>& passengers)
+	{
+		std::vector<HeapEntry> gains(mCandidates.size());
+		std::vector<HeapEntry> heap;
+		heap.reserve(mCandidates.size());
+
+		size_t bandCount = std::min(WEIGHT_BANDS, passengers.size());
+		for (size_t band = 0; band < bandCount; ++band)
+		{
+			size_t first = passengers.size() * band / bandCount;
+			size_t last = passengers.size() * (band + 1) / bandCount;
+			unsigned long long bandWeight = 0;
+			for (size_t i = first; i < last; ++i)
+			{
+				bandWeight += mPassengerWeights[passengers[i]];
+			}
+			unsigned int typical = static_cast<unsigned int>((bandWeight + (last - first) / 2) / (last - first));
+
+			RunChunked(mCandidates.size(), PLAN_CHUNK_SIZE, [this, &gains, typical](size_t begin, size_t end)
+			{
+				for (size_t c = begin; c < end; ++c)
+				{
+					uint32_t candidate = static_cast<uint32_t>(c);
+					gains[c].candidate = candidate;
+					gains[c].gain = mCandidates[c].freeSeats > 0 ? Score(candidate, mCandidates[c].weight + typical) - mScores[c] : 0.0;
+				}
+			});
+
+			heap.clear();
+			for (const HeapEntry& entry : gains)
+			{
+				if (mCandidates[entry.candidate].freeSeats > 0)
+				{
+					heap.push_back(entry);
+				}
+			}
+			std::make_heap(heap.begin(), heap.end(), IsLowerPriority);
+
+			for (size_t i = first; i < last && !heap.empty(); ++i)
+			{
+				std::pop_heap(heap.begin(), heap.end(), IsLowerPriority);
+				uint32_t candidate = heap.back().candidate;
+				heap.pop_back();
+
+				Assign(passengers[i], candidate);
+				const Candidate& c = mCandidates[candidate];
+				if (c.freeSeats > 0)
+				{
+					heap.push_back(HeapEntry{ Score(candidate, c.weight + typical) - mScores[candidate], candidate });
+					std::push_heap(heap.begin(), heap.end(), IsLowerPriority);
+				}
+			}
+		}
+	}
+
+	void BoardingPlanner::Improve()
+	{
+		// Only vehicles with a planned passenger or a free seat can change.
+		std::vector<uint32_t> active;
+		for (uint32_t c = 0; c < mCandidates.size(); ++c)
+		{
+			if (!mPlanned[c].empty() || mCandidates[c].freeSeats > 0)
+			{
+				active.push_back(c);
+			}
+		}
+
+		std::mt19937 random(0x5eedu);
+		for (unsigned int round = 0; round < IMPROVE_ROUNDS && active.size() >= 2; ++round)
+		{
+			std::shuffle(active.begin(), active.end(), random);
+			mPairs.assign(active.begin(), active.begin() + (active.size() & ~static_cast<size_t>(1)));
+			RunChunked(mPairs.size() / 2, PLAN_CHUNK_SIZE / 4, [this](size_t begin, size_t end)
+			{
+				for (size_t pair = begin; pair < end; ++pair)
+				{
+					ImprovePair(static_cast<uint32_t>(pair));
+				}
+			});
+		}
+	}
+
+	void BoardingPlanner::ImprovePair(uint32_t pairIndex)
+	{
+		uint32_t a = mPairs[2 * pairIndex];
+		uint32_t b = mPairs[2 * pairIndex + 1];
+		std::vector<unsigned int> weightsA;
+		std::vector<unsigned int> weightsB;
+
+		for (unsigned int step = 0; step < MAX_PAIR_MOVES; ++step)
+		{
+			CollectWeights(mPlanned[a], mPassengerWeights, weightsA);
+			CollectWeights(mPlanned[b], mPassengerWeights, weightsB);
+			unsigned int weightA = mCandidates[a].weight;
+			unsigned int weightB = mCandidates[b].weight;
+			double before = mScores[a] + mScores[b];
+
+			// Best single change: a weight from a to b, b to a, or one of each
+			// swapped. 0 stands for "nothing" on that side.
+			double bestGain = MIN_GAIN;
+			unsigned int bestFromA = 0;
+			unsigned int bestFromB = 0;
+			bool isFound = false;
+			auto consider = [&](unsigned int fromA, unsigned int fromB)
+			{
+				double gain = Score(a, weightA - fromA + fromB) + Score(b, weightB - fromB + fromA) - before;
+				if (gain > bestGain)
+				{
+					bestGain = gain;
+					bestFromA = fromA;
+					bestFromB = fromB;
+					isFound = true;
+				}
+			};
+
+			for (unsigned int fromA : weightsA)
+			{
+				if (mCandidates[b].freeSeats > 0)
+				{
+					consider(fromA, 0);
+				}
+				for (unsigned int fromB : weightsB)
+				{
+					if (fromA != fromB)
+					{
+						consider(fromA, fromB);
+					}
+				}
+			}
+			if (mCandidates[a].freeSeats > 0)
+			{
+				for (unsigned int fromB : weightsB)
+				{
+					consider(0, fromB);
+				}
+			}
+
+			if (!isFound)
+			{
+				return;
+			}
+
+			uint32_t passengerA = bestFromA != 0 ? Unassign(bestFromA, a) : NONE;
+			uint32_t passengerB = bestFromB != 0 ? Unassign(bestFromB, b) : NONE;
+			if (passengerA != NONE)
+			{
+				Assign(passengerA, b);
+			}
+			if (passengerB != NONE)
+			{
+				Assign(passengerB, a);
+			}
+		}
+	}
+
+	void BoardingPlanner::Assign(uint32_t passenger, uint32_t candidate)
+	{
+		Candidate& c = mCandidates[candidate];
+		mAssignment[passenger] = candidate;
+		mPlanned[candidate].push_back(passenger);
+		c.weight += mPassengerWeights[passenger];
+		--c.freeSeats;
+		mScores[candidate] = Score(candidate, c.weight);
+	}
+
+	uint32_t BoardingPlanner::Unassign(unsigned int weight, uint32_t candidate)
+	{
+		std::vector<uint32_t>& planned = mPlanned[candidate];
+		std::vector<uint32_t>::iterator found = std::find_if(planned.begin(), planned.end(), [this, weight](uint32_t passenger)
+		{
+			return mPassengerWeights[passenger] == weight;
+		});
+		uint32_t passenger = *found;
+		planned.erase(found);
+
+		Candidate& c = mCandidates[candidate];
+		mAssignment[passenger] = NONE;
+		c.weight -= weight;
+		++c.freeSeats;
+		mScores[candidate] = Score(candidate, c.weight);
+		return passenger;
+	}
+
+} // namespace core
+} // namespace engine
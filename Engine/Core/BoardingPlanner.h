@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "VehicleHandle.h"
+
+namespace engine {
+namespace vehicles {
+class Vehicle;
+} // namespace vehicles
+
+namespace core {
+
+class WorkStealingPool;
+
+// Seats for a pool of passengers; see DeusExMachina::PlanBoarding.
+struct BoardingPlan
+{
+	std::vector<VehicleHandle> vehicles;    // per pool passenger; null = no seat
+	size_t boardedCount;
+	double distancePerTick;                 // whole fleet, averaged over duty cycles
+};
+
+// Assigns a pool of passengers to free seats so as to maximize the fleet's
+// distance per tick, judged through Vehicle::EstimateMaxSpeed. Two phases:
+//
+// 1. Greedy: passengers board heaviest first, each taking the seat whose
+//    vehicle loses the least (or gains the most) distance. Passengers are
+//    cut into a few weight bands, and each band keeps the vehicles in a
+//    heap keyed by their marginal gain at the band's mean weight, so a band
+//    costs one pass over the fleet plus a heap operation per passenger.
+// 2. Improvement: rounds of random disjoint vehicle pairs, each pair moving
+//    or swapping planned passengers while that gains distance. Pairs share
+//    nothing, so a round runs in parallel and the result does not depend
+//    on the thread count.
+//
+// Only passengers from the pool move; those already aboard stay put.
+class BoardingPlanner
+{
+public:
+	struct Candidate
+	{
+		const vehicles::Vehicle* vehicle;
+		double moveShare;           // fraction of ticks spent moving
+		unsigned int weight;        // passengers already aboard
+		unsigned int freeSeats;
+	};
+
+	static constexpr uint32_t NONE = 0xFFFFFFFFu;
+	static constexpr size_t WEIGHT_BANDS = 32;
+	static constexpr unsigned int IMPROVE_ROUNDS = 8;
+	static constexpr unsigned int MAX_PAIR_MOVES = 16;
+
+	// `pool` may be null for a serial plan.
+	BoardingPlanner(std::vector<Candidate> candidates, WorkStealingPool* pool);
+
+	BoardingPlanner(const BoardingPlanner&) = delete;
+	BoardingPlanner& operator=(const BoardingPlanner&) = delete;
+
+	// When the pool outnumbers the free seats, the heaviest passengers are
+	// the ones left without one.
+	void Plan(const std::vector<unsigned int>& passengerWeights);
+	// Candidate index per passenger, or NONE.
+	const std::vector<uint32_t>& GetAssignment() const;
+	// Sum over all candidates of moveShare * EstimateMaxSpeed once boarded.
+	double GetDistancePerTick() const;
+
+private:
+	double Score(uint32_t candidate, unsigned int weight) const;
+	// ParallelFor on the pool when there is one, a plain call otherwise.
+	void RunChunked(size_t count, size_t chunkSize, const std::function<void(size_t begin, size_t end)>& body);
+	void BoardGreedily(const std::vector<uint32_t>& passengers);
+	void Improve();
+	void ImprovePair(uint32_t pairIndex);
+	void Assign(uint32_t passenger, uint32_t candidate);
+	// Takes the first planned passenger of `weight` off `candidate`.
+	uint32_t Unassign(unsigned int weight, uint32_t candidate);
+
+	std::vector<Candidate> mCandidates;
+	WorkStealingPool* mPool;
+	std::vector<unsigned int> mPassengerWeights;
+	std::vector<uint32_t> mAssignment;
+	std::vector<double> mScores;                        // per candidate, at its current weight
+	std::vector<std::vector<uint32_t>> mPlanned;        // pool passengers per candidate
+	std::vector<uint32_t> mPairs;                       // scratch for Improve: a0, b0, a1, b1, ...
+};
+
+} // namespace core
+} // namespace engine
@@ -0,0 +1,58 @@
+#include "CapabilityStore.h"
+
+namespace engine {
+namespace core {
+
+using capabilities::CAPABILITY_COUNT;
+using capabilities::CapabilityMask;
+
+	void CapabilityStore::Push(CapabilityMask mask)
+	{
+		uint32_t slot = static_cast<uint32_t>(mMasks.size());
+		std::array<uint32_t, CAPABILITY_COUNT> positions;
+		for (unsigned int c = 0; c < CAPABILITY_COUNT; ++c)
+		{
+			positions[c] = static_cast<uint32_t>(mComponents[c].size());
+			if ((mask & (1u << c)) != 0)
+			{
+				mComponents[c].push_back(Component{ 0, 0, slot });
+			}
+		}
+		mMasks.push_back(mask);
+		mPositions.push_back(positions);
+	}
+
+	void CapabilityStore::SwapRemove(unsigned int slot)
+	{
+		uint32_t last = static_cast<uint32_t>(mMasks.size() - 1);
+		for (unsigned int c = 0; c < CAPABILITY_COUNT; ++c)
+		{
+			std::vector<Component>& components = mComponents[c];
+			if ((mMasks[slot] & (1u << c)) != 0)
+			{
+				uint32_t position = mPositions[slot][c];
+				components[position] = components.back();
+				mPositions[components[position].slot][c] = position;
+				components.pop_back();
+			}
+			// The last slot is renumbered to `slot`.
+			if (slot != last && (mMasks[last] & (1u << c)) != 0)
+			{
+				components[mPositions[last][c]].slot = slot;
+			}
+		}
+
+		mMasks[slot] = mMasks[last];
+		mPositions[slot] = mPositions[last];
+		mMasks.pop_back();
+		mPositions.pop_back();
+	}
+
+	void CapabilityStore::Reserve(size_t count)
+	{
+		mMasks.reserve(count);
+		mPositions.reserve(count);
+	}
+
+} // namespace core
+} // namespace engine
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../Capabilities/Capability.h"
+
+namespace engine {
+namespace core {
+
+// Dense per-capability component arrays for the vehicles owned by
+// DeusExMachina, indexed by travel slot like TravelStateStore. Each
+// capability keeps one packed array holding only the vehicles that have it,
+// so a filtered query walks exactly the matching vehicles, contiguously;
+// a per-slot mask answers "has all of these" without touching the vehicle.
+class CapabilityStore
+{
+public:
+	struct Component
+	{
+		unsigned int speed;     // effective speed for this capability
+		unsigned int weight;    // passengers aboard
+		uint32_t slot;
+	};
+
+	CapabilityStore() = default;
+	~CapabilityStore() = default;
+
+	CapabilityStore(const CapabilityStore&) = delete;
+	CapabilityStore& operator=(const CapabilityStore&) = delete;
+
+	// Appends the next slot with a zeroed component per set bit.
+	void Push(capabilities::CapabilityMask mask);
+	// Mirrors TravelStateStore::SwapRemove.
+	void SwapRemove(unsigned int slot);
+	void Reserve(size_t count);
+
+	capabilities::CapabilityMask GetMask(unsigned int slot) const { return mMasks[slot]; }
+	// `slot` must have the capability.
+	void Set(unsigned int slot, capabilities::Capability capability, unsigned int speed, unsigned int weight)
+	{
+		Component& component = mComponents[Index(capability)][mPositions[slot][Index(capability)]];
+		component.speed = speed;
+		component.weight = weight;
+	}
+
+	size_t GetCount(capabilities::Capability capability) const { return mComponents[Index(capability)].size(); }
+	const Component* GetComponents(capabilities::Capability capability) const { return mComponents[Index(capability)].data(); }
+
+private:
+	static unsigned int Index(capabilities::Capability capability) { return static_cast<unsigned int>(capability); }
+
+	std::vector<Component> mComponents[capabilities::CAPABILITY_COUNT];
+	std::vector<capabilities::CapabilityMask> mMasks;
+	// Where each slot sits in each array it belongs to.
+	std::vector<std::array<uint32_t, capabilities::CAPABILITY_COUNT>> mPositions;
+};
+
+} // namespace core
+} // namespace engine
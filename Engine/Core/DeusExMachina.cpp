@@ -1,82 +1,665 @@
+#include <cmath>
+
 #include "DeusExMachina.h"
+#include "EngineTrace.h"
 
 namespace engine {
 namespace core {
 
 using vehicles::Vehicle;
 
-	std::unique_ptr<DeusExMachina, DeusExMachina::InstanceDeleter> DeusExMachina::mInstance = nullptr;
+	std::unique_ptr<DeusExMachina> DeusExMachina::mInstance = nullptr;
+	std::mutex DeusExMachina::mInstanceMutex;
+
+	DeusExMachina::DeusExMachina()
+		: mTravelChunkSize(DEFAULT_TRAVEL_CHUNK_SIZE)
+		, mTravelTick(0)
+	{
+		mBuckets.push_back(std::make_unique<VirtualTravelBucket>());
+	}
+
+	DeusExMachina::~DeusExMachina() = default;
 
 	DeusExMachina* DeusExMachina::GetInstance()
 	{
+		std::lock_guard<std::mutex> lock(mInstanceMutex);
 		if (mInstance == nullptr)
 		{
-			mInstance.reset(new DeusExMachina());
+			mInstance = std::make_unique<DeusExMachina>();
 		}
 		return mInstance.get();
 	}
 
 	void DeusExMachina::ResetInstance()
 	{
-		mInstance.reset();
+		// Destroyed outside the lock; the old engine must not be in use anyway.
+		std::unique_ptr<DeusExMachina> released;
+		{
+			std::lock_guard<std::mutex> lock(mInstanceMutex);
+			released = std::move(mInstance);
+		}
 	}
 
-	void DeusExMachina::Travel(const TravelContext& context) const
+	void DeusExMachina::Travel(const TravelContext& context)
 	{
-		for (const std::unique_ptr<vehicles::Vehicle>& vehicle : mVehicles)
+		EngineMetrics::TickTimer tickTimer;
+		EngineTrace::Scope trace("DeusExMachina::Travel", "travel");
+		trace.SetArg("vehicles", mVehicles.GetSize());
+
+		ApplyCommands();
+
+		if (mJournal != nullptr)
+		{
+			mJournal->RecordTravel(context);
+			mJournal->SetSuspended(true);
+		}
+
+		if (mTravelState.IsLazy())
+		{
+			TravelLazy(context);
+		}
+		else
+		{
+			mTravelState.BeginOdoBatch();
+			TravelBucketed(context, false);
+			mTravelState.EndOdoBatch();
+		}
+
+		if (mJournal != nullptr)
 		{
-			vehicle->TravelByMachina(context);
+			mJournal->SetSuspended(false);
 		}
+		++mTravelTick;
+		mGraveyard.Flush();
 	}
 
-	bool DeusExMachina::AddVehicle(std::unique_ptr<Vehicle> vehicle)
+	std::future<void> DeusExMachina::TravelAsync(const TravelContext& context)
 	{
-		if (mVehicles.size() >= MAX_VEHICLES_COUNT)
+		return mTravelExecutor.Submit([this, context]()
+		{
+			Travel(context);
+			PublishTravelView();
+		});
+	}
+
+	TravelViewLease DeusExMachina::GetTravelView() const
+	{
+		return mTravelViews.Acquire();
+	}
+
+	void DeusExMachina::PublishTravelView()
+	{
+		EngineTrace::Scope trace("DeusExMachina::PublishTravelView", "travel");
+		SettleTravelState();
+		mTravelViews.BeginWrite().Capture(mTravelTick, mVehicles, mTravelState);
+		mTravelViews.Publish();
+	}
+
+	void DeusExMachina::TravelBucketed(const TravelContext& context, bool isSkippingDutyCycles)
+	{
+		for (const std::unique_ptr<TravelBucket>& bucket : mBuckets)
+		{
+			if (isSkippingDutyCycles && bucket->HasDutyCycle())
+			{
+				continue;
+			}
+
+			size_t count = bucket->GetSize();
+			if (mTravelPool == nullptr || count <= mTravelChunkSize)
+			{
+				EngineTrace::Scope trace("TravelBucket::TravelRange", "travel");
+				trace.SetArg("vehicles", count);
+				bucket->TravelRange(context, mTravelState, 0, count);
+				continue;
+			}
+
+			const TravelBucket* travelBucket = bucket.get();
+			TravelStateStore& travelState = mTravelState;
+			mTravelPool->ParallelFor(count, mTravelChunkSize, [travelBucket, &context, &travelState](size_t begin, size_t end)
+			{
+				EngineTrace::Scope trace("TravelBucket::TravelRange", "travel");
+				trace.SetArg("vehicles", end - begin);
+				travelBucket->TravelRange(context, travelState, begin, end);
+			});
+		}
+	}
+
+	void DeusExMachina::TravelLazy(const TravelContext& context)
+	{
+		EngineTrace::Scope trace("DeusExMachina::TravelLazy", "travel");
+
+		// Slots that are new or whose speed changed were settled at the
+		// current clock; pick up their cycle before it moves on.
+		mTravelState.TakeStaleSlots(mStaleSlots);
+		trace.SetArg("anchored", mStaleSlots.size());
+		for (uint32_t slot : mStaleSlots)
+		{
+			const BucketRef& ref = mBucketRefs[slot];
+			unsigned int moveTime;
+			unsigned int idleTime;
+			if (mBuckets[ref.bucket]->GetDutyCycle(ref.position, moveTime, idleTime))
+			{
+				mTravelState.Anchor(slot, moveTime, idleTime, mVehicles.Get(slot)->GetMaxSpeed());
+			}
+		}
+
+		mTravelState.AdvanceClock(context.hours);
+
+		// Vehicles without a duty cycle still travel every tick.
+		mTravelState.BeginOdoBatch();
+		TravelBucketed(context, true);
+		mTravelState.EndOdoBatch();
+	}
+
+	void DeusExMachina::EnqueueRemoveVehicle(VehicleHandle handle)
+	{
+		std::unique_ptr<FleetCommand> command = std::make_unique<FleetCommand>();
+		command->kind = FleetCommand::Kind::REMOVE_VEHICLE;
+		command->handle = handle;
+		mCommands.Push(std::move(command));
+	}
+
+	void DeusExMachina::EnqueueAddPassenger(VehicleHandle handle, std::unique_ptr<const interfaces::IPassenger> passenger)
+	{
+		std::unique_ptr<FleetCommand> command = std::make_unique<FleetCommand>();
+		command->kind = FleetCommand::Kind::ADD_PASSENGER;
+		command->handle = handle;
+		command->passenger = std::move(passenger);
+		mCommands.Push(std::move(command));
+	}
+
+	void DeusExMachina::EnqueueRemovePassenger(VehicleHandle handle, unsigned int i)
+	{
+		std::unique_ptr<FleetCommand> command = std::make_unique<FleetCommand>();
+		command->kind = FleetCommand::Kind::REMOVE_PASSENGER;
+		command->handle = handle;
+		command->passengerIndex = i;
+		mCommands.Push(std::move(command));
+	}
+
+	size_t DeusExMachina::ApplyCommands()
+	{
+		FleetCommand* next = mCommands.TakeAll();
+		if (next == nullptr)
+		{
+			return 0;
+		}
+
+		EngineTrace::Scope trace("DeusExMachina::ApplyCommands", "fleet");
+		size_t applied = 0;
+		while (next != nullptr)
+		{
+			std::unique_ptr<FleetCommand> command(next);
+			next = command->next;
+
+			bool isApplied = false;
+			switch (command->kind)
+			{
+			case FleetCommand::Kind::ADD_VEHICLE:
+				isApplied = command->add(*this, std::move(command->vehicle));
+				break;
+			case FleetCommand::Kind::REMOVE_VEHICLE:
+				isApplied = RemoveVehicle(command->handle);
+				break;
+			case FleetCommand::Kind::ADD_PASSENGER:
+			{
+				Vehicle* vehicle = GetVehicle(command->handle);
+				isApplied = vehicle != nullptr && vehicle->AddPassenger(std::move(command->passenger));
+				break;
+			}
+			case FleetCommand::Kind::REMOVE_PASSENGER:
+			{
+				Vehicle* vehicle = GetVehicle(command->handle);
+				isApplied = vehicle != nullptr && vehicle->RemovePassenger(command->passengerIndex);
+				break;
+			}
+			}
+			applied += isApplied ? 1 : 0;
+		}
+		trace.SetArg("applied", applied);
+		return applied;
+	}
+
+	void DeusExMachina::SetTravelMode(TravelMode mode)
+	{
+		mTravelState.SetLazy(mode == TravelMode::LAZY);
+	}
+
+	DeusExMachina::TravelMode DeusExMachina::GetTravelMode() const
+	{
+		return mTravelState.IsLazy() ? TravelMode::LAZY : TravelMode::EAGER;
+	}
+
+	void DeusExMachina::SettleTravelState() const
+	{
+		EngineTrace::Scope trace("DeusExMachina::SettleTravelState", "travel");
+		mTravelState.SettleAll();
+	}
+
+	void DeusExMachina::RefreshCapability(unsigned int slot) const
+	{
+		const Vehicle* vehicle = mVehicles.Get(slot);
+		capabilities::CapabilityMask mask = mCapabilities.GetMask(slot);
+		for (unsigned int c = 0; c < capabilities::CAPABILITY_COUNT; ++c)
+		{
+			capabilities::Capability capability = static_cast<capabilities::Capability>(c);
+			if ((mask & capabilities::ToMask(capability)) != 0)
+			{
+				mCapabilities.Set(slot, capability, vehicle->GetCapabilitySpeed(capability), vehicle->GetPassengersWeight());
+			}
+		}
+	}
+
+	void DeusExMachina::RefreshCapabilities() const
+	{
+		mTravelState.TakeSpeedChangedSlots(mSpeedChangedSlots);
+		for (uint32_t slot : mSpeedChangedSlots)
+		{
+			RefreshCapability(slot);
+		}
+	}
+
+	void DeusExMachina::SetTravelThreadCount(unsigned int threadCount)
+	{
+		if (threadCount <= 1)
+		{
+			mTravelPool.reset();
+			return;
+		}
+
+		if (mTravelPool == nullptr || mTravelPool->GetThreadCount() != threadCount)
+		{
+			mTravelPool.reset();
+			mTravelPool = std::make_unique<WorkStealingPool>(threadCount);
+		}
+	}
+
+	unsigned int DeusExMachina::GetTravelThreadCount() const
+	{
+		return mTravelPool != nullptr ? mTravelPool->GetThreadCount() : 1;
+	}
+
+	void DeusExMachina::SetTravelChunkSize(size_t chunkSize)
+	{
+		mTravelChunkSize = chunkSize > 0 ? chunkSize : 1;
+	}
+
+	bool DeusExMachina::AddVehicle(std::unique_ptr<Vehicle> vehicle, VehicleHandle* outHandle)
+	{
+		if (vehicle == nullptr)
 		{
 			return false;
 		}
 
-		mVehicles.push_back(std::move(vehicle));
+		EngineTrace::Scope trace("DeusExMachina::AddVehicle", "fleet");
+		unsigned int slot = mTravelState.Allocate(vehicle->GetOdo(), vehicle->GetMoveTime(), vehicle->GetIdleTime());
+		VehicleHandle handle = AdoptVehicle(std::move(vehicle), slot);
+
+		if (outHandle != nullptr)
+		{
+			*outHandle = handle;
+		}
 		return true;
 	}
 
+	VehicleHandle DeusExMachina::AdoptVehicle(std::unique_ptr<Vehicle> vehicle, unsigned int slot)
+	{
+		uint32_t bucketIndex = 0;
+		std::unordered_map<std::type_index, uint32_t>::const_iterator found = mBucketByType.find(std::type_index(typeid(*vehicle)));
+		if (found != mBucketByType.end())
+		{
+			bucketIndex = found->second;
+		}
+
+		Vehicle* adopted = vehicle.get();
+		adopted->BindTravelState(&mTravelState, slot);
+		uint32_t position = mBuckets[bucketIndex]->Add(adopted, slot);
+		mBucketRefs.push_back(BucketRef{ bucketIndex, position });
+		VehicleHandle handle = mVehicles.Add(std::move(vehicle));
+		mCapabilities.Push(adopted->GetCapabilities());
+		RefreshCapability(slot);
+
+		if (mJournal != nullptr)
+		{
+			adopted->SetJournal(mJournal.get());
+			mJournal->RecordAddVehicle(*adopted);
+		}
+		return handle;
+	}
+
 	bool DeusExMachina::RemoveVehicle(unsigned int i)
 	{
-		if (i >= mVehicles.size())
+		if (i >= mVehicles.GetSize())
+		{
+			return false;
+		}
+
+		RemoveAt(i);
+		return true;
+	}
+
+	bool DeusExMachina::RemoveVehicle(VehicleHandle handle)
+	{
+		unsigned int i;
+		if (!mVehicles.TryGetDenseIndex(handle, i))
 		{
 			return false;
 		}
 
-		mVehicles.erase(mVehicles.begin() + i);
+		RemoveAt(i);
 		return true;
 	}
 
+	void DeusExMachina::RemoveAt(unsigned int i)
+	{
+		EngineTrace::Scope trace("DeusExMachina::RemoveVehicle", "fleet");
+		if (mJournal != nullptr)
+		{
+			mJournal->RecordRemoveVehicle(i);
+		}
+
+		BucketRef ref = mBucketRefs[i];
+		uint32_t movedInBucket = mBuckets[ref.bucket]->SwapRemove(ref.position);
+		if (movedInBucket != TravelBucket::NONE)
+		{
+			mBucketRefs[movedInBucket].position = ref.position;
+		}
+
+		uint32_t last = static_cast<uint32_t>(mBucketRefs.size() - 1);
+		if (i != last)
+		{
+			mBucketRefs[i] = mBucketRefs[last];
+			mBuckets[mBucketRefs[i].bucket]->SetDenseIndex(mBucketRefs[i].position, i);
+		}
+		mBucketRefs.pop_back();
+
+		mVehicles.Get(i)->UnbindTravelState();
+		mTravelState.SwapRemove(i);
+		mCapabilities.SwapRemove(i);
+		std::unique_ptr<Vehicle> removed = mVehicles.RemoveAt(i);
+		removed->SetJournal(nullptr);
+		mGraveyard.Bury(std::move(removed));
+
+		// The former last vehicle now occupies slot i.
+		if (i < mVehicles.GetSize())
+		{
+			mVehicles.Get(i)->BindTravelState(&mTravelState, i);
+		}
+	}
+
+	Graveyard& DeusExMachina::GetGraveyard()
+	{
+		return mGraveyard;
+	}
+
+	Vehicle* DeusExMachina::GetVehicle(VehicleHandle handle) const
+	{
+		unsigned int i;
+		if (!mVehicles.TryGetDenseIndex(handle, i))
+		{
+			return nullptr;
+		}
+		return mVehicles.Get(i);
+	}
+
+	VehicleHandle DeusExMachina::GetVehicleHandle(unsigned int i) const
+	{
+		return mVehicles.GetHandle(i);
+	}
+
+	bool DeusExMachina::IsValid(VehicleHandle handle) const
+	{
+		return mVehicles.IsValid(handle);
+	}
+
+	void DeusExMachina::ReserveVehicles(size_t count)
+	{
+		mVehicles.Reserve(count);
+		mTravelState.Reserve(count);
+		mBucketRefs.reserve(count);
+		mCapabilities.Reserve(count);
+	}
+
 	const Vehicle* DeusExMachina::GetFurthestTravelled() const
 	{
-		if (mVehicles.empty())
+		SettleTravelState();
+		uint32_t slot = mTravelState.GetOdometerIndex().GetFurthest();
+		if (slot == OdometerIndex::NONE)
 		{
 			return nullptr;
 		}
+		return mVehicles.Get(slot);
+	}
 
-		const Vehicle* furthest = mVehicles[0].get();
-		unsigned int maxDistance = furthest->GetOdo();
+	std::vector<const Vehicle*> DeusExMachina::GetTopTravelled(size_t count) const
+	{
+		SettleTravelState();
+		std::vector<uint32_t> slots;
+		mTravelState.GetOdometerIndex().GetTop(count, slots);
+
+		std::vector<const Vehicle*> top;
+		top.reserve(slots.size());
+		for (uint32_t slot : slots)
+		{
+			top.push_back(mVehicles.Get(slot));
+		}
+		return top;
+	}
+
+	size_t DeusExMachina::GetTravelRank(VehicleHandle handle) const
+	{
+		unsigned int i;
+		if (!mVehicles.TryGetDenseIndex(handle, i))
+		{
+			return 0;
+		}
+
+		SettleTravelState();
+		return mTravelState.GetOdometerIndex().GetRank(i);
+	}
+
+	const Vehicle* DeusExMachina::GetTravelPercentile(double percentile) const
+	{
+		size_t count = mVehicles.GetSize();
+		if (count == 0)
+		{
+			return nullptr;
+		}
 
-		for (const std::unique_ptr<vehicles::Vehicle>& vehicle : mVehicles)
+		SettleTravelState();
+
+		// Nearest-rank percentile, counted from the least travelled vehicle.
+		double clamped = percentile < 0.0 ? 0.0 : (percentile > 100.0 ? 100.0 : percentile);
+		size_t fromBottom = static_cast<size_t>(std::ceil(clamped / 100.0 * static_cast<double>(count)));
+		if (fromBottom == 0)
+		{
+			fromBottom = 1;
+		}
+
+		uint32_t slot = mTravelState.GetOdometerIndex().GetSlotAtRank(count - fromBottom + 1);
+		return mVehicles.Get(slot);
+	}
+
+	BoardingPlan DeusExMachina::PlanBoarding(const std::vector<std::unique_ptr<const interfaces::IPassenger>>& passengers) const
+	{
+		EngineTrace::Scope trace("DeusExMachina::PlanBoarding", "passengers");
+		trace.SetArg("passengers", passengers.size());
+		std::vector<BoardingPlanner::Candidate> candidates;
+		candidates.reserve(mVehicles.GetSize());
+		for (unsigned int i = 0; i < mVehicles.GetSize(); ++i)
+		{
+			const Vehicle* vehicle = mVehicles.Get(i);
+			const BucketRef& ref = mBucketRefs[i];
+			unsigned int moveTime;
+			unsigned int idleTime;
+			double moveShare = 1.0;
+			if (mBuckets[ref.bucket]->GetDutyCycle(ref.position, moveTime, idleTime) && moveTime + idleTime > 0)
+			{
+				moveShare = static_cast<double>(moveTime) / (moveTime + idleTime);
+			}
+			candidates.push_back(BoardingPlanner::Candidate{ vehicle, moveShare, vehicle->GetPassengersWeight(),
+				vehicle->GetMaxPassengersCount() - vehicle->GetPassengersCount() });
+		}
+
+		// Null entries (say, left behind by Board) get no seat.
+		std::vector<unsigned int> weights;
+		std::vector<size_t> poolIndices;
+		for (size_t p = 0; p < passengers.size(); ++p)
 		{
-			if (vehicle->GetOdo() > maxDistance)
+			if (passengers[p] != nullptr)
 			{
-				maxDistance = vehicle->GetOdo();
-				furthest = vehicle.get();
+				weights.push_back(passengers[p]->GetWeight());
+				poolIndices.push_back(p);
 			}
 		}
 
-		return furthest;
+		BoardingPlanner planner(std::move(candidates), mTravelPool.get());
+		planner.Plan(weights);
+
+		BoardingPlan plan;
+		plan.vehicles.resize(passengers.size());
+		plan.boardedCount = 0;
+		plan.distancePerTick = planner.GetDistancePerTick();
+		const std::vector<uint32_t>& assignment = planner.GetAssignment();
+		for (size_t p = 0; p < assignment.size(); ++p)
+		{
+			if (assignment[p] != BoardingPlanner::NONE)
+			{
+				plan.vehicles[poolIndices[p]] = mVehicles.GetHandle(assignment[p]);
+				++plan.boardedCount;
+			}
+		}
+		return plan;
+	}
+
+	size_t DeusExMachina::Board(std::vector<std::unique_ptr<const interfaces::IPassenger>>& passengers, const BoardingPlan& plan)
+	{
+		EngineTrace::Scope trace("DeusExMachina::Board", "passengers");
+		size_t boarded = 0;
+		for (size_t p = 0; p < passengers.size() && p < plan.vehicles.size(); ++p)
+		{
+			Vehicle* vehicle = GetVehicle(plan.vehicles[p]);
+			if (passengers[p] == nullptr || vehicle == nullptr || vehicle->GetPassengersCount() >= vehicle->GetMaxPassengersCount())
+			{
+				continue;
+			}
+			vehicle->AddPassenger(std::move(passengers[p]));
+			++boarded;
+		}
+		trace.SetArg("boarded", boarded);
+		return boarded;
+	}
+
+	size_t DeusExMachina::GetCapableCount(capabilities::Capability capability) const
+	{
+		return mCapabilities.GetCount(capability);
+	}
+
+	std::vector<VehicleHandle> DeusExMachina::FindCapable(capabilities::CapabilityMask required) const
+	{
+		std::vector<VehicleHandle> found;
+		if (required == 0)
+		{
+			found.reserve(mVehicles.GetSize());
+			for (unsigned int i = 0; i < mVehicles.GetSize(); ++i)
+			{
+				found.push_back(mVehicles.GetHandle(i));
+			}
+			return found;
+		}
+
+		capabilities::Capability rarest = capabilities::Capability::DRIVING;
+		size_t rarestCount = SIZE_MAX;
+		for (unsigned int c = 0; c < capabilities::CAPABILITY_COUNT; ++c)
+		{
+			capabilities::Capability capability = static_cast<capabilities::Capability>(c);
+			if ((required & capabilities::ToMask(capability)) != 0 && mCapabilities.GetCount(capability) < rarestCount)
+			{
+				rarest = capability;
+				rarestCount = mCapabilities.GetCount(capability);
+			}
+		}
+
+		const CapabilityStore::Component* components = mCapabilities.GetComponents(rarest);
+		for (size_t i = 0; i < rarestCount; ++i)
+		{
+			uint32_t slot = components[i].slot;
+			if ((mCapabilities.GetMask(slot) & required) == required)
+			{
+				found.push_back(mVehicles.GetHandle(slot));
+			}
+		}
+		return found;
+	}
+
+	const Vehicle* DeusExMachina::GetFastestCapable(capabilities::Capability capability, unsigned int maxPassengersWeight) const
+	{
+		RefreshCapabilities();
+
+		const CapabilityStore::Component* components = mCapabilities.GetComponents(capability);
+		size_t count = mCapabilities.GetCount(capability);
+		const CapabilityStore::Component* fastest = nullptr;
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (components[i].weight <= maxPassengersWeight && (fastest == nullptr || components[i].speed > fastest->speed))
+			{
+				fastest = &components[i];
+			}
+		}
+		return fastest != nullptr ? mVehicles.Get(fastest->slot) : nullptr;
 	}
 
 	size_t DeusExMachina::GetVehicleCount() const
 	{
-		return mVehicles.size();
+		return mVehicles.GetSize();
+	}
+
+	bool DeusExMachina::StartJournal(const char* path, const VehicleTypeRegistry& types)
+	{
+		StopJournal();
+
+		std::unique_ptr<FleetJournal> journal = std::make_unique<FleetJournal>(types);
+		if (!journal->Open(path))
+		{
+			return false;
+		}
+
+		for (size_t i = 0; i < mVehicles.GetSize(); ++i)
+		{
+			journal->RecordAddVehicle(*mVehicles.Get(static_cast<unsigned int>(i)));
+		}
+		if (journal->HasFailed())
+		{
+			return false;
+		}
+
+		mJournal = std::move(journal);
+		for (size_t i = 0; i < mVehicles.GetSize(); ++i)
+		{
+			mVehicles.Get(static_cast<unsigned int>(i))->SetJournal(mJournal.get());
+		}
+		return true;
+	}
+
+	void DeusExMachina::StopJournal()
+	{
+		if (mJournal == nullptr)
+		{
+			return;
+		}
+
+		mJournal->Close();
+		for (size_t i = 0; i < mVehicles.GetSize(); ++i)
+		{
+			mVehicles.Get(static_cast<unsigned int>(i))->SetJournal(nullptr);
+		}
+		mJournal.reset();
+	}
+
+	FleetJournal* DeusExMachina::GetJournal() const
+	{
+		return mJournal.get();
 	}
 
 } // namespace core
-} // namespace engine
\ No newline at end of file
+} // namespace engine
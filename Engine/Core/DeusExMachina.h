@@ -1,43 +1,259 @@
 #pragma once
 
+#include <climits>
+#include <cstdint>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <type_traits>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
 #include <vector>
 
+#include "BoardingPlanner.h"
+#include "CapabilityStore.h"
+#include "EngineMetrics.h"
+#include "FleetCommandQueue.h"
+#include "FleetJournal.h"
+#include "Graveyard.h"
+#include "SerialExecutor.h"
+#include "TravelBucket.h"
 #include "TravelContext.h"
+#include "TravelStateStore.h"
+#include "TravelView.h"
+#include "VehicleHandle.h"
+#include "VehicleRegistry.h"
+#include "WorkStealingPool.h"
 #include "../Vehicles/Vehicle.h"
 
 namespace engine {
 namespace core {
 
+class VehicleTypeRegistry;
+
+// One independent fleet. Engines share nothing but the process-wide name
+// table and metrics, so several can be constructed and travelled side by
+// side on different threads; see ShardedWorld.
 class DeusExMachina
 {
 public:
+	// EAGER advances every vehicle on every Travel. LAZY only records the
+	// hours: vehicles whose type declares a TravelPolicy are settled when
+	// something reads or changes them, so Travel costs O(vehicles changed
+	// since the last tick) plus any vehicles without a policy, which still
+	// travel every tick. The first leaderboard query after a LAZY Travel
+	// settles the whole fleet, so LAZY pays off when several ticks pass
+	// between queries. Both modes produce identical state.
+	enum class TravelMode : uint8_t
+	{
+		EAGER,
+		LAZY,
+	};
+
+	DeusExMachina();
+	~DeusExMachina();
+
+	DeusExMachina(const DeusExMachina& other) = delete;
+	DeusExMachina& operator=(const DeusExMachina& rhs) = delete;
+
+	// Compatibility shim for code written against the old process-wide
+	// engine. Creation and reset are thread-safe; the engine itself is not.
 	static DeusExMachina* GetInstance();
 	static void ResetInstance();
 
-	void Travel(const TravelContext& context) const;
-	bool AddVehicle(std::unique_ptr<vehicles::Vehicle> vehicle);
+	void Travel(const TravelContext& context);
+	// Queues Travel on the engine's background thread and publishes a
+	// TravelView once it completes. Calls run in order. Until the returned
+	// future is ready the engine belongs to that thread: only GetTravelView
+	// and further TravelAsync calls may be made in the meantime.
+	std::future<void> TravelAsync(const TravelContext& context);
+	// Lock-free snapshot of the last published tick; safe from any thread at
+	// any time, including while a TravelAsync is running. The lease must not
+	// outlive the engine.
+	TravelViewLease GetTravelView() const;
+	// Publishes the current state as the TravelView; TravelAsync does this
+	// after every tick, synchronous Travel and fleet edits do not.
+	void PublishTravelView();
+	// Number of threads (including the caller) Travel spreads the fleet over.
+	// 0 or 1 keeps the serial path; results are identical either way since each
+	// vehicle only touches its own state.
+	void SetTravelThreadCount(unsigned int threadCount);
+	unsigned int GetTravelThreadCount() const;
+	void SetTravelChunkSize(size_t chunkSize);
+	void SetTravelMode(TravelMode mode);
+	TravelMode GetTravelMode() const;
+	bool AddVehicle(std::unique_ptr<vehicles::Vehicle> vehicle, VehicleHandle* outHandle = nullptr);
+	// Typed overload: registers T on first use so the vehicle lands in T's
+	// statically dispatched travel bucket.
+	template <typename T>
+	bool AddVehicle(std::unique_ptr<T> vehicle, VehicleHandle* outHandle = nullptr);
+	// Gives T its own travel bucket. Travel walks each bucket in one tight
+	// loop with TravelByMachina bound at compile time (or with T's own
+	// TravelBucketType); vehicles of types that were never registered share a
+	// virtually dispatched fallback bucket. Vehicles added before
+	// registration stay where they are.
+	template <typename T>
+	void RegisterVehicleType();
+	// Removal by dense index swaps the last vehicle into slot i; hold a
+	// VehicleHandle when a reference has to survive removals. The removed
+	// vehicle goes to the graveyard rather than being destroyed here.
 	bool RemoveVehicle(unsigned int i);
+	bool RemoveVehicle(VehicleHandle handle);
+	// Where removed vehicles wait to be destroyed off the tick; by default
+	// Travel hands them to a reclaim thread at the end of every tick. Bury
+	// passengers released from the fleet here too, and switch it to IDLE to
+	// reclaim only at points of the game's choosing.
+	Graveyard& GetGraveyard();
+	vehicles::Vehicle* GetVehicle(VehicleHandle handle) const;
+	VehicleHandle GetVehicleHandle(unsigned int i) const;
+	bool IsValid(VehicleHandle handle) const;
+	void ReserveVehicles(size_t count);
+	// Leaderboard queries, served from an odometer index that is kept up to
+	// date as odometers change. Furthest is always O(1). When polled every
+	// tick, the index is re-sorted inside Travel, so rank and percentile are
+	// O(1) and top-K is O(K) on the query path; between ticks they stay
+	// logarithmic as vehicles come and go.
 	const vehicles::Vehicle* GetFurthestTravelled() const;
+	std::vector<const vehicles::Vehicle*> GetTopTravelled(size_t count) const;
+	// 1 = furthest travelled; 0 for stale handles.
+	size_t GetTravelRank(VehicleHandle handle) const;
+	// Vehicle at the given odometer percentile: 0 = least, 100 = furthest.
+	const vehicles::Vehicle* GetTravelPercentile(double percentile) const;
 	size_t GetVehicleCount() const;
+	// Capability queries, served from dense per-capability arrays that only
+	// hold the vehicles with that capability, so none of them looks at a
+	// vehicle that lacks it. Speeds are effective ones; a vehicle whose speed
+	// changed is refreshed on the next query.
+	size_t GetCapableCount(capabilities::Capability capability) const;
+	// Every vehicle with all of `required`, found by walking the array of
+	// the rarest capability among them.
+	std::vector<VehicleHandle> FindCapable(capabilities::CapabilityMask required) const;
+	// Fastest at `capability` among vehicles carrying at most
+	// `maxPassengersWeight`; nullptr if there is none.
+	const vehicles::Vehicle* GetFastestCapable(capabilities::Capability capability, unsigned int maxPassengersWeight = UINT_MAX) const;
+
+	// Plans seats for `passengers` across the fleet so as to maximize the
+	// distance it covers per tick, duty cycles included, without boarding
+	// anyone; see BoardingPlanner. Runs on the travel threads.
+	BoardingPlan PlanBoarding(const std::vector<std::unique_ptr<const interfaces::IPassenger>>& passengers) const;
+	// Boards every passenger onto its planned vehicle, leaving its entry in
+	// `passengers` null. Passengers the plan left out, or whose vehicle has
+	// since gone or filled up, stay where they are. Returns how many boarded.
+	size_t Board(std::vector<std::unique_ptr<const interfaces::IPassenger>>& passengers, const BoardingPlan& plan);
+
+	// Thread-safe, non-blocking counterparts of the fleet mutators: they only
+	// queue the change, and Travel applies everything queued so far at the
+	// start of the tick, oldest first (per producer, in the order it
+	// enqueued). A command whose handle has gone stale or that the vehicle
+	// refuses is dropped along with anything it carried.
+	template <typename T>
+	void EnqueueAddVehicle(std::unique_ptr<T> vehicle);
+	void EnqueueRemoveVehicle(VehicleHandle handle);
+	void EnqueueAddPassenger(VehicleHandle handle, std::unique_ptr<const interfaces::IPassenger> passenger);
+	void EnqueueRemovePassenger(VehicleHandle handle, unsigned int i);
+	// Applies the queued commands now, on the engine's thread; returns how
+	// many took effect.
+	size_t ApplyCommands();
+
+	// Records every later change to the fleet -- adds, removes, passenger and
+	// odometer edits, Travel calls -- to `path`, starting with the vehicles
+	// already present; see JournalReplay. Fails if the file cannot be opened
+	// or the fleet holds a type `types` does not know.
+	bool StartJournal(const char* path, const VehicleTypeRegistry& types);
+	void StopJournal();
+	// nullptr unless a journal is running.
+	FleetJournal* GetJournal() const;
 
 private:
-	struct InstanceDeleter
+	friend class FleetSnapshot;
+
+	struct BucketRef
 	{
-		void operator()(DeusExMachina* ptr) const { delete ptr; }
+		uint32_t bucket;
+		uint32_t position;
 	};
-	friend struct InstanceDeleter;
 
-	DeusExMachina() = default;
-	~DeusExMachina() = default;
-
-	DeusExMachina(const DeusExMachina& other) = delete;
-	DeusExMachina& operator=(const DeusExMachina& rhs) = delete;
+	// Binds `vehicle` to an already allocated travel slot and files it in its
+	// type's bucket; shared by AddVehicle and snapshot restore.
+	VehicleHandle AdoptVehicle(std::unique_ptr<vehicles::Vehicle> vehicle, unsigned int slot);
+	void RemoveAt(unsigned int i);
+	void TravelBucketed(const TravelContext& context, bool isSkippingDutyCycles);
+	void TravelLazy(const TravelContext& context);
+	// Settles a LAZY fleet before a query that ranks every vehicle.
+	void SettleTravelState() const;
+	void RefreshCapability(unsigned int slot) const;
+	// Brings the capability store up to date with every speed change.
+	void RefreshCapabilities() const;
 
-	static std::unique_ptr<DeusExMachina, InstanceDeleter> mInstance;
-	static constexpr size_t MAX_VEHICLES_COUNT = 10;
-	std::vector<std::unique_ptr<vehicles::Vehicle>> mVehicles;
+	static std::unique_ptr<DeusExMachina> mInstance;
+	static std::mutex mInstanceMutex;
+	static constexpr size_t DEFAULT_TRAVEL_CHUNK_SIZE = 4096;
+	// Mutable so const queries can settle a LAZY fleet.
+	mutable TravelStateStore mTravelState;
+	VehicleRegistry mVehicles;
+	std::vector<std::unique_ptr<TravelBucket>> mBuckets;    // [0] is the virtual fallback
+	std::unordered_map<std::type_index, uint32_t> mBucketByType;
+	std::vector<BucketRef> mBucketRefs;                     // parallel to the dense registry
+	// Mutable so const queries can refresh changed speeds.
+	mutable CapabilityStore mCapabilities;
+	mutable std::vector<uint32_t> mSpeedChangedSlots;       // scratch for RefreshCapabilities
+	std::unique_ptr<WorkStealingPool> mTravelPool;
+	size_t mTravelChunkSize;
+	std::vector<uint32_t> mStaleSlots;      // scratch for TravelLazy
+	uint64_t mTravelTick;                   // Travel calls completed
+	FleetCommandQueue mCommands;
+	TravelViewBuffer mTravelViews;
+	// Closed while the vehicles it may still capture are alive.
+	std::unique_ptr<FleetJournal> mJournal;
+	Graveyard mGraveyard;
+	// Last, so a queued TravelAsync finishes before anything it touches goes.
+	SerialExecutor mTravelExecutor;
 };
 
+template <typename T>
+bool DeusExMachina::AddVehicle(std::unique_ptr<T> vehicle, VehicleHandle* outHandle)
+{
+	static_assert(std::is_base_of<vehicles::Vehicle, T>::value, "T must derive from engine::vehicles::Vehicle");
+
+	// Only bucket T when it is the dynamic type; a subclass handed over as T
+	// must keep its own override.
+	if (vehicle != nullptr && typeid(*vehicle) == typeid(T))
+	{
+		RegisterVehicleType<T>();
+	}
+	return AddVehicle(std::unique_ptr<vehicles::Vehicle>(std::move(vehicle)), outHandle);
+}
+
+template <typename T>
+void DeusExMachina::EnqueueAddVehicle(std::unique_ptr<T> vehicle)
+{
+	static_assert(std::is_base_of<vehicles::Vehicle, T>::value, "T must derive from engine::vehicles::Vehicle");
+
+	std::unique_ptr<FleetCommand> command = std::make_unique<FleetCommand>();
+	command->kind = FleetCommand::Kind::ADD_VEHICLE;
+	command->vehicle = std::move(vehicle);
+	command->add = [](DeusExMachina& engine, std::unique_ptr<vehicles::Vehicle> added)
+	{
+		return engine.AddVehicle(std::unique_ptr<T>(static_cast<T*>(added.release())));
+	};
+	mCommands.Push(std::move(command));
+}
+
+template <typename T>
+void DeusExMachina::RegisterVehicleType()
+{
+	static_assert(std::is_base_of<vehicles::Vehicle, T>::value, "T must derive from engine::vehicles::Vehicle");
+
+	std::type_index type(typeid(T));
+	if (mBucketByType.find(type) != mBucketByType.end())
+	{
+		return;
+	}
+
+	mBucketByType.emplace(type, static_cast<uint32_t>(mBuckets.size()));
+	mBuckets.push_back(std::make_unique<typename TravelBucketOf<T>::Type>());
+}
+
 } // namespace core
 } // namespace engine
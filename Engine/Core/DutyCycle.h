@@ -0,0 +1,206 @@
+#pragma once
+
+#include <array>
+
+namespace engine {
+namespace core {
+
+struct DutyCycleState
+{
+	unsigned int odo;
+	unsigned int moveTime;
+	unsigned int idleTime;
+};
+
+// Advances a fixed duty cycle (moveTime ticks moving at `speed`, then
+// idleTime ticks idle) by `hours` ticks in O(1), producing the same odometer
+// and timers as stepping it one hour at a time. Inline so that policies with
+// compile-time durations fold the cycle arithmetic into constants.
+inline DutyCycleState AdvanceDutyCycle(DutyCycleState state, unsigned int hours, unsigned int moveTime, unsigned int idleTime, unsigned int speed)
+{
+	unsigned long long cycle = static_cast<unsigned long long>(moveTime) + idleTime;
+	if (hours == 0 || cycle == 0)
+	{
+		return state;
+	}
+
+	// Flatten (moveTime, idleTime) into a position within the cycle: the first
+	// moveTime positions move, the rest idle. Wrapping also recovers a Sedan
+	// whose idle budget shrank mid-idle when its trailer was detached.
+	unsigned long long start = state.moveTime < moveTime ? state.moveTime : moveTime + state.idleTime;
+	start %= cycle;
+	unsigned long long end = start + hours;
+
+	// Moving ticks in [0, x) is full cycles plus the moving part of the remainder.
+	auto movingTicksBefore = [cycle, moveTime](unsigned long long x)
+	{
+		unsigned long long rest = x % cycle;
+		return (x / cycle) * moveTime + (rest < moveTime ? rest : moveTime);
+	};
+	unsigned long long movingTicks = movingTicksBefore(end) - movingTicksBefore(start);
+
+	unsigned long long position = end % cycle;
+	unsigned long long moved = position < moveTime ? position : moveTime;
+
+	DutyCycleState next;
+	next.odo = state.odo + static_cast<unsigned int>(movingTicks * speed);
+	next.moveTime = static_cast<unsigned int>(moved);
+	next.idleTime = static_cast<unsigned int>(position - moved);
+	return next;
+}
+
+// Every vehicle on the same cycle that travels the same number of hours ends
+// up somewhere that only depends on where in the cycle it started. A batch
+// resolves the cycle once per Travel into a table indexed by start position,
+// leaving each vehicle with a lookup, a multiply-add and two selects.
+template <unsigned int MoveTime, unsigned int IdleTime>
+class DutyCycleTable
+{
+public:
+	static constexpr unsigned int CYCLE = MoveTime + IdleTime;
+	static_assert(CYCLE > 0, "A duty cycle needs at least one tick");
+
+	explicit DutyCycleTable(unsigned int hours)
+	{
+		for (unsigned int position = 0; position < CYCLE; ++position)
+		{
+			DutyCycleState start = ToState(0, position);
+			DutyCycleState end = AdvanceDutyCycle(start, hours, MoveTime, IdleTime, 1);
+			mMovingTicks[position] = end.odo;
+			mEndPosition[position] = end.moveTime + end.idleTime;
+		}
+	}
+
+	DutyCycleState Advance(DutyCycleState state, unsigned int speed) const
+	{
+		unsigned int start = state.moveTime < MoveTime ? state.moveTime : MoveTime + state.idleTime;
+		start %= CYCLE;
+		return ToState(state.odo + mMovingTicks[start] * speed, mEndPosition[start]);
+	}
+
+private:
+	static DutyCycleState ToState(unsigned int odo, unsigned int position)
+	{
+		unsigned int moved = position < MoveTime ? position : MoveTime;
+		return DutyCycleState{ odo, moved, position - moved };
+	}
+
+	std::array<unsigned int, CYCLE> mMovingTicks;
+	std::array<unsigned int, CYCLE> mEndPosition;
+};
+
+// Idle-time modifiers for DutyCycle. A modifier names an alternative idle time
+// and the vehicle state that selects it.
+struct NoIdleModifier
+{
+};
+
+// Longer idle while the vehicle has something in tow; requires
+// `bool IsTowing() const` on the vehicle.
+template <unsigned int TowingIdleTime>
+struct TowingIdleModifier
+{
+	static constexpr unsigned int IDLE_TIME = TowingIdleTime;
+
+	template <typename TVehicle>
+	static bool IsActive(const TVehicle& vehicle) { return vehicle.IsTowing(); }
+};
+
+// Compile-time travel policy: move for MoveTime ticks, idle for IdleTime
+// ticks (or the modifier's idle time while it is active), repeat. A Game
+// vehicle declares `using TravelPolicy = DutyCycle<...>;` and supplies only
+// its speed; the engine can then advance a whole bucket of that type through
+// one shared Batch instead of per-vehicle state machines.
+template <unsigned int MoveTime, unsigned int IdleTime, typename TIdleModifier = NoIdleModifier>
+class DutyCycle
+{
+public:
+	static constexpr unsigned int MOVE_TIME = MoveTime;
+	static constexpr unsigned int IDLE_TIME = IdleTime;
+
+	template <typename TVehicle>
+	static unsigned int GetIdleTime(const TVehicle& vehicle)
+	{
+		return TIdleModifier::IsActive(vehicle) ? TIdleModifier::IDLE_TIME : IdleTime;
+	}
+
+	template <typename TVehicle>
+	static DutyCycleState Advance(const TVehicle& vehicle, DutyCycleState state, unsigned int hours, unsigned int speed)
+	{
+		return AdvanceDutyCycle(state, hours, MoveTime, GetIdleTime(vehicle), speed);
+	}
+
+	class Batch
+	{
+	public:
+		explicit Batch(unsigned int hours)
+			: mBase(hours)
+			, mModified(hours)
+			, mIsIdentity(hours == 0)
+		{
+		}
+
+		template <typename TVehicle>
+		DutyCycleState Advance(const TVehicle& vehicle, DutyCycleState state, unsigned int speed) const
+		{
+			if (mIsIdentity)
+			{
+				return state;
+			}
+
+			// Both lookups are cheap; selecting between them keeps the loop
+			// free of data-dependent branches.
+			DutyCycleState base = mBase.Advance(state, speed);
+			DutyCycleState modified = mModified.Advance(state, speed);
+			return TIdleModifier::IsActive(vehicle) ? modified : base;
+		}
+
+	private:
+		DutyCycleTable<MoveTime, IdleTime> mBase;
+		DutyCycleTable<MoveTime, TIdleModifier::IDLE_TIME> mModified;
+		bool mIsIdentity;
+	};
+};
+
+template <unsigned int MoveTime, unsigned int IdleTime>
+class DutyCycle<MoveTime, IdleTime, NoIdleModifier>
+{
+public:
+	static constexpr unsigned int MOVE_TIME = MoveTime;
+	static constexpr unsigned int IDLE_TIME = IdleTime;
+
+	template <typename TVehicle>
+	static unsigned int GetIdleTime(const TVehicle&)
+	{
+		return IdleTime;
+	}
+
+	template <typename TVehicle>
+	static DutyCycleState Advance(const TVehicle&, DutyCycleState state, unsigned int hours, unsigned int speed)
+	{
+		return AdvanceDutyCycle(state, hours, MoveTime, IdleTime, speed);
+	}
+
+	class Batch
+	{
+	public:
+		explicit Batch(unsigned int hours)
+			: mTable(hours)
+			, mIsIdentity(hours == 0)
+		{
+		}
+
+		template <typename TVehicle>
+		DutyCycleState Advance(const TVehicle&, DutyCycleState state, unsigned int speed) const
+		{
+			return mIsIdentity ? state : mTable.Advance(state, speed);
+		}
+
+	private:
+		DutyCycleTable<MoveTime, IdleTime> mTable;
+		bool mIsIdentity;
+	};
+};
+
+} // namespace core
+} // namespace engine
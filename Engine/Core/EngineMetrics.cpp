@@ -0,0 +1,428 @@
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+
+#include "EngineMetrics.h"
+
+namespace engine {
+namespace core {
+
+namespace {
+
+	typedef std::chrono::steady_clock Clock;
+
+	// Upper bound, in nanoseconds, of latency bucket `bucket`.
+	uint64_t GetBucketLimit(uint32_t bucket)
+	{
+		return 1ull << bucket;
+	}
+
+	// Smallest bucket limit that covers `percentile` of the ticks.
+	uint64_t GetLatencyPercentile(const EngineMetrics::Totals& totals, double percentile)
+	{
+		if (totals.ticks == 0)
+		{
+			return 0;
+		}
+
+		uint64_t rank = static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(totals.ticks) + 0.5);
+		rank = rank > 0 ? rank : 1;
+
+		uint64_t seen = 0;
+		for (uint32_t bucket = 0; bucket < EngineMetrics::LATENCY_BUCKETS; ++bucket)
+		{
+			seen += totals.latency[bucket];
+			if (seen >= rank)
+			{
+				return GetBucketLimit(bucket);
+			}
+		}
+		return GetBucketLimit(EngineMetrics::LATENCY_BUCKETS - 1);
+	}
+
+	double GetRate(uint64_t count, double seconds)
+	{
+		return seconds > 0.0 ? static_cast<double>(count) / seconds : 0.0;
+	}
+
+	void WriteJsonString(std::ostream& out, const std::string& value)
+	{
+		out << '"';
+		for (char c : value)
+		{
+			if (c == '"' || c == '\\')
+			{
+				out << '\\';
+			}
+			out << c;
+		}
+		out << '"';
+	}
+
+#if MACHINA_ENABLE_METRICS
+	// One thread's counters. Only the owning thread writes them, so updates
+	// are a relaxed load and store rather than a locked read-modify-write.
+	struct alignas(64) Shard
+	{
+		Shard()
+		{
+			ticks.store(0, std::memory_order_relaxed);
+			tickNanoseconds.store(0, std::memory_order_relaxed);
+			for (std::atomic<uint64_t>& count : latency)
+			{
+				count.store(0, std::memory_order_relaxed);
+			}
+			for (uint32_t type = 0; type < EngineMetrics::MAX_TYPES; ++type)
+			{
+				travelled[type].store(0, std::memory_order_relaxed);
+				moving[type].store(0, std::memory_order_relaxed);
+			}
+			passengersBoarded.store(0, std::memory_order_relaxed);
+			passengersAlighted.store(0, std::memory_order_relaxed);
+			vehiclesReclaimed.store(0, std::memory_order_relaxed);
+			passengersReclaimed.store(0, std::memory_order_relaxed);
+			reclaimNanoseconds.store(0, std::memory_order_relaxed);
+		}
+
+		std::atomic<uint64_t> ticks;
+		std::atomic<uint64_t> tickNanoseconds;
+		std::atomic<uint64_t> latency[EngineMetrics::LATENCY_BUCKETS];
+		std::atomic<uint64_t> travelled[EngineMetrics::MAX_TYPES];
+		std::atomic<uint64_t> moving[EngineMetrics::MAX_TYPES];
+		std::atomic<uint64_t> passengersBoarded;
+		std::atomic<uint64_t> passengersAlighted;
+		std::atomic<uint64_t> vehiclesReclaimed;
+		std::atomic<uint64_t> passengersReclaimed;
+		std::atomic<uint64_t> reclaimNanoseconds;
+	};
+
+	void Bump(std::atomic<uint64_t>& counter, uint64_t amount)
+	{
+		counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+	}
+
+	// Shards outlive their threads: a finished thread's counts still belong
+	// in the totals, and its shard is handed to the next new thread.
+	struct Registry
+	{
+		std::mutex mutex;
+		std::vector<std::unique_ptr<Shard>> shards;
+		std::vector<Shard*> freeShards;
+		std::vector<std::string> typeNames;
+		EngineMetrics::Totals baseline;         // raw counts at the last Reset
+		Clock::time_point windowStart;
+	};
+
+	Registry& GetRegistry()
+	{
+		// Deliberately leaked: threads may still record during static destruction.
+		static Registry* registry = []()
+		{
+			Registry* created = new Registry();
+			created->baseline = EngineMetrics::Totals();
+			created->windowStart = Clock::now();
+			return created;
+		}();
+		return *registry;
+	}
+
+	class ShardLease
+	{
+	public:
+		ShardLease()
+		{
+			Registry& registry = GetRegistry();
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			if (!registry.freeShards.empty())
+			{
+				mShard = registry.freeShards.back();
+				registry.freeShards.pop_back();
+				return;
+			}
+			registry.shards.push_back(std::make_unique<Shard>());
+			mShard = registry.shards.back().get();
+		}
+
+		~ShardLease()
+		{
+			Registry& registry = GetRegistry();
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			registry.freeShards.push_back(mShard);
+		}
+
+		Shard& GetShard() { return *mShard; }
+
+	private:
+		Shard* mShard;
+	};
+
+	Shard& GetLocalShard()
+	{
+		thread_local ShardLease lease;
+		return lease.GetShard();
+	}
+
+	std::string Demangle(const char* name)
+	{
+#if defined(__GNUG__)
+		int status = 0;
+		char* demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+		if (status == 0 && demangled != nullptr)
+		{
+			std::string result(demangled);
+			std::free(demangled);
+			return result;
+		}
+#endif
+		return name;
+	}
+
+	// Raw counts since process start; the caller holds the registry mutex.
+	EngineMetrics::Totals ReadRaw(const Registry& registry)
+	{
+		EngineMetrics::Totals totals = EngineMetrics::Totals();
+		for (const std::unique_ptr<Shard>& shard : registry.shards)
+		{
+			totals.ticks += shard->ticks.load(std::memory_order_relaxed);
+			totals.tickNanoseconds += shard->tickNanoseconds.load(std::memory_order_relaxed);
+			for (uint32_t bucket = 0; bucket < EngineMetrics::LATENCY_BUCKETS; ++bucket)
+			{
+				totals.latency[bucket] += shard->latency[bucket].load(std::memory_order_relaxed);
+			}
+			totals.passengersBoarded += shard->passengersBoarded.load(std::memory_order_relaxed);
+			totals.passengersAlighted += shard->passengersAlighted.load(std::memory_order_relaxed);
+			totals.vehiclesReclaimed += shard->vehiclesReclaimed.load(std::memory_order_relaxed);
+			totals.passengersReclaimed += shard->passengersReclaimed.load(std::memory_order_relaxed);
+			totals.reclaimNanoseconds += shard->reclaimNanoseconds.load(std::memory_order_relaxed);
+		}
+
+		size_t typeCount = registry.typeNames.size() < EngineMetrics::MAX_TYPES ? registry.typeNames.size() : EngineMetrics::MAX_TYPES;
+		totals.types.resize(typeCount);
+		for (size_t type = 0; type < typeCount; ++type)
+		{
+			EngineMetrics::TypeTotals& typeTotals = totals.types[type];
+			typeTotals.name = registry.typeNames[type];
+			typeTotals.travelled = 0;
+			typeTotals.moving = 0;
+			for (const std::unique_ptr<Shard>& shard : registry.shards)
+			{
+				typeTotals.travelled += shard->travelled[type].load(std::memory_order_relaxed);
+				typeTotals.moving += shard->moving[type].load(std::memory_order_relaxed);
+			}
+			totals.travelled += typeTotals.travelled;
+			totals.moving += typeTotals.moving;
+		}
+		if (registry.typeNames.size() > EngineMetrics::MAX_TYPES)
+		{
+			totals.types.back().name = "(other)";
+		}
+		return totals;
+	}
+#endif
+
+} // namespace
+
+#if MACHINA_ENABLE_METRICS
+	uint32_t EngineMetrics::RegisterType(const std::type_info& type)
+	{
+		return RegisterType(Demangle(type.name()).c_str());
+	}
+
+	uint32_t EngineMetrics::RegisterType(const char* name)
+	{
+		Registry& registry = GetRegistry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+
+		uint32_t id = 0;
+		while (id < registry.typeNames.size() && registry.typeNames[id] != name)
+		{
+			++id;
+		}
+		if (id == registry.typeNames.size())
+		{
+			registry.typeNames.push_back(name);
+		}
+		return id < MAX_TYPES ? id : MAX_TYPES - 1;
+	}
+
+	void EngineMetrics::AddTick(std::chrono::steady_clock::duration duration)
+	{
+		uint64_t nanoseconds = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+		uint32_t bucket = 0;
+		for (uint64_t rest = nanoseconds; rest != 0 && bucket < LATENCY_BUCKETS - 1; rest >>= 1)
+		{
+			++bucket;
+		}
+
+		Shard& shard = GetLocalShard();
+		Bump(shard.ticks, 1);
+		Bump(shard.tickNanoseconds, nanoseconds);
+		Bump(shard.latency[bucket], 1);
+	}
+
+	void EngineMetrics::AddTravelled(uint32_t type, uint64_t count, uint64_t moving)
+	{
+		Shard& shard = GetLocalShard();
+		Bump(shard.travelled[type], count);
+		Bump(shard.moving[type], moving);
+	}
+
+	void EngineMetrics::AddPassengersBoarded(uint64_t count)
+	{
+		Bump(GetLocalShard().passengersBoarded, count);
+	}
+
+	void EngineMetrics::AddPassengersAlighted(uint64_t count)
+	{
+		Bump(GetLocalShard().passengersAlighted, count);
+	}
+
+	void EngineMetrics::AddReclaimed(uint64_t vehicles, uint64_t passengers, std::chrono::steady_clock::duration duration)
+	{
+		Shard& shard = GetLocalShard();
+		Bump(shard.vehiclesReclaimed, vehicles);
+		Bump(shard.passengersReclaimed, passengers);
+		Bump(shard.reclaimNanoseconds, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count()));
+	}
+#endif
+
+	EngineMetrics::Totals EngineMetrics::Read()
+	{
+		Totals totals = Totals();
+#if MACHINA_ENABLE_METRICS
+		Registry& registry = GetRegistry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+
+		totals = ReadRaw(registry);
+		const Totals& baseline = registry.baseline;
+		totals.elapsedSeconds = std::chrono::duration<double>(Clock::now() - registry.windowStart).count();
+		totals.ticks -= baseline.ticks;
+		totals.tickNanoseconds -= baseline.tickNanoseconds;
+		for (uint32_t bucket = 0; bucket < LATENCY_BUCKETS; ++bucket)
+		{
+			totals.latency[bucket] -= baseline.latency[bucket];
+		}
+		totals.travelled -= baseline.travelled;
+		totals.moving -= baseline.moving;
+		totals.passengersBoarded -= baseline.passengersBoarded;
+		totals.passengersAlighted -= baseline.passengersAlighted;
+		totals.vehiclesReclaimed -= baseline.vehiclesReclaimed;
+		totals.passengersReclaimed -= baseline.passengersReclaimed;
+		totals.reclaimNanoseconds -= baseline.reclaimNanoseconds;
+		for (size_t type = 0; type < totals.types.size() && type < baseline.types.size(); ++type)
+		{
+			totals.types[type].travelled -= baseline.types[type].travelled;
+			totals.types[type].moving -= baseline.types[type].moving;
+		}
+#endif
+		return totals;
+	}
+
+	void EngineMetrics::Reset()
+	{
+#if MACHINA_ENABLE_METRICS
+		Registry& registry = GetRegistry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		registry.baseline = ReadRaw(registry);
+		registry.windowStart = Clock::now();
+#endif
+	}
+
+	std::string EngineMetrics::ToText()
+	{
+		if (!IS_ENABLED)
+		{
+			return "metrics compiled out (MACHINA_ENABLE_METRICS=OFF)\n";
+		}
+
+		Totals totals = Read();
+		double meanNs = totals.ticks > 0 ? static_cast<double>(totals.tickNanoseconds) / static_cast<double>(totals.ticks) : 0.0;
+
+		std::ostringstream out;
+		out << std::fixed << std::setprecision(1);
+		out << "window: " << totals.elapsedSeconds << " s\n";
+		out << "ticks: " << totals.ticks
+			<< " (mean " << meanNs / 1000.0 << " us"
+			<< ", p50 <= " << static_cast<double>(GetLatencyPercentile(totals, 50.0)) / 1000.0 << " us"
+			<< ", p90 <= " << static_cast<double>(GetLatencyPercentile(totals, 90.0)) / 1000.0 << " us"
+			<< ", p99 <= " << static_cast<double>(GetLatencyPercentile(totals, 99.0)) / 1000.0 << " us)\n";
+		out << "vehicles travelled: " << totals.travelled
+			<< " (moving " << totals.moving << ", idle " << totals.travelled - totals.moving << ")\n";
+		for (const TypeTotals& type : totals.types)
+		{
+			out << "  " << type.name << ": " << type.travelled
+				<< " (moving " << type.moving << ", idle " << type.travelled - type.moving << ")\n";
+		}
+		out << "passengers: boarded " << totals.passengersBoarded << " (" << GetRate(totals.passengersBoarded, totals.elapsedSeconds) << "/s)"
+			<< ", alighted " << totals.passengersAlighted << " (" << GetRate(totals.passengersAlighted, totals.elapsedSeconds) << "/s)\n";
+		out << "reclaimed: vehicles " << totals.vehiclesReclaimed << ", passengers " << totals.passengersReclaimed
+			<< " in " << static_cast<double>(totals.reclaimNanoseconds) / 1e6 << " ms"
+			<< " (" << GetRate(totals.vehiclesReclaimed + totals.passengersReclaimed, static_cast<double>(totals.reclaimNanoseconds) * 1e-9) << " objects/s)\n";
+		return out.str();
+	}
+
+	std::string EngineMetrics::ToJson()
+	{
+		if (!IS_ENABLED)
+		{
+			return "{\"enabled\":false}";
+		}
+
+		Totals totals = Read();
+		std::ostringstream out;
+		out << std::fixed << std::setprecision(3);
+		out << "{\"enabled\":true"
+			<< ",\"elapsedSeconds\":" << totals.elapsedSeconds
+			<< ",\"ticks\":{\"count\":" << totals.ticks
+			<< ",\"totalNs\":" << totals.tickNanoseconds
+			<< ",\"p50Ns\":" << GetLatencyPercentile(totals, 50.0)
+			<< ",\"p90Ns\":" << GetLatencyPercentile(totals, 90.0)
+			<< ",\"p99Ns\":" << GetLatencyPercentile(totals, 99.0)
+			<< ",\"histogram\":[";
+		bool isFirst = true;
+		for (uint32_t bucket = 0; bucket < LATENCY_BUCKETS; ++bucket)
+		{
+			if (totals.latency[bucket] == 0)
+			{
+				continue;
+			}
+			out << (isFirst ? "" : ",") << "{\"leNs\":" << GetBucketLimit(bucket) << ",\"count\":" << totals.latency[bucket] << '}';
+			isFirst = false;
+		}
+		out << "]}"
+			<< ",\"vehicles\":{\"travelled\":" << totals.travelled
+			<< ",\"moving\":" << totals.moving
+			<< ",\"idle\":" << totals.travelled - totals.moving
+			<< ",\"byType\":[";
+		for (size_t type = 0; type < totals.types.size(); ++type)
+		{
+			const TypeTotals& typeTotals = totals.types[type];
+			out << (type == 0 ? "" : ",") << "{\"name\":";
+			WriteJsonString(out, typeTotals.name);
+			out << ",\"travelled\":" << typeTotals.travelled
+				<< ",\"moving\":" << typeTotals.moving
+				<< ",\"idle\":" << typeTotals.travelled - typeTotals.moving << '}';
+		}
+		out << "]}"
+			<< ",\"passengers\":{\"boarded\":" << totals.passengersBoarded
+			<< ",\"alighted\":" << totals.passengersAlighted
+			<< ",\"boardedPerSecond\":" << GetRate(totals.passengersBoarded, totals.elapsedSeconds)
+			<< ",\"alightedPerSecond\":" << GetRate(totals.passengersAlighted, totals.elapsedSeconds)
+			<< "}"
+			<< ",\"reclaimed\":{\"vehicles\":" << totals.vehiclesReclaimed
+			<< ",\"passengers\":" << totals.passengersReclaimed
+			<< ",\"totalNs\":" << totals.reclaimNanoseconds
+			<< ",\"objectsPerSecond\":" << GetRate(totals.vehiclesReclaimed + totals.passengersReclaimed, static_cast<double>(totals.reclaimNanoseconds) * 1e-9)
+			<< "}}";
+		return out.str();
+	}
+
+} // namespace core
+} // namespace engine
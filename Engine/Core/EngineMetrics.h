@@ -0,0 +1,107 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+// Set by the MACHINA_ENABLE_METRICS CMake option. At 0 every recording call
+// below is an empty inline function and the counters do not exist.
+#ifndef MACHINA_ENABLE_METRICS
+#define MACHINA_ENABLE_METRICS 0
+#endif
+
+namespace engine {
+namespace core {
+
+// Process-wide engine instrumentation: Travel tick latency, vehicles
+// travelled per type (and how many of them moved), passenger boardings, and
+// what graveyards destroyed off the tick.
+//
+// Each thread records into its own cache-line aligned block of counters, so
+// recording is a plain relaxed load and store with no contention, including
+// from the travel worker threads. Read sums the blocks on demand.
+class EngineMetrics
+{
+public:
+	static constexpr bool IS_ENABLED = MACHINA_ENABLE_METRICS != 0;
+	// Types registered beyond this share the last slot.
+	static constexpr uint32_t MAX_TYPES = 32;
+	// Tick latency bucket i holds ticks of [2^(i-1), 2^i) nanoseconds.
+	static constexpr uint32_t LATENCY_BUCKETS = 48;
+
+	struct TypeTotals
+	{
+		std::string name;
+		uint64_t travelled;
+		uint64_t moving;
+	};
+
+	struct Totals
+	{
+		double elapsedSeconds;          // since the first use or the last Reset
+		uint64_t ticks;
+		uint64_t tickNanoseconds;
+		uint64_t latency[LATENCY_BUCKETS];
+		uint64_t travelled;
+		uint64_t moving;
+		uint64_t passengersBoarded;
+		uint64_t passengersAlighted;
+		uint64_t vehiclesReclaimed;     // destroyed by a Graveyard
+		uint64_t passengersReclaimed;
+		uint64_t reclaimNanoseconds;
+		std::vector<TypeTotals> types;
+	};
+
+#if MACHINA_ENABLE_METRICS
+	// Stable id for a vehicle type's counters; the name is the demangled
+	// type name where the platform offers it.
+	static uint32_t RegisterType(const std::type_info& type);
+	static uint32_t RegisterType(const char* name);
+	static void AddTick(std::chrono::steady_clock::duration duration);
+	// `moving` of the `count` vehicles advanced their odometer.
+	static void AddTravelled(uint32_t type, uint64_t count, uint64_t moving);
+	static void AddPassengersBoarded(uint64_t count);
+	static void AddPassengersAlighted(uint64_t count);
+	static void AddReclaimed(uint64_t vehicles, uint64_t passengers, std::chrono::steady_clock::duration duration);
+#else
+	static uint32_t RegisterType(const std::type_info&) { return 0; }
+	static uint32_t RegisterType(const char*) { return 0; }
+	static void AddTick(std::chrono::steady_clock::duration) {}
+	static void AddTravelled(uint32_t, uint64_t, uint64_t) {}
+	static void AddPassengersBoarded(uint64_t) {}
+	static void AddPassengersAlighted(uint64_t) {}
+	static void AddReclaimed(uint64_t, uint64_t, std::chrono::steady_clock::duration) {}
+#endif
+
+	// Counts since the first use or the last Reset; all zero when compiled out.
+	static Totals Read();
+	// Starts a new measurement window. Threads keep recording meanwhile.
+	static void Reset();
+	static std::string ToText();
+	static std::string ToJson();
+
+	// Times its own lifetime as one tick.
+	class TickTimer
+	{
+	public:
+#if MACHINA_ENABLE_METRICS
+		TickTimer()
+			: mStart(std::chrono::steady_clock::now())
+		{
+		}
+
+		~TickTimer() { AddTick(std::chrono::steady_clock::now() - mStart); }
+
+	private:
+		std::chrono::steady_clock::time_point mStart;
+#else
+		TickTimer() {}
+#endif
+	};
+};
+
+} // namespace core
+} // namespace engine
@@ -0,0 +1,422 @@
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "EngineTrace.h"
+
+namespace engine {
+namespace core {
+
+#if MACHINA_ENABLE_TRACING
+namespace {
+
+	typedef std::chrono::steady_clock Clock;
+
+	static_assert((EngineTrace::RING_CAPACITY & (EngineTrace::RING_CAPACITY - 1)) == 0, "RING_CAPACITY must be a power of two");
+
+	struct TraceEvent
+	{
+		const char* name;
+		const char* category;
+		const char* argName;        // nullptr when the event has no argument
+		uint64_t startNs;
+		uint64_t durationNs;
+		uint64_t arg;
+	};
+
+	// One thread's events. The owning thread only advances `tail` and the
+	// flusher only advances `head`, so neither side ever waits on the other.
+	struct Ring
+	{
+		Ring(uint32_t id)
+			: tid(id)
+			, events(new TraceEvent[EngineTrace::RING_CAPACITY])
+		{
+			head.store(0, std::memory_order_relaxed);
+			tail.store(0, std::memory_order_relaxed);
+			dropped.store(0, std::memory_order_relaxed);
+			isRetired.store(false, std::memory_order_relaxed);
+		}
+
+		const uint32_t tid;
+		std::unique_ptr<TraceEvent[]> events;
+		alignas(64) std::atomic<uint64_t> head;
+		alignas(64) std::atomic<uint64_t> tail;
+		std::atomic<uint64_t> dropped;
+		std::atomic<bool> isRetired;    // set once the owning thread has exited
+		std::string name;               // guarded by the registry mutex
+		bool hasEvents = false;         // in this session; flusher only
+	};
+
+	struct Registry
+	{
+		std::mutex mutex;
+		std::vector<std::unique_ptr<Ring>> rings;
+		uint32_t nextTid = 1;
+		uint64_t retiredDropped = 0;    // drops counted by rings already freed
+
+		// Session state. `control` serialises Start and Stop; the flusher
+		// owns `file` and `text` while the session runs.
+		std::mutex control;
+		std::FILE* file = nullptr;
+		uint64_t epochNs = 0;
+		uint64_t droppedBaseline = 0;
+		uint64_t lastDropped = 0;
+		bool isFirstEvent = true;
+		std::string text;
+		std::thread flusher;
+		std::mutex wakeMutex;
+		std::condition_variable wake;
+		bool isStopping = false;
+	};
+
+	Registry& GetRegistry()
+	{
+		// Deliberately leaked: threads may still record during static destruction.
+		static Registry* registry = new Registry();
+		return *registry;
+	}
+
+	// Naming a thread does not give it a ring; the name waits here until
+	// the thread records its first event.
+	struct LocalThread
+	{
+		std::string name;
+		Ring* ring = nullptr;
+	};
+
+	LocalThread& GetLocalThread()
+	{
+		thread_local LocalThread local;
+		return local;
+	}
+
+	class RingLease
+	{
+	public:
+		RingLease()
+		{
+			LocalThread& local = GetLocalThread();
+			Registry& registry = GetRegistry();
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			registry.rings.push_back(std::make_unique<Ring>(registry.nextTid++));
+			mRing = registry.rings.back().get();
+			mRing->name = local.name;
+			local.ring = mRing;
+		}
+
+		// The flusher frees the ring once it has written out what is left.
+		~RingLease()
+		{
+			mRing->isRetired.store(true, std::memory_order_release);
+		}
+
+		Ring& GetRing() { return *mRing; }
+
+	private:
+		Ring* mRing;
+	};
+
+	Ring& GetLocalRing()
+	{
+		thread_local RingLease lease;
+		return lease.GetRing();
+	}
+
+	// Sum of every drop counter since process start; the caller holds the
+	// registry mutex.
+	uint64_t ReadDropped(const Registry& registry)
+	{
+		uint64_t dropped = registry.retiredDropped;
+		for (const std::unique_ptr<Ring>& ring : registry.rings)
+		{
+			dropped += ring->dropped.load(std::memory_order_relaxed);
+		}
+		return dropped;
+	}
+
+	void AppendJsonString(std::string& out, const char* value)
+	{
+		out += '"';
+		for (const char* c = value; *c != '\0'; ++c)
+		{
+			if (*c == '"' || *c == '\\')
+			{
+				out += '\\';
+			}
+			out += *c;
+		}
+		out += '"';
+	}
+
+	// Trace-event timestamps are microseconds; keep the nanoseconds as decimals.
+	void AppendMicroseconds(std::string& out, uint64_t nanoseconds)
+	{
+		char digits[32];
+		std::snprintf(digits, sizeof(digits), "%llu.%03llu", static_cast<unsigned long long>(nanoseconds / 1000), static_cast<unsigned long long>(nanoseconds % 1000));
+		out += digits;
+	}
+
+	void AppendSeparator(Registry& registry)
+	{
+		registry.text += registry.isFirstEvent ? "\n" : ",\n";
+		registry.isFirstEvent = false;
+	}
+
+	void AppendThreadName(Registry& registry, uint32_t tid, const std::string& name)
+	{
+		AppendSeparator(registry);
+		registry.text += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":";
+		registry.text += std::to_string(tid);
+		registry.text += ",\"args\":{\"name\":";
+		AppendJsonString(registry.text, name.c_str());
+		registry.text += "}}";
+	}
+
+	// Moves everything the rings hold into the file, then frees the rings
+	// of threads that have exited. Runs on the flusher thread only.
+	void Flush(Registry& registry)
+	{
+		std::vector<Ring*> rings;
+		{
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			rings.reserve(registry.rings.size());
+			for (const std::unique_ptr<Ring>& ring : registry.rings)
+			{
+				rings.push_back(ring.get());
+			}
+		}
+
+		std::vector<Ring*> drained;
+		for (Ring* ring : rings)
+		{
+			// Read before the tail, so a retired ring is known to be complete.
+			bool isRetired = ring->isRetired.load(std::memory_order_acquire);
+			uint64_t head = ring->head.load(std::memory_order_relaxed);
+			uint64_t tail = ring->tail.load(std::memory_order_acquire);
+			for (; head != tail; ++head)
+			{
+				const TraceEvent& event = ring->events[head & (EngineTrace::RING_CAPACITY - 1)];
+				// Left over from an earlier session.
+				if (event.startNs < registry.epochNs)
+				{
+					continue;
+				}
+
+				ring->hasEvents = true;
+				AppendSeparator(registry);
+				registry.text += "{\"name\":";
+				AppendJsonString(registry.text, event.name);
+				registry.text += ",\"cat\":";
+				AppendJsonString(registry.text, event.category);
+				registry.text += ",\"ph\":\"X\",\"pid\":1,\"tid\":";
+				registry.text += std::to_string(ring->tid);
+				registry.text += ",\"ts\":";
+				AppendMicroseconds(registry.text, event.startNs - registry.epochNs);
+				registry.text += ",\"dur\":";
+				AppendMicroseconds(registry.text, event.durationNs);
+				if (event.argName != nullptr)
+				{
+					registry.text += ",\"args\":{";
+					AppendJsonString(registry.text, event.argName);
+					registry.text += ':';
+					registry.text += std::to_string(event.arg);
+					registry.text += '}';
+				}
+				registry.text += '}';
+			}
+			ring->head.store(tail, std::memory_order_release);
+			if (isRetired)
+			{
+				drained.push_back(ring);
+			}
+		}
+
+		std::fwrite(registry.text.data(), 1, registry.text.size(), registry.file);
+		registry.text.clear();
+
+		if (drained.empty())
+		{
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		for (Ring* ring : drained)
+		{
+			for (size_t i = 0; i < registry.rings.size(); ++i)
+			{
+				if (registry.rings[i].get() == ring)
+				{
+					// Stop only labels the rings still registered.
+					if (ring->hasEvents && !ring->name.empty())
+					{
+						AppendThreadName(registry, ring->tid, ring->name);
+					}
+					registry.retiredDropped += ring->dropped.load(std::memory_order_relaxed);
+					registry.rings[i] = std::move(registry.rings.back());
+					registry.rings.pop_back();
+					break;
+				}
+			}
+		}
+	}
+
+	void FlusherLoop(Registry& registry)
+	{
+		bool isStopping = false;
+		while (!isStopping)
+		{
+			{
+				std::unique_lock<std::mutex> lock(registry.wakeMutex);
+				registry.wake.wait_for(lock, EngineTrace::FLUSH_INTERVAL, [&registry]() { return registry.isStopping; });
+				isStopping = registry.isStopping;
+			}
+			Flush(registry);
+		}
+	}
+
+} // namespace
+
+	std::atomic<bool> EngineTrace::mIsRunning(false);
+
+	bool EngineTrace::Start(const char* path)
+	{
+		Registry& registry = GetRegistry();
+		std::lock_guard<std::mutex> control(registry.control);
+		if (IsRunning())
+		{
+			return false;
+		}
+
+		registry.file = std::fopen(path, "wb");
+		if (registry.file == nullptr)
+		{
+			return false;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			registry.droppedBaseline = ReadDropped(registry);
+			for (const std::unique_ptr<Ring>& ring : registry.rings)
+			{
+				ring->hasEvents = false;
+			}
+		}
+		registry.epochNs = Now();
+		registry.isFirstEvent = true;
+		registry.text = "{\"traceEvents\":[";
+		registry.isStopping = false;
+		registry.flusher = std::thread(FlusherLoop, std::ref(registry));
+		mIsRunning.store(true, std::memory_order_relaxed);
+		return true;
+	}
+
+	void EngineTrace::Stop()
+	{
+		Registry& registry = GetRegistry();
+		std::lock_guard<std::mutex> control(registry.control);
+		if (!IsRunning())
+		{
+			return;
+		}
+
+		mIsRunning.store(false, std::memory_order_relaxed);
+		{
+			std::lock_guard<std::mutex> lock(registry.wakeMutex);
+			registry.isStopping = true;
+		}
+		registry.wake.notify_one();
+		registry.flusher.join();
+
+		// The flusher's last pass has emptied the rings; label the tracks.
+		std::vector<std::pair<uint32_t, std::string>> names;
+		{
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			registry.lastDropped = ReadDropped(registry) - registry.droppedBaseline;
+			for (const std::unique_ptr<Ring>& ring : registry.rings)
+			{
+				if (ring->hasEvents && !ring->name.empty())
+				{
+					names.emplace_back(ring->tid, ring->name);
+				}
+			}
+		}
+
+		AppendSeparator(registry);
+		registry.text += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"MachinaEngine\"}}";
+		for (const std::pair<uint32_t, std::string>& name : names)
+		{
+			AppendThreadName(registry, name.first, name.second);
+		}
+		registry.text += "\n],\"displayTimeUnit\":\"ns\",\"otherData\":{\"droppedEvents\":";
+		registry.text += std::to_string(registry.lastDropped);
+		registry.text += "}}\n";
+		std::fwrite(registry.text.data(), 1, registry.text.size(), registry.file);
+		registry.text.clear();
+		std::fclose(registry.file);
+		registry.file = nullptr;
+	}
+
+	void EngineTrace::SetThreadName(const char* name)
+	{
+		LocalThread& local = GetLocalThread();
+		local.name = name;
+		if (local.ring != nullptr)
+		{
+			Registry& registry = GetRegistry();
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			local.ring->name = name;
+		}
+	}
+
+	uint64_t EngineTrace::GetDroppedCount()
+	{
+		Registry& registry = GetRegistry();
+		std::lock_guard<std::mutex> control(registry.control);
+		if (!IsRunning())
+		{
+			return registry.lastDropped;
+		}
+
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		return ReadDropped(registry) - registry.droppedBaseline;
+	}
+
+	uint64_t EngineTrace::Now()
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count());
+	}
+
+	void EngineTrace::Record(const char* name, const char* category, uint64_t startNs, uint64_t endNs, const char* argName, uint64_t arg)
+	{
+		if (!IsRunning())
+		{
+			return;
+		}
+
+		Ring& ring = GetLocalRing();
+		uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+		if (tail - ring.head.load(std::memory_order_acquire) >= RING_CAPACITY)
+		{
+			ring.dropped.store(ring.dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			return;
+		}
+
+		ring.events[tail & (RING_CAPACITY - 1)] = TraceEvent{ name, category, argName, startNs, endNs - startNs, arg };
+		ring.tail.store(tail + 1, std::memory_order_release);
+
+		// A busy thread would fill its ring before the next flush; wake the
+		// flusher early. Harmless if it is already awake.
+		if (tail - ring.head.load(std::memory_order_relaxed) == RING_CAPACITY / 2)
+		{
+			GetRegistry().wake.notify_one();
+		}
+	}
+#endif
+
+} // namespace core
+} // namespace engine
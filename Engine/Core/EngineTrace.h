@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Set by the MACHINA_ENABLE_TRACING CMake option. At 0 Scope is empty and
+// Start always fails.
+#ifndef MACHINA_ENABLE_TRACING
+#define MACHINA_ENABLE_TRACING 0
+#endif
+
+namespace engine {
+namespace core {
+
+// Opt-in timeline of individual engine calls, written as Chrome trace-event
+// JSON that Perfetto (ui.perfetto.dev) and chrome://tracing open directly.
+// Between Start and Stop every Scope becomes one complete event on its
+// thread's track, so a slow tick can be read off call by call rather than
+// inferred from EngineMetrics' aggregates.
+//
+// Recording never blocks: each thread appends to its own fixed-size ring,
+// and a background thread drains all rings to the file every FLUSH_INTERVAL.
+// A ring that fills up between flushes drops the newest events and counts
+// them instead of stalling its thread. Outside a session a Scope costs one
+// relaxed atomic load.
+//
+// Only pointers to names, categories and argument names are recorded, so they
+// must be string literals (or otherwise outlive the session).
+class EngineTrace
+{
+public:
+	static constexpr bool IS_ENABLED = MACHINA_ENABLE_TRACING != 0;
+	// Events per thread between two flushes; a power of two.
+	static constexpr size_t RING_CAPACITY = 16384;
+	static constexpr std::chrono::milliseconds FLUSH_INTERVAL{ 10 };
+
+#if MACHINA_ENABLE_TRACING
+	// Creates `path` and starts recording. Fails if a session is already
+	// running or the file cannot be created.
+	static bool Start(const char* path);
+	// Writes out everything recorded so far and closes the file. A session
+	// still running at exit leaves the file truncated.
+	static void Stop();
+	static bool IsRunning() { return mIsRunning.load(std::memory_order_relaxed); }
+	// Labels the calling thread's track, in this and any later session.
+	static void SetThreadName(const char* name);
+	// Events dropped to full rings in the running or the last session.
+	static uint64_t GetDroppedCount();
+	// Nanoseconds on the trace clock.
+	static uint64_t Now();
+	static void Record(const char* name, const char* category, uint64_t startNs, uint64_t endNs, const char* argName, uint64_t arg);
+#else
+	static bool Start(const char*) { return false; }
+	static void Stop() {}
+	static bool IsRunning() { return false; }
+	static void SetThreadName(const char*) {}
+	static uint64_t GetDroppedCount() { return 0; }
+#endif
+
+	// Records its own lifetime as one event, with an optional integer
+	// argument shown in the event's details.
+	class Scope
+	{
+	public:
+#if MACHINA_ENABLE_TRACING
+		Scope(const char* name, const char* category)
+			: mName(name)
+			, mCategory(category)
+			, mArgName(nullptr)
+			, mArg(0)
+			, mStart(IsRunning() ? Now() : 0)
+		{
+		}
+
+		~Scope()
+		{
+			if (mStart != 0)
+			{
+				Record(mName, mCategory, mStart, Now(), mArgName, mArg);
+			}
+		}
+
+		void SetArg(const char* name, uint64_t value)
+		{
+			mArgName = name;
+			mArg = value;
+		}
+
+	private:
+		const char* mName;
+		const char* mCategory;
+		const char* mArgName;
+		uint64_t mArg;
+		uint64_t mStart;            // 0 when no session was running
+#else
+		Scope(const char*, const char*) {}
+
+		void SetArg(const char*, uint64_t) {}
+#endif
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+	};
+
+private:
+#if MACHINA_ENABLE_TRACING
+	static std::atomic<bool> mIsRunning;
+#endif
+};
+
+} // namespace core
+} // namespace engine
@@ -0,0 +1,83 @@
+#include <cstddef>
+
+#include "FixedBlockPool.h"
+
+namespace engine {
+namespace core {
+
+	FixedBlockPool::FixedBlockPool(size_t blockSize, size_t blocksPerSlab)
+		: mBlockSize(0)
+		, mBlocksPerSlab(blocksPerSlab > 0 ? blocksPerSlab : 1)
+		, mFreeList(nullptr)
+		, mLiveCount(0)
+	{
+		// Every block must be able to hold a free-list link and keep the
+		// alignment operator new would have given it.
+		const size_t alignment = alignof(std::max_align_t);
+		size_t size = blockSize < sizeof(FreeBlock) ? sizeof(FreeBlock) : blockSize;
+		mBlockSize = (size + alignment - 1) / alignment * alignment;
+	}
+
+	void* FixedBlockPool::Allocate()
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (mFreeList == nullptr)
+		{
+			AddSlab();
+		}
+
+		FreeBlock* block = mFreeList;
+		mFreeList = block->next;
+		++mLiveCount;
+		return block;
+	}
+
+	void FixedBlockPool::Deallocate(void* block)
+	{
+		if (block == nullptr)
+		{
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(mMutex);
+		FreeBlock* freed = static_cast<FreeBlock*>(block);
+		freed->next = mFreeList;
+		mFreeList = freed;
+		--mLiveCount;
+	}
+
+	size_t FixedBlockPool::GetBlockSize() const
+	{
+		return mBlockSize;
+	}
+
+	size_t FixedBlockPool::GetLiveCount() const
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		return mLiveCount;
+	}
+
+	size_t FixedBlockPool::GetCapacity() const
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		return mSlabs.size() * mBlocksPerSlab;
+	}
+
+	void FixedBlockPool::AddSlab()
+	{
+		std::unique_ptr<unsigned char[]> slab(new unsigned char[mBlockSize * mBlocksPerSlab]);
+
+		// Thread the new blocks onto the free list in address order.
+		unsigned char* base = slab.get();
+		for (size_t i = mBlocksPerSlab; i > 0; --i)
+		{
+			FreeBlock* block = reinterpret_cast<FreeBlock*>(base + (i - 1) * mBlockSize);
+			block->next = mFreeList;
+			mFreeList = block;
+		}
+
+		mSlabs.push_back(std::move(slab));
+	}
+
+} // namespace core
+} // namespace engine
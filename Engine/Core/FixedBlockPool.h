@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace engine {
+namespace core {
+
+// Allocator for many same-sized objects. Blocks are carved out of large slabs
+// and recycled through an intrusive free list, so steady-state allocation is a
+// pointer pop instead of a trip through the general-purpose heap. Slabs are
+// only returned to the system when the pool is destroyed.
+class FixedBlockPool
+{
+public:
+	FixedBlockPool(size_t blockSize, size_t blocksPerSlab);
+	~FixedBlockPool() = default;
+
+	FixedBlockPool(const FixedBlockPool&) = delete;
+	FixedBlockPool& operator=(const FixedBlockPool&) = delete;
+
+	void* Allocate();
+	void Deallocate(void* block);
+
+	size_t GetBlockSize() const;
+	size_t GetLiveCount() const;
+	size_t GetCapacity() const;
+
+private:
+	struct FreeBlock
+	{
+		FreeBlock* next;
+	};
+
+	void AddSlab();
+
+	size_t mBlockSize;
+	size_t mBlocksPerSlab;
+	FreeBlock* mFreeList;
+	size_t mLiveCount;
+	std::vector<std::unique_ptr<unsigned char[]>> mSlabs;
+	mutable std::mutex mMutex;
+};
+
+} // namespace core
+} // namespace engine
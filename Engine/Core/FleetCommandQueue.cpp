@@ -0,0 +1,51 @@
+#include "FleetCommandQueue.h"
+
+namespace engine {
+namespace core {
+
+	FleetCommandQueue::FleetCommandQueue()
+		: mHead(nullptr)
+	{
+	}
+
+	FleetCommandQueue::~FleetCommandQueue()
+	{
+		FleetCommand* command = TakeAll();
+		while (command != nullptr)
+		{
+			std::unique_ptr<FleetCommand> owned(command);
+			command = command->next;
+		}
+	}
+
+	void FleetCommandQueue::Push(std::unique_ptr<FleetCommand> command)
+	{
+		FleetCommand* node = command.release();
+		node->next = mHead.load(std::memory_order_relaxed);
+		while (!mHead.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	bool FleetCommandQueue::IsEmpty() const
+	{
+		return mHead.load(std::memory_order_acquire) == nullptr;
+	}
+
+	FleetCommand* FleetCommandQueue::TakeAll()
+	{
+		FleetCommand* newest = mHead.exchange(nullptr, std::memory_order_acquire);
+
+		FleetCommand* oldest = nullptr;
+		while (newest != nullptr)
+		{
+			FleetCommand* next = newest->next;
+			newest->next = oldest;
+			oldest = newest;
+			newest = next;
+		}
+		return oldest;
+	}
+
+} // namespace core
+} // namespace engine
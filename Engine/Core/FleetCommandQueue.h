@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "VehicleHandle.h"
+#include "../Interfaces/IPassenger.h"
+#include "../Vehicles/Vehicle.h"
+
+namespace engine {
+namespace core {
+
+class DeusExMachina;
+
+// One queued fleet mutation; see DeusExMachina::Enqueue*.
+struct FleetCommand
+{
+	enum class Kind : uint8_t
+	{
+		ADD_VEHICLE,
+		REMOVE_VEHICLE,
+		ADD_PASSENGER,
+		REMOVE_PASSENGER,
+	};
+
+	// Adds through the typed or untyped AddVehicle, as the producer chose.
+	using AddFunction = bool (*)(DeusExMachina& engine, std::unique_ptr<vehicles::Vehicle> vehicle);
+
+	FleetCommand* next;
+	Kind kind;
+	VehicleHandle handle;
+	unsigned int passengerIndex;
+	AddFunction add;
+	std::unique_ptr<vehicles::Vehicle> vehicle;
+	std::unique_ptr<const interfaces::IPassenger> passenger;
+};
+
+// Multi-producer, single-consumer stack of commands. Push is a lock-free
+// CAS onto the head; the consumer takes the whole stack with one exchange
+// and reverses it, so producers and the consumer never wait on each other.
+class FleetCommandQueue
+{
+public:
+	FleetCommandQueue();
+	~FleetCommandQueue();
+
+	FleetCommandQueue(const FleetCommandQueue&) = delete;
+	FleetCommandQueue& operator=(const FleetCommandQueue&) = delete;
+
+	// Any thread.
+	void Push(std::unique_ptr<FleetCommand> command);
+	bool IsEmpty() const;
+
+	// Consumer only. Every command pushed so far, oldest first, as a list
+	// linked through `next` that the caller now owns; nullptr when empty.
+	FleetCommand* TakeAll();
+
+private:
+	std::atomic<FleetCommand*> mHead;
+};
+
+} // namespace core
+} // namespace engine
@@ -0,0 +1,392 @@
+#include <cstring>
+
+#include "FleetJournal.h"
+#include "SnapshotStream.h"
+#include "VehicleTypeRegistry.h"
+
+namespace engine {
+namespace core {
+
+using engine::interfaces::IPassenger;
+using engine::vehicles::Vehicle;
+
+	FleetJournal::FleetJournal(const VehicleTypeRegistry& types)
+		: mTypes(types)
+		, mHasFailed(false)
+		, mIsOpen(false)
+		, mIsSuspended(false)
+		, mHasPending(false)
+		, mIsStopping(false)
+		, mHasWriteFailed(false)
+	{
+	}
+
+	FleetJournal::~FleetJournal()
+	{
+		Close();
+	}
+
+	bool FleetJournal::Open(const char* path)
+	{
+		Close();
+
+		mFile.open(path, std::ios::binary | std::ios::trunc);
+		if (!mFile)
+		{
+			return false;
+		}
+
+		mIsTypeDefined.assign(mTypes.GetTypeCount(), false);
+		mNameIds.clear();
+		mDirtyVehicles.clear();
+		mHasFailed = false;
+		mIsSuspended = false;
+		mHasPending = false;
+		mIsStopping = false;
+		mHasWriteFailed = false;
+		mActive.clear();
+		mActive.reserve(BUFFER_WORDS);
+
+		uint32_t magic[2];
+		std::memcpy(magic, MAGIC, sizeof(magic));
+		Write(magic[0]);
+		Write(magic[1]);
+		Write(VERSION);
+		Write(BYTE_ORDER_MARK);
+
+		mIsOpen = true;
+		mWriter = std::thread(&FleetJournal::WriterLoop, this);
+		return true;
+	}
+
+	void FleetJournal::Close()
+	{
+		if (!mIsOpen)
+		{
+			return;
+		}
+
+		FlushDirtyStates();
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			Submit(lock);
+			mIsStopping = true;
+		}
+		mWriterWake.notify_one();
+		mWriter.join();
+
+		mFile.close();
+		mIsOpen = false;
+	}
+
+	void FleetJournal::Flush()
+	{
+		if (!mIsOpen)
+		{
+			return;
+		}
+
+		FlushDirtyStates();
+		std::unique_lock<std::mutex> lock(mMutex);
+		Submit(lock);
+		mWriterDone.wait(lock, [this]() { return !mHasPending; });
+	}
+
+	bool FleetJournal::IsOpen() const
+	{
+		return mIsOpen;
+	}
+
+	bool FleetJournal::HasFailed() const
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		return mHasFailed || mHasWriteFailed;
+	}
+
+	void FleetJournal::RecordAddVehicle(const Vehicle& vehicle)
+	{
+		if (!IsRecording())
+		{
+			return;
+		}
+		FlushDirtyStates();
+
+		uint32_t type = mTypes.FindType(vehicle);
+		if (type == VehicleTypeRegistry::NONE)
+		{
+			mHasFailed = true;
+			return;
+		}
+		uint32_t journalType = DefineType(type);
+
+		unsigned int passengerCount = vehicle.GetPassengersCount();
+		std::vector<uint32_t> names(passengerCount);
+		for (unsigned int p = 0; p < passengerCount; ++p)
+		{
+			names[p] = DefineName(vehicle.GetPassenger(p)->GetName());
+		}
+
+		mStateWords.clear();
+		SnapshotWriter writer(mStateWords);
+		vehicle.WriteSnapshot(writer);
+
+		BeginRecord(RecordKind::ADD_VEHICLE, 7 + mStateWords.size() + 2 * static_cast<size_t>(passengerCount));
+		Write(journalType);
+		Write(vehicle.GetMaxPassengersCount());
+		Write(vehicle.GetOdo());
+		Write(vehicle.GetMoveTime());
+		Write(vehicle.GetIdleTime());
+		Write(static_cast<uint32_t>(mStateWords.size()));
+		for (uint32_t word : mStateWords)
+		{
+			Write(word);
+		}
+		Write(passengerCount);
+		for (unsigned int p = 0; p < passengerCount; ++p)
+		{
+			Write(names[p]);
+			Write(vehicle.GetPassenger(p)->GetWeight());
+		}
+		EndRecord();
+	}
+
+	void FleetJournal::RecordRemoveVehicle(uint32_t denseIndex)
+	{
+		if (!IsRecording())
+		{
+			return;
+		}
+		FlushDirtyStates();
+
+		BeginRecord(RecordKind::REMOVE_VEHICLE, 1);
+		Write(denseIndex);
+		EndRecord();
+	}
+
+	void FleetJournal::RecordAddPassenger(uint32_t denseIndex, const IPassenger& passenger)
+	{
+		if (!IsRecording())
+		{
+			return;
+		}
+		FlushDirtyStates();
+
+		uint32_t name = DefineName(passenger.GetName());
+		BeginRecord(RecordKind::ADD_PASSENGER, 3);
+		Write(denseIndex);
+		Write(name);
+		Write(passenger.GetWeight());
+		EndRecord();
+	}
+
+	void FleetJournal::RecordRemovePassenger(uint32_t denseIndex, uint32_t passengerIndex)
+	{
+		if (!IsRecording())
+		{
+			return;
+		}
+		FlushDirtyStates();
+
+		BeginRecord(RecordKind::REMOVE_PASSENGER, 2);
+		Write(denseIndex);
+		Write(passengerIndex);
+		EndRecord();
+	}
+
+	void FleetJournal::RecordReleaseAllPassengers(uint32_t denseIndex)
+	{
+		if (!IsRecording())
+		{
+			return;
+		}
+		FlushDirtyStates();
+
+		BeginRecord(RecordKind::RELEASE_ALL_PASSENGERS, 1);
+		Write(denseIndex);
+		EndRecord();
+	}
+
+	void FleetJournal::RecordTravelState(uint32_t denseIndex, unsigned int odo, unsigned int moveTime, unsigned int idleTime)
+	{
+		if (!IsRecording())
+		{
+			return;
+		}
+		FlushDirtyStates();
+
+		BeginRecord(RecordKind::SET_TRAVEL_STATE, 4);
+		Write(denseIndex);
+		Write(odo);
+		Write(moveTime);
+		Write(idleTime);
+		EndRecord();
+	}
+
+	void FleetJournal::RecordTravel(const TravelContext& context)
+	{
+		if (!IsRecording())
+		{
+			return;
+		}
+		FlushDirtyStates();
+
+		uint32_t weatherBits;
+		static_assert(sizeof(weatherBits) == sizeof(context.weatherMultiplier), "float must be 32 bits");
+		std::memcpy(&weatherBits, &context.weatherMultiplier, sizeof(weatherBits));
+
+		BeginRecord(RecordKind::TRAVEL, 3);
+		Write(context.hours);
+		Write(weatherBits);
+		Write(context.isEmergency ? 1 : 0);
+		EndRecord();
+	}
+
+	void FleetJournal::MarkVehicleStateDirty(const Vehicle& vehicle)
+	{
+		if (!IsRecording())
+		{
+			return;
+		}
+
+		if (mDirtyVehicles.empty() || mDirtyVehicles.back() != &vehicle)
+		{
+			mDirtyVehicles.push_back(&vehicle);
+		}
+	}
+
+	void FleetJournal::SetSuspended(bool isSuspended)
+	{
+		mIsSuspended = isSuspended;
+	}
+
+	bool FleetJournal::IsRecording() const
+	{
+		return mIsOpen && !mHasFailed && !mIsSuspended;
+	}
+
+	void FleetJournal::FlushDirtyStates()
+	{
+		if (mDirtyVehicles.empty())
+		{
+			return;
+		}
+
+		for (const Vehicle* vehicle : mDirtyVehicles)
+		{
+			mStateWords.clear();
+			SnapshotWriter writer(mStateWords);
+			vehicle->WriteSnapshot(writer);
+
+			BeginRecord(RecordKind::SET_VEHICLE_STATE, 1 + mStateWords.size());
+			Write(vehicle->mTravelSlot);
+			for (uint32_t word : mStateWords)
+			{
+				Write(word);
+			}
+			EndRecord();
+		}
+		mDirtyVehicles.clear();
+	}
+
+	uint32_t FleetJournal::DefineType(uint32_t type)
+	{
+		// Journal type ids are the registry's own indices.
+		if (type >= mIsTypeDefined.size())
+		{
+			mIsTypeDefined.resize(mTypes.GetTypeCount(), false);
+		}
+
+		if (!mIsTypeDefined[type])
+		{
+			mIsTypeDefined[type] = true;
+			WriteString(RecordKind::DEFINE_TYPE, type, mTypes.GetTypeName(type));
+		}
+		return type;
+	}
+
+	uint32_t FleetJournal::DefineName(const std::string& name)
+	{
+		std::unordered_map<std::string, uint32_t>::const_iterator found = mNameIds.find(name);
+		if (found != mNameIds.end())
+		{
+			return found->second;
+		}
+
+		uint32_t id = static_cast<uint32_t>(mNameIds.size());
+		mNameIds.emplace(name, id);
+		WriteString(RecordKind::DEFINE_NAME, id, name);
+		return id;
+	}
+
+	void FleetJournal::WriteString(RecordKind kind, uint32_t id, const std::string& value)
+	{
+		size_t valueWords = (value.size() + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+		BeginRecord(kind, 2 + valueWords);
+		Write(id);
+		Write(static_cast<uint32_t>(value.size()));
+
+		size_t first = mActive.size();
+		mActive.resize(first + valueWords, 0);
+		if (!value.empty())
+		{
+			std::memcpy(mActive.data() + first, value.data(), value.size());
+		}
+		EndRecord();
+	}
+
+	void FleetJournal::BeginRecord(RecordKind kind, size_t payloadWords)
+	{
+		Write(static_cast<uint32_t>(kind) | static_cast<uint32_t>(payloadWords << 8));
+	}
+
+	void FleetJournal::EndRecord()
+	{
+		if (mActive.size() < BUFFER_WORDS)
+		{
+			return;
+		}
+
+		std::unique_lock<std::mutex> lock(mMutex);
+		Submit(lock);
+	}
+
+	void FleetJournal::Submit(std::unique_lock<std::mutex>& lock)
+	{
+		if (mActive.empty())
+		{
+			return;
+		}
+
+		mWriterDone.wait(lock, [this]() { return !mHasPending; });
+		mActive.swap(mPending);
+		mHasPending = true;
+		mActive.clear();
+		mWriterWake.notify_one();
+	}
+
+	void FleetJournal::WriterLoop()
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		for (;;)
+		{
+			mWriterWake.wait(lock, [this]() { return mHasPending || mIsStopping; });
+			if (!mHasPending)
+			{
+				break;
+			}
+
+			lock.unlock();
+			mFile.write(reinterpret_cast<const char*>(mPending.data()), static_cast<std::streamsize>(mPending.size() * sizeof(uint32_t)));
+			mFile.flush();
+			bool isGood = static_cast<bool>(mFile);
+			lock.lock();
+
+			mHasWriteFailed = mHasWriteFailed || !isGood;
+			mPending.clear();
+			mHasPending = false;
+			mWriterDone.notify_all();
+		}
+	}
+
+} // namespace core
+} // namespace engine
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "TravelContext.h"
+
+namespace engine {
+namespace interfaces {
+class IPassenger;
+} // namespace interfaces
+
+namespace vehicles {
+class Vehicle;
+} // namespace vehicles
+
+namespace core {
+
+class VehicleTypeRegistry;
+
+// Append-only binary log of every mutation made to a DeusExMachina fleet,
+// written so that JournalReplay can rebuild the same fleet later.
+//
+// The file is an 8-byte magic, a version and a byte-order mark followed by
+// records of 32-bit words. Each record starts with a word holding its kind
+// (low 8 bits) and payload length in words (upper 24 bits). Vehicle types and
+// passenger names are written once as DEFINE records and referred to by id
+// afterwards. Vehicles are addressed by dense index, which replay reproduces
+// exactly since it performs the same adds and swap-removes.
+//
+// Recording only appends words to an in-memory buffer. Full buffers are
+// handed to a background thread that owns the file, so the tick never waits
+// on I/O. It only waits if the writer falls a whole buffer behind.
+class FleetJournal
+{
+public:
+	enum class RecordKind : uint8_t
+	{
+		DEFINE_TYPE = 1,            // id, length, bytes
+		DEFINE_NAME,                // id, length, bytes
+		ADD_VEHICLE,                // type, maxPassengers, odo, move, idle, stateCount, state..., passengerCount, (name, weight)...
+		REMOVE_VEHICLE,             // dense index
+		ADD_PASSENGER,              // dense index, name, weight
+		REMOVE_PASSENGER,           // dense index, passenger index
+		RELEASE_ALL_PASSENGERS,     // dense index
+		SET_TRAVEL_STATE,           // dense index, odo, move, idle
+		SET_VEHICLE_STATE,          // dense index, state...
+		TRAVEL,                     // hours, weather (float bits), emergency
+	};
+
+	static constexpr uint32_t VERSION = 1;
+	static constexpr char MAGIC[8] = { 'M', 'A', 'C', 'H', 'J', 'R', 'N', 'L' };
+	static constexpr uint32_t BYTE_ORDER_MARK = 0x01020304u;
+
+	// `types` must outlive the journal.
+	explicit FleetJournal(const VehicleTypeRegistry& types);
+	~FleetJournal();
+
+	FleetJournal(const FleetJournal&) = delete;
+	FleetJournal& operator=(const FleetJournal&) = delete;
+
+	bool Open(const char* path);
+	// Writes out everything recorded so far and stops the writer thread.
+	void Close();
+	// Blocks until everything recorded so far has been handed to the OS.
+	void Flush();
+	bool IsOpen() const;
+	// True once a record could not be encoded (an unregistered vehicle type)
+	// or the file could not be written; the journal stops recording then, as
+	// a replay past that point would diverge.
+	bool HasFailed() const;
+
+	// Called by DeusExMachina and bound vehicles on the engine thread.
+	void RecordAddVehicle(const vehicles::Vehicle& vehicle);
+	void RecordRemoveVehicle(uint32_t denseIndex);
+	void RecordAddPassenger(uint32_t denseIndex, const interfaces::IPassenger& passenger);
+	void RecordRemovePassenger(uint32_t denseIndex, uint32_t passengerIndex);
+	void RecordReleaseAllPassengers(uint32_t denseIndex);
+	void RecordTravelState(uint32_t denseIndex, unsigned int odo, unsigned int moveTime, unsigned int idleTime);
+	void RecordTravel(const TravelContext& context);
+	// Type-specific state (Vehicle::WriteSnapshot) changed. Captured lazily,
+	// just before the next record, so a burst of changes costs one record.
+	void MarkVehicleStateDirty(const vehicles::Vehicle& vehicle);
+	// Set around the body of a Travel: replay re-runs the whole travel, so
+	// anything vehicles change while it runs (possibly from worker threads)
+	// is not recorded.
+	void SetSuspended(bool isSuspended);
+
+private:
+	static constexpr size_t BUFFER_WORDS = 16 * 1024;
+
+	bool IsRecording() const;
+	void FlushDirtyStates();
+	uint32_t DefineType(uint32_t type);
+	uint32_t DefineName(const std::string& name);
+	void WriteString(RecordKind kind, uint32_t id, const std::string& value);
+	void BeginRecord(RecordKind kind, size_t payloadWords);
+	void Write(uint32_t word) { mActive.push_back(word); }
+	void EndRecord();
+	void Submit(std::unique_lock<std::mutex>& lock);
+	void WriterLoop();
+
+	const VehicleTypeRegistry& mTypes;
+	std::vector<bool> mIsTypeDefined;
+	std::unordered_map<std::string, uint32_t> mNameIds;
+	std::vector<const vehicles::Vehicle*> mDirtyVehicles;
+	std::vector<uint32_t> mStateWords;
+	bool mHasFailed;
+	bool mIsOpen;
+	bool mIsSuspended;
+
+	// mActive belongs to the recording thread. mPending is handed to the
+	// writer under mMutex and owned by it until mHasPending clears.
+	std::vector<uint32_t> mActive;
+	std::vector<uint32_t> mPending;
+	std::ofstream mFile;
+	std::thread mWriter;
+	mutable std::mutex mMutex;
+	std::condition_variable mWriterWake;
+	std::condition_variable mWriterDone;
+	bool mHasPending;
+	bool mIsStopping;
+	bool mHasWriteFailed;
+};
+
+} // namespace core
+} // namespace engine
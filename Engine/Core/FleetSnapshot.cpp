@@ -0,0 +1,395 @@
+#include <cstring>
+#include <fstream>
+#include <string_view>
+
+#include "FleetSnapshot.h"
+#include "MappedFile.h"
+#include "SnapshotStream.h"
+
+namespace engine {
+namespace core {
+
+using engine::interfaces::IPassenger;
+using engine::vehicles::Vehicle;
+
+namespace {
+
+	constexpr char SNAPSHOT_MAGIC[8] = { 'M', 'A', 'C', 'H', 'F', 'L', 'T', '\0' };
+	constexpr uint32_t BYTE_ORDER_MARK = 0x01020304u;
+	constexpr size_t SECTION_ALIGNMENT = 8;
+
+	// File layout: header, then each section at an 8-byte aligned offset.
+	// String tables are (uint32 length, bytes, padding to 4) runs.
+	struct SnapshotHeader
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t byteOrder;
+		uint32_t vehicleCount;
+		uint32_t typeCount;
+		uint32_t nameCount;
+		uint32_t passengerCount;
+		uint32_t paramCount;
+		uint32_t reserved;
+		uint64_t typeOffset;
+		uint64_t nameOffset;
+		uint64_t odoOffset;
+		uint64_t moveTimeOffset;
+		uint64_t idleTimeOffset;
+		uint64_t vehicleOffset;
+		uint64_t passengerOffset;
+		uint64_t paramOffset;
+		uint64_t fileSize;
+	};
+
+	struct VehicleRecord
+	{
+		uint32_t type;
+		uint32_t maxPassengersCount;
+		uint32_t firstPassenger;
+		uint32_t passengerCount;
+		uint32_t firstParam;
+		uint32_t paramCount;
+	};
+
+	struct PassengerRecord
+	{
+		uint32_t name;
+		uint32_t weight;
+	};
+
+	class ByteWriter
+	{
+	public:
+		uint64_t Align()
+		{
+			mBytes.resize((mBytes.size() + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT, 0);
+			return mBytes.size();
+		}
+
+		void Append(const void* data, size_t size)
+		{
+			if (size == 0)
+			{
+				return;
+			}
+			const uint8_t* bytes = static_cast<const uint8_t*>(data);
+			mBytes.insert(mBytes.end(), bytes, bytes + size);
+		}
+
+		uint64_t AppendSection(const void* data, size_t size)
+		{
+			uint64_t offset = Align();
+			Append(data, size);
+			return offset;
+		}
+
+		uint64_t AppendStrings(const std::vector<std::string>& strings)
+		{
+			uint64_t offset = Align();
+			for (const std::string& value : strings)
+			{
+				uint32_t length = static_cast<uint32_t>(value.size());
+				Append(&length, sizeof(length));
+				Append(value.data(), value.size());
+				mBytes.resize((mBytes.size() + 3) / 4 * 4, 0);
+			}
+			return offset;
+		}
+
+		std::vector<uint8_t>& GetBytes() { return mBytes; }
+
+	private:
+		std::vector<uint8_t> mBytes;
+	};
+
+	bool IsSectionValid(const SnapshotHeader& header, uint64_t offset, uint64_t count, size_t elementSize)
+	{
+		if (offset % SECTION_ALIGNMENT != 0 || offset > header.fileSize)
+		{
+			return false;
+		}
+		return count <= (header.fileSize - offset) / elementSize;
+	}
+
+	// Walks a string table; false if it runs past the end of the file.
+	bool ReadStrings(const uint8_t* data, const SnapshotHeader& header, uint64_t offset, uint32_t count, std::vector<std::string_view>& outStrings)
+	{
+		// Every entry takes at least its 4-byte length.
+		if (!IsSectionValid(header, offset, count, sizeof(uint32_t)))
+		{
+			return false;
+		}
+
+		outStrings.clear();
+		outStrings.reserve(count);
+		uint64_t position = offset;
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			uint32_t length;
+			if (header.fileSize - position < sizeof(length))
+			{
+				return false;
+			}
+			std::memcpy(&length, data + position, sizeof(length));
+			position += sizeof(length);
+
+			if (header.fileSize - position < length)
+			{
+				return false;
+			}
+			outStrings.emplace_back(reinterpret_cast<const char*>(data + position), length);
+			position += (static_cast<uint64_t>(length) + 3) / 4 * 4;
+			if (position > header.fileSize)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+} // namespace
+
+	FleetSnapshot::FleetSnapshot(const VehicleTypeRegistry& types)
+		: mTypes(types)
+	{
+	}
+
+	bool FleetSnapshot::Save(const DeusExMachina& engine, const char* path) const
+	{
+		const size_t vehicleCount = engine.mVehicles.GetSize();
+
+		// Only the types and names actually in use are written, renumbered in
+		// order of first appearance.
+		std::vector<uint32_t> fileTypeByEntry(mTypes.GetTypeCount(), UINT32_MAX);
+		std::vector<std::string> typeNames;
+		std::unordered_map<std::string_view, uint32_t> fileNameByName;
+		std::vector<std::string> names;
+
+		std::vector<VehicleRecord> vehicles;
+		std::vector<PassengerRecord> passengers;
+		std::vector<uint32_t> params;
+		vehicles.reserve(vehicleCount);
+
+		for (size_t i = 0; i < vehicleCount; ++i)
+		{
+			const Vehicle* vehicle = engine.mVehicles.Get(static_cast<unsigned int>(i));
+			uint32_t type = mTypes.FindType(*vehicle);
+			if (type == VehicleTypeRegistry::NONE)
+			{
+				return false;
+			}
+
+			uint32_t& fileType = fileTypeByEntry[type];
+			if (fileType == UINT32_MAX)
+			{
+				fileType = static_cast<uint32_t>(typeNames.size());
+				typeNames.push_back(mTypes.GetTypeName(type));
+			}
+
+			VehicleRecord record;
+			record.type = fileType;
+			record.maxPassengersCount = vehicle->GetMaxPassengersCount();
+			record.firstPassenger = static_cast<uint32_t>(passengers.size());
+			record.passengerCount = vehicle->GetPassengersCount();
+			record.firstParam = static_cast<uint32_t>(params.size());
+
+			for (unsigned int p = 0; p < record.passengerCount; ++p)
+			{
+				const IPassenger* passenger = vehicle->GetPassenger(p);
+				const std::string& name = passenger->GetName();
+				std::unordered_map<std::string_view, uint32_t>::const_iterator nameFound = fileNameByName.find(name);
+				uint32_t fileName;
+				if (nameFound != fileNameByName.end())
+				{
+					fileName = nameFound->second;
+				}
+				else
+				{
+					fileName = static_cast<uint32_t>(names.size());
+					// Keyed by the passenger's own string, which outlives this call.
+					fileNameByName.emplace(name, fileName);
+					names.push_back(name);
+				}
+				passengers.push_back(PassengerRecord{ fileName, passenger->GetWeight() });
+			}
+
+			SnapshotWriter writer(params);
+			vehicle->WriteSnapshot(writer);
+			record.paramCount = static_cast<uint32_t>(params.size()) - record.firstParam;
+			vehicles.push_back(record);
+		}
+
+		SnapshotHeader header;
+		std::memset(&header, 0, sizeof(header));
+		std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+		header.version = VERSION;
+		header.byteOrder = BYTE_ORDER_MARK;
+		header.vehicleCount = static_cast<uint32_t>(vehicleCount);
+		header.typeCount = static_cast<uint32_t>(typeNames.size());
+		header.nameCount = static_cast<uint32_t>(names.size());
+		header.passengerCount = static_cast<uint32_t>(passengers.size());
+		header.paramCount = static_cast<uint32_t>(params.size());
+
+		// The columns are written as they stand; bring a LAZY fleet up to date.
+		engine.SettleTravelState();
+		const TravelStateStore& travelState = engine.mTravelState;
+		const size_t columnSize = vehicleCount * sizeof(unsigned int);
+
+		ByteWriter out;
+		out.Append(&header, sizeof(header));
+		header.typeOffset = out.AppendStrings(typeNames);
+		header.nameOffset = out.AppendStrings(names);
+		header.odoOffset = out.AppendSection(travelState.GetOdoData(), columnSize);
+		header.moveTimeOffset = out.AppendSection(travelState.GetMoveTimeData(), columnSize);
+		header.idleTimeOffset = out.AppendSection(travelState.GetIdleTimeData(), columnSize);
+		header.vehicleOffset = out.AppendSection(vehicles.data(), vehicles.size() * sizeof(VehicleRecord));
+		header.passengerOffset = out.AppendSection(passengers.data(), passengers.size() * sizeof(PassengerRecord));
+		header.paramOffset = out.AppendSection(params.data(), params.size() * sizeof(uint32_t));
+		header.fileSize = out.Align();
+		std::memcpy(out.GetBytes().data(), &header, sizeof(header));
+
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file)
+		{
+			return false;
+		}
+		file.write(reinterpret_cast<const char*>(out.GetBytes().data()), static_cast<std::streamsize>(out.GetBytes().size()));
+		return static_cast<bool>(file);
+	}
+
+	bool FleetSnapshot::Restore(DeusExMachina& engine, const char* path) const
+	{
+		if (!mTypes.HasPassengerFactory())
+		{
+			return false;
+		}
+
+		MappedFile file;
+		if (!file.Open(path) || file.GetSize() < sizeof(SnapshotHeader))
+		{
+			return false;
+		}
+
+		const uint8_t* data = file.GetData();
+		SnapshotHeader header;
+		std::memcpy(&header, data, sizeof(header));
+		if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0
+			|| header.version != VERSION
+			|| header.byteOrder != BYTE_ORDER_MARK
+			|| header.fileSize != file.GetSize())
+		{
+			return false;
+		}
+
+		if (!IsSectionValid(header, header.odoOffset, header.vehicleCount, sizeof(unsigned int))
+			|| !IsSectionValid(header, header.moveTimeOffset, header.vehicleCount, sizeof(unsigned int))
+			|| !IsSectionValid(header, header.idleTimeOffset, header.vehicleCount, sizeof(unsigned int))
+			|| !IsSectionValid(header, header.vehicleOffset, header.vehicleCount, sizeof(VehicleRecord))
+			|| !IsSectionValid(header, header.passengerOffset, header.passengerCount, sizeof(PassengerRecord))
+			|| !IsSectionValid(header, header.paramOffset, header.paramCount, sizeof(uint32_t)))
+		{
+			return false;
+		}
+
+		std::vector<std::string_view> strings;
+		if (!ReadStrings(data, header, header.typeOffset, header.typeCount, strings))
+		{
+			return false;
+		}
+
+		std::vector<uint32_t> entryByFileType(header.typeCount);
+		for (uint32_t i = 0; i < header.typeCount; ++i)
+		{
+			entryByFileType[i] = mTypes.FindType(strings[i]);
+			if (entryByFileType[i] == VehicleTypeRegistry::NONE)
+			{
+				return false;
+			}
+		}
+
+		if (!ReadStrings(data, header, header.nameOffset, header.nameCount, strings))
+		{
+			return false;
+		}
+
+		NameTable* nameTable = NameTable::GetInstance();
+		std::vector<NameTable::NameId> nameIds(header.nameCount);
+		for (uint32_t i = 0; i < header.nameCount; ++i)
+		{
+			nameIds[i] = nameTable->Intern(strings[i]);
+		}
+
+		// Sections are 8-byte aligned within an 8-byte aligned mapping, so the
+		// records are used in place.
+		const VehicleRecord* records = reinterpret_cast<const VehicleRecord*>(data + header.vehicleOffset);
+		const PassengerRecord* passengers = reinterpret_cast<const PassengerRecord*>(data + header.passengerOffset);
+		const uint32_t* params = reinterpret_cast<const uint32_t*>(data + header.paramOffset);
+
+		std::vector<std::unique_ptr<Vehicle>> vehicles;
+		vehicles.reserve(header.vehicleCount);
+		for (uint32_t i = 0; i < header.vehicleCount; ++i)
+		{
+			const VehicleRecord& record = records[i];
+			if (record.type >= header.typeCount
+				|| record.firstPassenger > header.passengerCount
+				|| record.passengerCount > header.passengerCount - record.firstPassenger
+				|| record.firstParam > header.paramCount
+				|| record.paramCount > header.paramCount - record.firstParam)
+			{
+				return false;
+			}
+
+			// A passenger limit larger than the whole file can only come from a
+			// corrupt record.
+			if (record.maxPassengersCount > header.fileSize / sizeof(uint32_t))
+			{
+				return false;
+			}
+
+			std::unique_ptr<Vehicle> vehicle = mTypes.CreateVehicle(entryByFileType[record.type], record.maxPassengersCount);
+			if (vehicle == nullptr || vehicle->GetMaxPassengersCount() != record.maxPassengersCount)
+			{
+				return false;
+			}
+
+			SnapshotReader reader(params + record.firstParam, record.paramCount);
+			if (!vehicle->ReadSnapshot(reader) || !reader.IsAtEnd())
+			{
+				return false;
+			}
+
+			vehicle->mPassengers.Reserve(record.passengerCount);
+			for (uint32_t p = 0; p < record.passengerCount; ++p)
+			{
+				const PassengerRecord& passenger = passengers[record.firstPassenger + p];
+				if (passenger.name >= header.nameCount
+					|| !vehicle->AddPassenger(mTypes.CreatePassenger(nameIds[passenger.name], passenger.weight)))
+				{
+					return false;
+				}
+			}
+
+			vehicles.push_back(std::move(vehicle));
+		}
+
+		for (uint32_t entry : entryByFileType)
+		{
+			mTypes.RegisterBucket(entry, engine);
+		}
+
+		engine.ReserveVehicles(engine.GetVehicleCount() + vehicles.size());
+		unsigned int slot = engine.mTravelState.AllocateBulk(
+			reinterpret_cast<const unsigned int*>(data + header.odoOffset),
+			reinterpret_cast<const unsigned int*>(data + header.moveTimeOffset),
+			reinterpret_cast<const unsigned int*>(data + header.idleTimeOffset),
+			vehicles.size());
+		for (std::unique_ptr<Vehicle>& vehicle : vehicles)
+		{
+			engine.AdoptVehicle(std::move(vehicle), slot++);
+		}
+		return true;
+	}
+
+} // namespace core
+} // namespace engine
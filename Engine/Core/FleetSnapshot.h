@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+
+#include "DeusExMachina.h"
+#include "VehicleTypeRegistry.h"
+
+namespace engine {
+namespace core {
+
+// Versioned binary checkpoint of a whole DeusExMachina fleet: vehicle types,
+// passenger limits, type-specific state (Vehicle::WriteSnapshot), travel state
+// and passenger manifests.
+//
+// The file is laid out for restore rather than parsing: the travel state is
+// stored as the engine's own columns and copied in wholesale, vehicles and
+// passengers are fixed-size records read in place from the mapped file, and
+// each distinct passenger name is interned once. The format is native-endian;
+// a byte-order mark rejects files written on a different architecture.
+//
+// The engine knows no concrete vehicle types; they are written and rebuilt
+// through the Game layer's VehicleTypeRegistry.
+class FleetSnapshot
+{
+public:
+	static constexpr uint32_t VERSION = 1;
+
+	// `types` must outlive the snapshot.
+	explicit FleetSnapshot(const VehicleTypeRegistry& types);
+	~FleetSnapshot() = default;
+
+	FleetSnapshot(const FleetSnapshot&) = delete;
+	FleetSnapshot& operator=(const FleetSnapshot&) = delete;
+
+	// Fails if the fleet holds a vehicle of an unregistered type.
+	bool Save(const DeusExMachina& engine, const char* path) const;
+	// Appends the snapshot's vehicles to `engine` in their saved order. The
+	// file is fully validated and every vehicle built before the engine is
+	// touched, so a failed restore leaves it unchanged.
+	bool Restore(DeusExMachina& engine, const char* path) const;
+
+private:
+	const VehicleTypeRegistry& mTypes;
+};
+
+} // namespace core
+} // namespace engine
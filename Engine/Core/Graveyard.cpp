@@ -0,0 +1,224 @@
+#include "Graveyard.h"
+#include "EngineMetrics.h"
+#include "EngineTrace.h"
+#include "../Vehicles/Vehicle.h"
+
+namespace engine {
+namespace core {
+
+using interfaces::IPassenger;
+using vehicles::Vehicle;
+
+	Graveyard::Graveyard()
+		: mMode(ReclaimMode::BACKGROUND)
+		, mIsFlushRequested(false)
+		, mIsStopping(false)
+		, mBuriedVehicles(0)
+		, mBuriedPassengers(0)
+		, mReclaimedVehicles(0)
+		, mReclaimedPassengers(0)
+		, mReclaimTime(std::chrono::steady_clock::duration::zero())
+	{
+	}
+
+	Graveyard::~Graveyard()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mIsStopping = true;
+		}
+		mWakeCondition.notify_one();
+		if (mReclaimer.joinable())
+		{
+			mReclaimer.join();
+		}
+		ReclaimAll();
+	}
+
+	void Graveyard::SetReclaimMode(ReclaimMode mode)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mMode = mode;
+	}
+
+	Graveyard::ReclaimMode Graveyard::GetReclaimMode() const
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		return mMode;
+	}
+
+	void Graveyard::Bury(std::unique_ptr<Vehicle> vehicle)
+	{
+		if (vehicle == nullptr)
+		{
+			return;
+		}
+
+		size_t passengers = vehicle->GetPassengersCount();
+		std::lock_guard<std::mutex> lock(mMutex);
+		mVehicles.push_back(std::move(vehicle));
+		++mBuriedVehicles;
+		mBuriedPassengers += passengers;
+	}
+
+	void Graveyard::Bury(std::vector<std::unique_ptr<const IPassenger>> passengers)
+	{
+		if (passengers.empty())
+		{
+			return;
+		}
+
+		size_t count = passengers.size();
+		std::lock_guard<std::mutex> lock(mMutex);
+		mPassengers.push_back(std::move(passengers));
+		mBuriedPassengers += count;
+	}
+
+	void Graveyard::Flush()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			if (mMode != ReclaimMode::BACKGROUND || (mVehicles.empty() && mPassengers.empty()))
+			{
+				return;
+			}
+
+			mIsFlushRequested = true;
+			if (!mReclaimer.joinable())
+			{
+				mReclaimer = std::thread(&Graveyard::ReclaimLoop, this);
+			}
+		}
+		mWakeCondition.notify_one();
+	}
+
+	size_t Graveyard::Reclaim(std::chrono::steady_clock::duration budget)
+	{
+		// duration::max() (ReclaimAll) would overflow the clock.
+		bool isUnbounded = budget == std::chrono::steady_clock::duration::max();
+		std::chrono::steady_clock::time_point deadline = isUnbounded ? std::chrono::steady_clock::time_point::max() : std::chrono::steady_clock::now() + budget;
+		size_t destroyed = 0;
+		do
+		{
+			Batch batch;
+			{
+				std::lock_guard<std::mutex> lock(mMutex);
+				TakeLocked(RECLAIM_CHUNK, batch);
+			}
+			if (batch.vehicleCount == 0 && batch.passengerCount == 0)
+			{
+				break;
+			}
+			destroyed += Destroy(batch);
+		} while (isUnbounded || std::chrono::steady_clock::now() < deadline);
+		return destroyed;
+	}
+
+	size_t Graveyard::ReclaimAll()
+	{
+		return Reclaim(std::chrono::steady_clock::duration::max());
+	}
+
+	Graveyard::Stats Graveyard::GetStats() const
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		Stats stats;
+		stats.buriedVehicles = mBuriedVehicles;
+		stats.buriedPassengers = mBuriedPassengers;
+		stats.reclaimedVehicles = mReclaimedVehicles;
+		stats.reclaimedPassengers = mReclaimedPassengers;
+		stats.reclaimSeconds = std::chrono::duration<double>(mReclaimTime).count();
+		return stats;
+	}
+
+	void Graveyard::TakeLocked(size_t maxCount, Batch& outBatch)
+	{
+		size_t taken = 0;
+		while (taken < maxCount && !mVehicles.empty())
+		{
+			outBatch.passengerCount += mVehicles.back()->GetPassengersCount();
+			outBatch.vehicles.push_back(std::move(mVehicles.back()));
+			mVehicles.pop_back();
+			++outBatch.vehicleCount;
+			++taken;
+		}
+
+		// A batch of passengers goes whole unless it alone is over the limit.
+		while (taken < maxCount && !mPassengers.empty())
+		{
+			PassengerBatch& last = mPassengers.back();
+			if (last.size() <= maxCount - taken)
+			{
+				taken += last.size();
+				outBatch.passengerCount += last.size();
+				outBatch.passengers.push_back(std::move(last));
+				mPassengers.pop_back();
+				continue;
+			}
+
+			PassengerBatch part;
+			part.reserve(maxCount - taken);
+			while (taken < maxCount)
+			{
+				part.push_back(std::move(last.back()));
+				last.pop_back();
+				++taken;
+			}
+			outBatch.passengerCount += part.size();
+			outBatch.passengers.push_back(std::move(part));
+		}
+	}
+
+	size_t Graveyard::Destroy(Batch& batch)
+	{
+		EngineTrace::Scope trace("Graveyard::Reclaim", "fleet");
+		trace.SetArg("vehicles", batch.vehicleCount);
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		batch.vehicles.clear();
+		batch.passengers.clear();
+		std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+
+		EngineMetrics::AddReclaimed(batch.vehicleCount, batch.passengerCount, elapsed);
+		std::lock_guard<std::mutex> lock(mMutex);
+		mBuriedVehicles -= batch.vehicleCount;
+		mBuriedPassengers -= batch.passengerCount;
+		mReclaimedVehicles += batch.vehicleCount;
+		mReclaimedPassengers += batch.passengerCount;
+		mReclaimTime += elapsed;
+		return batch.vehicleCount + batch.passengerCount;
+	}
+
+	void Graveyard::ReclaimLoop()
+	{
+		EngineTrace::SetThreadName("graveyard");
+		for (;;)
+		{
+			Batch batch;
+			{
+				std::unique_lock<std::mutex> lock(mMutex);
+				mWakeCondition.wait(lock, [this] { return mIsStopping || mIsFlushRequested; });
+				if (mIsStopping)
+				{
+					return;
+				}
+				mIsFlushRequested = false;
+				// Take everything at once so Bury is never held up for long.
+				batch.vehicles.swap(mVehicles);
+				batch.passengers.swap(mPassengers);
+			}
+
+			batch.vehicleCount = batch.vehicles.size();
+			for (const std::unique_ptr<Vehicle>& vehicle : batch.vehicles)
+			{
+				batch.passengerCount += vehicle->GetPassengersCount();
+			}
+			for (const PassengerBatch& passengers : batch.passengers)
+			{
+				batch.passengerCount += passengers.size();
+			}
+			Destroy(batch);
+		}
+	}
+
+} // namespace core
+} // namespace engine
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../Interfaces/IPassenger.h"
+
+namespace engine {
+namespace vehicles {
+class Vehicle;
+} // namespace vehicles
+
+namespace core {
+
+// Holds removed vehicles and discarded passengers until they can be destroyed
+// away from the tick. Destroying a vehicle frees its passengers, their pooled
+// blocks and anything the type owns (a Sedan's trailer), so a large removal
+// done inline shows up as a tick latency spike.
+//
+// In BACKGROUND mode the owning engine calls Flush once per Travel, which
+// hands everything buried during the tick to a reclaim thread. Handing over
+// per tick rather than per burial keeps the reclaim thread from freeing into
+// the allocator while the tick is still allocating. In IDLE mode nothing is
+// destroyed until the game calls Reclaim at a point of its choosing.
+//
+// Burying and reclaiming are thread-safe. The thread is started on the first
+// Flush; the destructor reclaims whatever is left.
+class Graveyard
+{
+public:
+	enum class ReclaimMode
+	{
+		BACKGROUND,
+		IDLE
+	};
+
+	struct Stats
+	{
+		// Waiting to be destroyed, including a batch being destroyed now.
+		size_t buriedVehicles;
+		size_t buriedPassengers;    // loose ones and those aboard buried vehicles
+		// Since construction.
+		uint64_t reclaimedVehicles;
+		uint64_t reclaimedPassengers;
+		double reclaimSeconds;      // time spent destroying them
+	};
+
+	Graveyard();
+	~Graveyard();
+
+	Graveyard(const Graveyard&) = delete;
+	Graveyard& operator=(const Graveyard&) = delete;
+
+	void SetReclaimMode(ReclaimMode mode);
+	ReclaimMode GetReclaimMode() const;
+
+	// A vehicle must be out of its engine (unbound from travel state and
+	// journal) before it is buried.
+	void Bury(std::unique_ptr<vehicles::Vehicle> vehicle);
+	void Bury(std::vector<std::unique_ptr<const interfaces::IPassenger>> passengers);
+
+	// BACKGROUND: wakes the reclaim thread if anything is buried. IDLE: no-op.
+	void Flush();
+	// Destroys buried objects on the calling thread, in either mode, until
+	// none are left or `budget` has elapsed; at least one batch goes per
+	// call. Returns the vehicles and passengers destroyed.
+	size_t Reclaim(std::chrono::steady_clock::duration budget);
+	size_t ReclaimAll();
+
+	Stats GetStats() const;
+
+private:
+	typedef std::vector<std::unique_ptr<const interfaces::IPassenger>> PassengerBatch;
+
+	// Objects taken out of the graveyard together and destroyed unlocked.
+	struct Batch
+	{
+		std::vector<std::unique_ptr<vehicles::Vehicle>> vehicles;
+		std::vector<PassengerBatch> passengers;
+		size_t vehicleCount = 0;
+		size_t passengerCount = 0;
+	};
+
+	// Upper bound on what Reclaim takes at once, so its budget is checked often.
+	static constexpr size_t RECLAIM_CHUNK = 256;
+
+	// Moves up to `maxCount` objects into `outBatch`; the caller holds mMutex.
+	void TakeLocked(size_t maxCount, Batch& outBatch);
+	// Destroys `batch` (unlocked) and records the work.
+	size_t Destroy(Batch& batch);
+	void ReclaimLoop();
+
+	mutable std::mutex mMutex;
+	std::condition_variable mWakeCondition;
+	std::thread mReclaimer;
+	ReclaimMode mMode;
+	bool mIsFlushRequested;
+	bool mIsStopping;
+	std::vector<std::unique_ptr<vehicles::Vehicle>> mVehicles;
+	std::vector<PassengerBatch> mPassengers;
+	size_t mBuriedVehicles;
+	size_t mBuriedPassengers;
+	uint64_t mReclaimedVehicles;
+	uint64_t mReclaimedPassengers;
+	std::chrono::steady_clock::duration mReclaimTime;
+};
+
+} // namespace core
+} // namespace engine
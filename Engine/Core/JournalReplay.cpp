@@ -0,0 +1,308 @@
+#include <climits>
+#include <cstring>
+#include <string_view>
+
+#include "JournalReplay.h"
+#include "MappedFile.h"
+#include "SnapshotStream.h"
+
+namespace engine {
+namespace core {
+
+using engine::vehicles::Vehicle;
+
+typedef FleetJournal::RecordKind RecordKind;
+
+namespace {
+
+	constexpr size_t HEADER_WORDS = 4;
+
+	// DEFINE_* payload: id, byte length, bytes padded to whole words.
+	bool ReadString(const uint32_t* payload, uint32_t length, std::string_view& outValue)
+	{
+		if (length < 2)
+		{
+			return false;
+		}
+
+		uint32_t byteCount = payload[1];
+		if ((static_cast<uint64_t>(byteCount) + 3) / 4 != length - 2)
+		{
+			return false;
+		}
+		outValue = std::string_view(reinterpret_cast<const char*>(payload + 2), byteCount);
+		return true;
+	}
+
+} // namespace
+
+	JournalReplay::JournalReplay(const VehicleTypeRegistry& types)
+		: mTypes(types)
+		, mIsCoalescingTravel(true)
+		, mRecordCount(0)
+		, mTravelCallCount(0)
+		, mFileWordCount(0)
+		, mHasPendingTravel(false)
+	{
+	}
+
+	void JournalReplay::SetCoalesceTravel(bool isEnabled)
+	{
+		mIsCoalescingTravel = isEnabled;
+	}
+
+	bool JournalReplay::Replay(DeusExMachina& engine, const char* path)
+	{
+		mRecordCount = 0;
+		mTravelCallCount = 0;
+		mTypeById.clear();
+		mNameById.clear();
+		mHasPendingTravel = false;
+
+		if (engine.GetVehicleCount() != 0)
+		{
+			return false;
+		}
+
+		MappedFile file;
+		if (!file.Open(path))
+		{
+			return false;
+		}
+
+		// The mapping is 8-byte aligned, so the words are read in place.
+		const uint32_t* words = reinterpret_cast<const uint32_t*>(file.GetData());
+		size_t wordCount = file.GetSize() / sizeof(uint32_t);
+		mFileWordCount = wordCount;
+		if (wordCount < HEADER_WORDS)
+		{
+			return false;
+		}
+
+		uint32_t magic[2];
+		std::memcpy(magic, FleetJournal::MAGIC, sizeof(magic));
+		if (words[0] != magic[0]
+			|| words[1] != magic[1]
+			|| words[2] != FleetJournal::VERSION
+			|| words[3] != FleetJournal::BYTE_ORDER_MARK)
+		{
+			return false;
+		}
+
+		size_t position = HEADER_WORDS;
+		while (position < wordCount)
+		{
+			uint8_t kind = static_cast<uint8_t>(words[position] & 0xFFu);
+			uint32_t length = words[position] >> 8;
+			if (length > wordCount - position - 1)
+			{
+				break;
+			}
+
+			if (!ApplyRecord(engine, kind, words + position + 1, length))
+			{
+				FlushTravel(engine);
+				return false;
+			}
+			++mRecordCount;
+			position += 1 + static_cast<size_t>(length);
+		}
+
+		FlushTravel(engine);
+		return true;
+	}
+
+	size_t JournalReplay::GetRecordCount() const
+	{
+		return mRecordCount;
+	}
+
+	size_t JournalReplay::GetTravelCallCount() const
+	{
+		return mTravelCallCount;
+	}
+
+	bool JournalReplay::ApplyRecord(DeusExMachina& engine, uint8_t kind, const uint32_t* payload, uint32_t length)
+	{
+		if (kind == static_cast<uint8_t>(RecordKind::TRAVEL))
+		{
+			if (length != 3)
+			{
+				return false;
+			}
+
+			TravelContext context;
+			context.hours = payload[0];
+			std::memcpy(&context.weatherMultiplier, &payload[1], sizeof(context.weatherMultiplier));
+			context.isEmergency = payload[2] != 0;
+
+			if (mHasPendingTravel
+				&& mIsCoalescingTravel
+				&& std::memcmp(&mPendingTravel.weatherMultiplier, &context.weatherMultiplier, sizeof(context.weatherMultiplier)) == 0
+				&& mPendingTravel.isEmergency == context.isEmergency
+				&& context.hours <= UINT_MAX - mPendingTravel.hours)
+			{
+				mPendingTravel.hours += context.hours;
+				return true;
+			}
+
+			FlushTravel(engine);
+			mPendingTravel = context;
+			mHasPendingTravel = true;
+			return true;
+		}
+
+		// Every other record observes or changes the fleet between ticks.
+		FlushTravel(engine);
+
+		unsigned int vehicleCount = static_cast<unsigned int>(engine.GetVehicleCount());
+		Vehicle* vehicle = nullptr;
+		if (kind != static_cast<uint8_t>(RecordKind::DEFINE_TYPE)
+			&& kind != static_cast<uint8_t>(RecordKind::DEFINE_NAME)
+			&& kind != static_cast<uint8_t>(RecordKind::ADD_VEHICLE))
+		{
+			if (length < 1 || payload[0] >= vehicleCount)
+			{
+				return false;
+			}
+			vehicle = engine.GetVehicle(engine.GetVehicleHandle(payload[0]));
+		}
+
+		switch (static_cast<RecordKind>(kind))
+		{
+		case RecordKind::DEFINE_TYPE:
+		{
+			std::string_view name;
+			if (!ReadString(payload, length, name))
+			{
+				return false;
+			}
+
+			uint32_t type = mTypes.FindType(name);
+			if (type == VehicleTypeRegistry::NONE)
+			{
+				return false;
+			}
+			mTypeById[payload[0]] = type;
+			mTypes.RegisterBucket(type, engine);
+			return true;
+		}
+		case RecordKind::DEFINE_NAME:
+		{
+			std::string_view name;
+			if (!ReadString(payload, length, name) || payload[0] != mNameById.size())
+			{
+				return false;
+			}
+			mNameById.push_back(NameTable::GetInstance()->Intern(name));
+			return true;
+		}
+		case RecordKind::ADD_VEHICLE:
+			return AddVehicle(engine, payload, length);
+		case RecordKind::REMOVE_VEHICLE:
+			return length == 1 && engine.RemoveVehicle(payload[0]);
+		case RecordKind::ADD_PASSENGER:
+			if (length != 3 || payload[1] >= mNameById.size() || !mTypes.HasPassengerFactory())
+			{
+				return false;
+			}
+			return vehicle->AddPassenger(mTypes.CreatePassenger(mNameById[payload[1]], payload[2]));
+		case RecordKind::REMOVE_PASSENGER:
+			return length == 2 && vehicle->RemovePassenger(payload[1]);
+		case RecordKind::RELEASE_ALL_PASSENGERS:
+			if (length != 1)
+			{
+				return false;
+			}
+			vehicle->ReleaseAllPassengers();
+			return true;
+		case RecordKind::SET_TRAVEL_STATE:
+			if (length != 4)
+			{
+				return false;
+			}
+			vehicle->SetTravelState(payload[1], payload[2], payload[3]);
+			return true;
+		case RecordKind::SET_VEHICLE_STATE:
+		{
+			SnapshotReader reader(payload + 1, length - 1);
+			return vehicle->ReadSnapshot(reader) && reader.IsAtEnd();
+		}
+		default:
+			return false;
+		}
+	}
+
+	bool JournalReplay::AddVehicle(DeusExMachina& engine, const uint32_t* payload, uint32_t length)
+	{
+		// type, maxPassengers, odo, move, idle, stateCount, state..., passengerCount, (name, weight)...
+		if (length < 7 || payload[5] > length - 7)
+		{
+			return false;
+		}
+
+		// A passenger limit larger than the whole journal can only come from a
+		// corrupt record.
+		if (payload[1] > mFileWordCount)
+		{
+			return false;
+		}
+
+		uint32_t stateCount = payload[5];
+		const uint32_t* passengers = payload + 6 + stateCount;
+		uint32_t passengerCount = passengers[0];
+		if (static_cast<uint64_t>(passengerCount) * 2 != length - 7 - stateCount)
+		{
+			return false;
+		}
+
+		std::unordered_map<uint32_t, uint32_t>::const_iterator type = mTypeById.find(payload[0]);
+		if (type == mTypeById.end())
+		{
+			return false;
+		}
+
+		std::unique_ptr<Vehicle> vehicle = mTypes.CreateVehicle(type->second, payload[1]);
+		if (vehicle == nullptr || vehicle->GetMaxPassengersCount() != payload[1])
+		{
+			return false;
+		}
+
+		SnapshotReader reader(payload + 6, stateCount);
+		if (!vehicle->ReadSnapshot(reader) || !reader.IsAtEnd())
+		{
+			return false;
+		}
+
+		if (passengerCount > 0 && !mTypes.HasPassengerFactory())
+		{
+			return false;
+		}
+		for (uint32_t p = 0; p < passengerCount; ++p)
+		{
+			uint32_t name = passengers[1 + 2 * p];
+			uint32_t weight = passengers[2 + 2 * p];
+			if (name >= mNameById.size() || !vehicle->AddPassenger(mTypes.CreatePassenger(mNameById[name], weight)))
+			{
+				return false;
+			}
+		}
+
+		vehicle->SetTravelState(payload[2], payload[3], payload[4]);
+		return engine.AddVehicle(std::move(vehicle));
+	}
+
+	void JournalReplay::FlushTravel(DeusExMachina& engine)
+	{
+		if (!mHasPendingTravel)
+		{
+			return;
+		}
+
+		mHasPendingTravel = false;
+		engine.Travel(mPendingTravel);
+		++mTravelCallCount;
+	}
+
+} // namespace core
+} // namespace engine
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "DeusExMachina.h"
+#include "NameTable.h"
+#include "VehicleTypeRegistry.h"
+
+namespace engine {
+namespace core {
+
+// Rebuilds a fleet from a FleetJournal file by re-applying its records to an
+// empty engine.
+//
+// Runs of consecutive Travel records with the same weather and emergency flag
+// are merged into one Travel of their summed hours, so a long stretch of
+// ticks costs a single pass over the fleet. That is only exact when
+// TravelByMachina is additive in hours -- travelling a then b hours equals
+// travelling a + b -- which holds for every core::DutyCycle policy. Turn it
+// off with SetCoalesceTravel for types where it does not.
+class JournalReplay
+{
+public:
+	// `types` must outlive the replay.
+	explicit JournalReplay(const VehicleTypeRegistry& types);
+	~JournalReplay() = default;
+
+	JournalReplay(const JournalReplay&) = delete;
+	JournalReplay& operator=(const JournalReplay&) = delete;
+
+	void SetCoalesceTravel(bool isEnabled);
+
+	// `engine` must be empty. A record cut short at the end of the file (the
+	// writer died mid-buffer) ends the replay there. Any other malformed or
+	// inconsistent record fails the replay, leaving `engine` with the fleet as
+	// of the record before it.
+	bool Replay(DeusExMachina& engine, const char* path);
+
+	// Counters for the last Replay.
+	size_t GetRecordCount() const;
+	size_t GetTravelCallCount() const;
+
+private:
+	bool ApplyRecord(DeusExMachina& engine, uint8_t kind, const uint32_t* payload, uint32_t length);
+	bool AddVehicle(DeusExMachina& engine, const uint32_t* payload, uint32_t length);
+	void FlushTravel(DeusExMachina& engine);
+
+	const VehicleTypeRegistry& mTypes;
+	bool mIsCoalescingTravel;
+	size_t mRecordCount;
+	size_t mTravelCallCount;
+
+	// Per-replay state.
+	size_t mFileWordCount;
+	std::unordered_map<uint32_t, uint32_t> mTypeById;
+	std::vector<NameTable::NameId> mNameById;
+	TravelContext mPendingTravel;
+	bool mHasPendingTravel;
+};
+
+} // namespace core
+} // namespace engine
@@ -0,0 +1,104 @@
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MACHINA_HAS_MMAP 1
+#endif
+
+#include "MappedFile.h"
+
+namespace engine {
+namespace core {
+
+	MappedFile::MappedFile()
+		: mData(nullptr)
+		, mSize(0)
+		, mIsMapped(false)
+	{
+	}
+
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+	bool MappedFile::Open(const char* path)
+	{
+		Close();
+
+#ifdef MACHINA_HAS_MMAP
+		int fd = ::open(path, O_RDONLY);
+		if (fd < 0)
+		{
+			return false;
+		}
+
+		struct stat info;
+		if (::fstat(fd, &info) != 0 || info.st_size <= 0)
+		{
+			::close(fd);
+			return false;
+		}
+
+		size_t size = static_cast<size_t>(info.st_size);
+		void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		::close(fd);
+		if (mapping != MAP_FAILED)
+		{
+			mData = static_cast<const uint8_t*>(mapping);
+			mSize = size;
+			mIsMapped = true;
+			return true;
+		}
+#endif
+
+		return ReadIntoBuffer(path);
+	}
+
+	void MappedFile::Close()
+	{
+#ifdef MACHINA_HAS_MMAP
+		if (mIsMapped)
+		{
+			::munmap(const_cast<uint8_t*>(mData), mSize);
+		}
+#endif
+		mData = nullptr;
+		mSize = 0;
+		mIsMapped = false;
+		mBuffer.clear();
+		mBuffer.shrink_to_fit();
+	}
+
+	bool MappedFile::ReadIntoBuffer(const char* path)
+	{
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		if (!file)
+		{
+			return false;
+		}
+
+		std::streamoff size = file.tellg();
+		if (size <= 0)
+		{
+			return false;
+		}
+
+		mBuffer.resize((static_cast<size_t>(size) + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+		file.seekg(0);
+		if (!file.read(reinterpret_cast<char*>(mBuffer.data()), size))
+		{
+			mBuffer.clear();
+			return false;
+		}
+
+		mData = reinterpret_cast<const uint8_t*>(mBuffer.data());
+		mSize = static_cast<size_t>(size);
+		return true;
+	}
+
+} // namespace core
+} // namespace engine
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace engine {
+namespace core {
+
+// Read-only view of a whole file. Uses mmap where available so opening a
+// large snapshot costs no copy up front; elsewhere (or if mapping fails) the
+// file is read into an owned buffer. The data is 8-byte aligned either way.
+class MappedFile
+{
+public:
+	MappedFile();
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool Open(const char* path);
+	void Close();
+
+	const uint8_t* GetData() const { return mData; }
+	size_t GetSize() const { return mSize; }
+	bool IsMapped() const { return mIsMapped; }
+
+private:
+	bool ReadIntoBuffer(const char* path);
+
+	const uint8_t* mData;
+	size_t mSize;
+	bool mIsMapped;
+	std::vector<uint64_t> mBuffer;
+};
+
+} // namespace core
+} // namespace engine
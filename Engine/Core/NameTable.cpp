@@ -0,0 +1,69 @@
+#include <stdexcept>
+
+#include "NameTable.h"
+
+namespace engine {
+namespace core {
+
+	NameTable* NameTable::GetInstance()
+	{
+		// Deliberately leaked: passengers owned by other statics may still
+		// resolve their names during static destruction.
+		static NameTable* instance = new NameTable();
+		return instance;
+	}
+
+	NameTable::NameTable()
+		: mChunks(new std::atomic<std::string*>[MAX_CHUNKS])
+		, mCount(0)
+	{
+		for (uint32_t i = 0; i < MAX_CHUNKS; ++i)
+		{
+			mChunks[i].store(nullptr, std::memory_order_relaxed);
+		}
+	}
+
+	NameTable::NameId NameTable::Intern(std::string_view name)
+	{
+		std::lock_guard<std::mutex> lock(mInternMutex);
+
+		std::unordered_map<std::string_view, NameId>::const_iterator found = mLookup.find(name);
+		if (found != mLookup.end())
+		{
+			return found->second;
+		}
+
+		uint32_t id = mCount.load(std::memory_order_relaxed);
+		uint32_t chunkIndex = id >> CHUNK_BITS;
+		if (chunkIndex >= MAX_CHUNKS)
+		{
+			throw std::length_error("NameTable is full");
+		}
+
+		std::string* chunk = mChunks[chunkIndex].load(std::memory_order_relaxed);
+		if (chunk == nullptr)
+		{
+			chunk = new std::string[CHUNK_SIZE];
+			mChunks[chunkIndex].store(chunk, std::memory_order_release);
+		}
+
+		std::string& stored = chunk[id & (CHUNK_SIZE - 1)];
+		stored.assign(name.data(), name.size());
+		mLookup.emplace(std::string_view(stored), id);
+		mCount.store(id + 1, std::memory_order_release);
+		return id;
+	}
+
+	const std::string& NameTable::Resolve(NameId id) const
+	{
+		const std::string* chunk = mChunks[id >> CHUNK_BITS].load(std::memory_order_acquire);
+		return chunk[id & (CHUNK_SIZE - 1)];
+	}
+
+	size_t NameTable::GetSize() const
+	{
+		return mCount.load(std::memory_order_acquire);
+	}
+
+} // namespace core
+} // namespace engine
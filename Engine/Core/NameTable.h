@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace engine {
+namespace core {
+
+// Process-wide string interning for passenger names. Each distinct name is
+// stored once and identified by a compact NameId. Resolved strings are never
+// moved or freed, so the references handed out stay valid for the lifetime
+// of the process and Resolve takes no lock.
+class NameTable
+{
+public:
+	typedef uint32_t NameId;
+
+	static NameTable* GetInstance();
+
+	NameId Intern(std::string_view name);
+	const std::string& Resolve(NameId id) const;
+	size_t GetSize() const;
+
+private:
+	static constexpr uint32_t CHUNK_BITS = 12;
+	static constexpr uint32_t CHUNK_SIZE = 1u << CHUNK_BITS;
+	static constexpr uint32_t MAX_CHUNKS = 1u << 16;
+
+	NameTable();
+	~NameTable() = default;
+
+	NameTable(const NameTable&) = delete;
+	NameTable& operator=(const NameTable&) = delete;
+
+	// Strings live in fixed-size chunks published through atomic pointers, so
+	// growing the table never relocates an existing string.
+	std::unique_ptr<std::atomic<std::string*>[]> mChunks;
+	std::unordered_map<std::string_view, NameId> mLookup;
+	std::atomic<uint32_t> mCount;
+	mutable std::mutex mInternMutex;
+};
+
+} // namespace core
+} // namespace engine
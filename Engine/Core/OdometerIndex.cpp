@@ -0,0 +1,629 @@
+#include <algorithm>
+
+#include "OdometerIndex.h"
+
+namespace engine {
+namespace core {
+
+	OdometerIndex::OdometerIndex()
+		: mRoot(NONE)
+		, mFurthest(NONE)
+		, mIsTreeStale(false)
+		, mIsFurthestStale(false)
+		, mIsRankPolled(false)
+		, mIsOrderSorted(false)
+		, mIsTreeWanted(false)
+		, mRandomState(0x9E3779B9u)
+	{
+	}
+
+	void OdometerIndex::Insert(uint32_t slot, unsigned int odo, uint64_t sequence)
+	{
+		mNodes.push_back(Node{ odo, NextPriority(), sequence, NONE, NONE, 1 });
+		// New vehicles usually start at zero and so rank last.
+		if (!mIsOrderSorted || (!mOrder.empty() && IsBefore(mOrder.back(), slot)))
+		{
+			PrepareChange();
+		}
+		if (mOrder.size() >= 2 * mNodes.size() + 64)
+		{
+			CompactOrder();
+		}
+		mPosition.push_back(static_cast<uint32_t>(mOrder.size()));
+		mOrder.push_back(slot);
+		if (mIsTreeStale)
+		{
+			if (!mIsFurthestStale && (mFurthest == NONE || IsBefore(mFurthest, slot)))
+			{
+				mFurthest = slot;
+			}
+			return;
+		}
+
+		mRoot = InsertNode(mRoot, slot);
+		RefreshFurthest();
+	}
+
+	void OdometerIndex::InsertBulk(const unsigned int* odo, size_t count, uint64_t firstSequence)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+
+		mNodes.reserve(mNodes.size() + count);
+		mOrder.reserve(mOrder.size() + count);
+		mPosition.reserve(mPosition.size() + count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			uint32_t slot = static_cast<uint32_t>(mNodes.size());
+			mNodes.push_back(Node{ odo[i], NextPriority(), firstSequence + i, NONE, NONE, 1 });
+			mPosition.push_back(static_cast<uint32_t>(mOrder.size()));
+			mOrder.push_back(slot);
+			if (!mIsFurthestStale && (mFurthest == NONE || IsBefore(mFurthest, slot)))
+			{
+				mFurthest = slot;
+			}
+		}
+		mIsTreeStale = true;
+		mIsOrderSorted = false;
+	}
+
+	void OdometerIndex::Update(uint32_t slot, unsigned int odo)
+	{
+		if (mNodes[slot].odo == odo)
+		{
+			return;
+		}
+
+		PrepareChange();
+		if (mIsTreeStale)
+		{
+			bool wasFurthest = slot == mFurthest;
+			mNodes[slot].odo = odo;
+			if (wasFurthest)
+			{
+				mIsFurthestStale = true;
+			}
+			else if (!mIsFurthestStale && IsBefore(mFurthest, slot))
+			{
+				mFurthest = slot;
+			}
+			return;
+		}
+
+		mRoot = EraseNode(mRoot, slot);
+		Node& node = mNodes[slot];
+		node.odo = odo;
+		node.left = NONE;
+		node.right = NONE;
+		node.size = 1;
+		mRoot = InsertNode(mRoot, slot);
+		RefreshFurthest();
+	}
+
+	void OdometerIndex::SwapRemove(uint32_t slot)
+	{
+		PrepareChange();
+		uint32_t last = static_cast<uint32_t>(mNodes.size() - 1);
+		mOrder[mPosition[slot]] = NONE;
+		if (slot != last)
+		{
+			mOrder[mPosition[last]] = slot;
+			mPosition[slot] = mPosition[last];
+		}
+		mPosition.pop_back();
+
+		if (mIsTreeStale)
+		{
+			mNodes[slot] = mNodes[last];
+			mNodes.pop_back();
+			if (mFurthest == slot)
+			{
+				mIsFurthestStale = true;
+			}
+			else if (mFurthest == last)
+			{
+				mFurthest = slot;
+			}
+			return;
+		}
+
+		mRoot = EraseNode(mRoot, slot);
+
+		if (slot != last)
+		{
+			// Tree links refer to slots, so the last node is re-inserted under its
+			// new slot rather than patched in place.
+			mRoot = EraseNode(mRoot, last);
+			Node& moved = mNodes[slot];
+			moved = mNodes[last];
+			moved.left = NONE;
+			moved.right = NONE;
+			moved.size = 1;
+			mRoot = InsertNode(mRoot, slot);
+		}
+
+		mNodes.pop_back();
+		RefreshFurthest();
+	}
+
+	void OdometerIndex::Reconcile(const unsigned int* odo, size_t count)
+	{
+		size_t changed = 0;
+		for (size_t slot = 0; slot < count; ++slot)
+		{
+			changed += mNodes[slot].odo != odo[slot] ? 1 : 0;
+		}
+		if (changed == 0)
+		{
+			return;
+		}
+
+		// One incremental update costs a few cache-missing tree walks; past
+		// roughly an eighth of the fleet a deferred rebuild is cheaper.
+		if (!mIsTreeStale && changed * BULK_THRESHOLD_DIVISOR < count)
+		{
+			for (size_t slot = 0; slot < count; ++slot)
+			{
+				Update(static_cast<uint32_t>(slot), odo[slot]);
+			}
+			return;
+		}
+
+		uint32_t furthest = NONE;
+		for (uint32_t slot = 0; slot < count; ++slot)
+		{
+			mNodes[slot].odo = odo[slot];
+			if (furthest == NONE || IsBefore(furthest, slot))
+			{
+				furthest = slot;
+			}
+		}
+		mFurthest = furthest;
+		mIsFurthestStale = false;
+		mIsTreeStale = true;
+		mIsOrderSorted = false;
+		mIsTreeWanted = false;
+
+		// Whoever asked for ranks since the last batch will most likely ask
+		// again after this one; sort now rather than inside their query.
+		if (mIsRankPolled)
+		{
+			mIsRankPolled = false;
+			SortOrder();
+		}
+	}
+
+	void OdometerIndex::Reserve(size_t count)
+	{
+		mNodes.reserve(count);
+		mOrder.reserve(count);
+		mPosition.reserve(count);
+	}
+
+	uint32_t OdometerIndex::GetFurthest() const
+	{
+		if (mIsFurthestStale)
+		{
+			ScanFurthest();
+		}
+		return mFurthest;
+	}
+
+	size_t OdometerIndex::GetRank(uint32_t slot) const
+	{
+		if (EnsureOrdered())
+		{
+			return mPosition[slot] + size_t(1);
+		}
+
+		size_t ahead = 0;
+		uint32_t node = mRoot;
+		while (node != NONE)
+		{
+			if (IsBefore(slot, node))
+			{
+				ahead += SizeOf(mNodes[node].right) + 1;
+				node = mNodes[node].left;
+			}
+			else if (IsBefore(node, slot))
+			{
+				node = mNodes[node].right;
+			}
+			else
+			{
+				ahead += SizeOf(mNodes[node].right);
+				break;
+			}
+		}
+		return ahead + 1;
+	}
+
+	uint32_t OdometerIndex::GetSlotAtRank(size_t rank) const
+	{
+		if (rank == 0 || rank > mNodes.size())
+		{
+			return NONE;
+		}
+		if (EnsureOrdered())
+		{
+			return mOrder[rank - 1];
+		}
+
+		uint32_t node = mRoot;
+		while (node != NONE)
+		{
+			size_t ahead = SizeOf(mNodes[node].right);
+			if (rank <= ahead)
+			{
+				node = mNodes[node].right;
+			}
+			else if (rank == ahead + 1)
+			{
+				return node;
+			}
+			else
+			{
+				rank -= ahead + 1;
+				node = mNodes[node].left;
+			}
+		}
+		return NONE;
+	}
+
+	void OdometerIndex::GetTop(size_t count, std::vector<uint32_t>& outSlots) const
+	{
+		outSlots.clear();
+		if (EnsureOrdered())
+		{
+			outSlots.assign(mOrder.begin(), mOrder.begin() + std::min(count, mOrder.size()));
+			return;
+		}
+
+		// Reverse in-order walk: right subtree, node, left subtree.
+		std::vector<uint32_t> stack;
+		uint32_t node = mRoot;
+		while (outSlots.size() < count && (node != NONE || !stack.empty()))
+		{
+			while (node != NONE)
+			{
+				stack.push_back(node);
+				node = mNodes[node].right;
+			}
+
+			node = stack.back();
+			stack.pop_back();
+			outSlots.push_back(node);
+			node = mNodes[node].left;
+		}
+	}
+
+	bool OdometerIndex::IsBefore(uint32_t a, uint32_t b) const
+	{
+		const Node& lhs = mNodes[a];
+		const Node& rhs = mNodes[b];
+		if (lhs.odo != rhs.odo)
+		{
+			return lhs.odo < rhs.odo;
+		}
+		return lhs.sequence > rhs.sequence;
+	}
+
+	bool OdometerIndex::EnsureOrdered() const
+	{
+		mIsRankPolled = true;
+		if (mIsOrderSorted)
+		{
+			return true;
+		}
+		if (!mIsTreeStale)
+		{
+			return false;
+		}
+
+		// Something changed since the last sort without a tick in between; if
+		// it happens again, the tree is worth rebuilding for the changes.
+		mIsTreeWanted = true;
+		SortOrder();
+		return true;
+	}
+
+	void OdometerIndex::PrepareChange()
+	{
+		if (mIsOrderSorted && mIsTreeStale && mIsTreeWanted)
+		{
+			BuildTree();
+		}
+		mIsOrderSorted = false;
+	}
+
+	void OdometerIndex::BuildTree()
+	{
+		// Cartesian tree over the sorted keys using the existing priorities:
+		// the right spine lives on the stack, and a node's subtree is final
+		// (and can be sized) once it is popped off.
+		std::vector<uint32_t> spine;
+		for (auto it = mOrder.rbegin(); it != mOrder.rend(); ++it)
+		{
+			uint32_t node = *it;
+			Node& current = mNodes[node];
+			current.left = NONE;
+			current.right = NONE;
+
+			uint32_t popped = NONE;
+			while (!spine.empty() && mNodes[spine.back()].priority < current.priority)
+			{
+				popped = spine.back();
+				spine.pop_back();
+				Node& finished = mNodes[popped];
+				finished.size = SizeOf(finished.left) + SizeOf(finished.right) + 1;
+			}
+
+			current.left = popped;
+			if (!spine.empty())
+			{
+				mNodes[spine.back()].right = node;
+			}
+			spine.push_back(node);
+		}
+
+		while (!spine.empty())
+		{
+			Node& finished = mNodes[spine.back()];
+			finished.size = SizeOf(finished.left) + SizeOf(finished.right) + 1;
+			mRoot = spine.back();
+			spine.pop_back();
+		}
+		if (mNodes.empty())
+		{
+			mRoot = NONE;
+		}
+
+		mIsTreeStale = false;
+		mFurthest = mOrder.empty() ? NONE : mOrder.front();
+		mIsFurthestStale = false;
+	}
+
+	void OdometerIndex::SortOrder() const
+	{
+		// Stable LSD radix sort by odometer, 11 bits a pass, ascending and
+		// starting from the previous order. Keys move a little each tick, so
+		// that order is close to the new one and equal odometers mostly keep
+		// their registration order; only runs of equal odometers that lost it
+		// are re-sorted. Small fleets skip the radix and its fixed cost.
+		const unsigned int DIGIT_BITS = 11;
+		const size_t BUCKETS = size_t(1) << DIGIT_BITS;
+		const unsigned int PASSES = 3;
+		const size_t SMALL_SORT = 256;
+
+		mSortKeys.clear();
+		for (auto it = mOrder.rbegin(); it != mOrder.rend(); ++it)
+		{
+			if (*it != NONE)
+			{
+				mSortKeys.push_back((static_cast<uint64_t>(mNodes[*it].odo) << 32) | *it);
+			}
+		}
+		size_t count = mSortKeys.size();
+		auto isKeyBefore = [this](uint64_t a, uint64_t b) { return IsBefore(static_cast<uint32_t>(a), static_cast<uint32_t>(b)); };
+		if (count <= SMALL_SORT)
+		{
+			std::sort(mSortKeys.begin(), mSortKeys.end(), isKeyBefore);
+			WriteOrder();
+			return;
+		}
+		mSortSpare.resize(count);
+
+		std::vector<uint32_t> offsets(PASSES * BUCKETS, 0);
+		for (uint64_t key : mSortKeys)
+		{
+			unsigned int odo = static_cast<unsigned int>(key >> 32);
+			++offsets[odo & (BUCKETS - 1)];
+			++offsets[BUCKETS + ((odo >> DIGIT_BITS) & (BUCKETS - 1))];
+			++offsets[2 * BUCKETS + (odo >> (2 * DIGIT_BITS))];
+		}
+
+		for (unsigned int pass = 0; pass < PASSES && count > 0; ++pass)
+		{
+			unsigned int shift = 32 + pass * DIGIT_BITS;
+			uint32_t* bucket = &offsets[pass * BUCKETS];
+			// A digit shared by every key leaves the order as it is.
+			if (bucket[(mSortKeys[0] >> shift) & (BUCKETS - 1)] == count)
+			{
+				continue;
+			}
+
+			uint32_t total = 0;
+			for (size_t digit = 0; digit < BUCKETS; ++digit)
+			{
+				uint32_t digitCount = bucket[digit];
+				bucket[digit] = total;
+				total += digitCount;
+			}
+			for (uint64_t key : mSortKeys)
+			{
+				mSortSpare[bucket[(key >> shift) & (BUCKETS - 1)]++] = key;
+			}
+			mSortKeys.swap(mSortSpare);
+		}
+
+		size_t runStart = 0;
+		while (runStart < count)
+		{
+			uint64_t runOdo = mSortKeys[runStart] >> 32;
+			bool isRunOrdered = true;
+			size_t runEnd = runStart + 1;
+			for (; runEnd < count && (mSortKeys[runEnd] >> 32) == runOdo; ++runEnd)
+			{
+				isRunOrdered = isRunOrdered && isKeyBefore(mSortKeys[runEnd - 1], mSortKeys[runEnd]);
+			}
+			if (!isRunOrdered)
+			{
+				std::sort(mSortKeys.begin() + runStart, mSortKeys.begin() + runEnd, isKeyBefore);
+			}
+			runStart = runEnd;
+		}
+		WriteOrder();
+	}
+
+	void OdometerIndex::WriteOrder() const
+	{
+		size_t count = mSortKeys.size();
+		mOrder.resize(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			uint32_t slot = static_cast<uint32_t>(mSortKeys[count - 1 - i]);
+			mOrder[i] = slot;
+			mPosition[slot] = static_cast<uint32_t>(i);
+		}
+		mIsOrderSorted = true;
+	}
+
+	void OdometerIndex::CompactOrder()
+	{
+		size_t kept = 0;
+		for (uint32_t slot : mOrder)
+		{
+			if (slot != NONE)
+			{
+				mPosition[slot] = static_cast<uint32_t>(kept);
+				mOrder[kept++] = slot;
+			}
+		}
+		mOrder.resize(kept);
+	}
+
+	void OdometerIndex::ScanFurthest() const
+	{
+		uint32_t furthest = NONE;
+		for (uint32_t slot = 0; slot < mNodes.size(); ++slot)
+		{
+			if (furthest == NONE || IsBefore(furthest, slot))
+			{
+				furthest = slot;
+			}
+		}
+		mFurthest = furthest;
+		mIsFurthestStale = false;
+	}
+
+	void OdometerIndex::Recount(uint32_t node)
+	{
+		mNodes[node].size = SizeOf(mNodes[node].left) + SizeOf(mNodes[node].right) + 1;
+	}
+
+	void OdometerIndex::Split(uint32_t root, uint32_t pivot, uint32_t& outBefore, uint32_t& outAfter)
+	{
+		if (root == NONE)
+		{
+			outBefore = NONE;
+			outAfter = NONE;
+			return;
+		}
+
+		if (IsBefore(root, pivot))
+		{
+			Split(mNodes[root].right, pivot, mNodes[root].right, outAfter);
+			outBefore = root;
+		}
+		else
+		{
+			Split(mNodes[root].left, pivot, outBefore, mNodes[root].left);
+			outAfter = root;
+		}
+		Recount(root);
+	}
+
+	uint32_t OdometerIndex::Merge(uint32_t before, uint32_t after)
+	{
+		if (before == NONE)
+		{
+			return after;
+		}
+		if (after == NONE)
+		{
+			return before;
+		}
+
+		if (mNodes[before].priority > mNodes[after].priority)
+		{
+			mNodes[before].right = Merge(mNodes[before].right, after);
+			Recount(before);
+			return before;
+		}
+
+		mNodes[after].left = Merge(before, mNodes[after].left);
+		Recount(after);
+		return after;
+	}
+
+	uint32_t OdometerIndex::InsertNode(uint32_t root, uint32_t node)
+	{
+		if (root == NONE)
+		{
+			return node;
+		}
+
+		if (mNodes[node].priority > mNodes[root].priority)
+		{
+			Split(root, node, mNodes[node].left, mNodes[node].right);
+			Recount(node);
+			return node;
+		}
+
+		if (IsBefore(node, root))
+		{
+			mNodes[root].left = InsertNode(mNodes[root].left, node);
+		}
+		else
+		{
+			mNodes[root].right = InsertNode(mNodes[root].right, node);
+		}
+		Recount(root);
+		return root;
+	}
+
+	uint32_t OdometerIndex::EraseNode(uint32_t root, uint32_t node)
+	{
+		if (root == node)
+		{
+			return Merge(mNodes[root].left, mNodes[root].right);
+		}
+
+		if (IsBefore(node, root))
+		{
+			mNodes[root].left = EraseNode(mNodes[root].left, node);
+		}
+		else
+		{
+			mNodes[root].right = EraseNode(mNodes[root].right, node);
+		}
+		Recount(root);
+		return root;
+	}
+
+	void OdometerIndex::RefreshFurthest()
+	{
+		uint32_t node = mRoot;
+		if (node != NONE)
+		{
+			while (mNodes[node].right != NONE)
+			{
+				node = mNodes[node].right;
+			}
+		}
+		mFurthest = node;
+	}
+
+	uint32_t OdometerIndex::NextPriority()
+	{
+		// xorshift32; only needs to be cheap and well mixed.
+		mRandomState ^= mRandomState << 13;
+		mRandomState ^= mRandomState >> 17;
+		mRandomState ^= mRandomState << 5;
+		return mRandomState;
+	}
+
+} // namespace core
+} // namespace engine
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace engine {
+namespace core {
+
+// Order-statistics index over the fleet's odometers, kept in step with the
+// TravelStateStore one node per slot. Vehicles are ranked by odometer,
+// ties going to the earlier registration (the order the old linear scan
+// preserved). Two views share the keys:
+//   treap with subtree sizes    update / insert O(log n) expected,
+//                               rank and k-th O(log n), top-K O(log n + K)
+//   slots sorted furthest first rank and k-th O(1), top-K O(K)
+// and furthest is cached, O(1) in both.
+//
+// A travel tick moves a large share of the fleet at once, where n separate
+// O(log n) updates cost far more than the tick itself. Past a threshold
+// Reconcile writes the keys in place, tracks the furthest vehicle in the same
+// pass and drops the tree. If ordered queries were made since the last
+// reconcile it re-sorts the slots in O(n) (a radix sort seeded with the
+// previous order), so a leaderboard polled every tick never sorts on a query.
+// Changes made while only the sorted view is valid are O(1) and leave the
+// sort to the next ordered query; new vehicles that rank last are appended
+// and keep it. Once changes and queries interleave between ticks, the next
+// change rebuilds the treap from the sorted slots in O(n) and the ones after
+// it are O(log n) again.
+class OdometerIndex
+{
+public:
+	static constexpr uint32_t NONE = 0xFFFFFFFFu;
+	static constexpr size_t BULK_THRESHOLD_DIVISOR = 8;
+
+	OdometerIndex();
+	~OdometerIndex() = default;
+
+	OdometerIndex(const OdometerIndex&) = delete;
+	OdometerIndex& operator=(const OdometerIndex&) = delete;
+
+	// Slots must be inserted densely: slot == current size.
+	void Insert(uint32_t slot, unsigned int odo, uint64_t sequence);
+	// Appends `count` slots in O(count), leaving the tree to the next ordered
+	// query; used when a whole fleet is loaded at once.
+	void InsertBulk(const unsigned int* odo, size_t count, uint64_t firstSequence);
+	void Update(uint32_t slot, unsigned int odo);
+	// Mirrors TravelStateStore::SwapRemove: drops `slot` and renames the last
+	// slot to `slot`.
+	void SwapRemove(uint32_t slot);
+	// Brings every key in line with the odometer column after a batch of
+	// writes, incrementally or in bulk depending on how many changed.
+	void Reconcile(const unsigned int* odo, size_t count);
+	void Reserve(size_t count);
+
+	size_t GetSize() const { return mNodes.size(); }
+
+	uint32_t GetFurthest() const;
+	// 1 = furthest travelled.
+	size_t GetRank(uint32_t slot) const;
+	uint32_t GetSlotAtRank(size_t rank) const;
+	void GetTop(size_t count, std::vector<uint32_t>& outSlots) const;
+
+private:
+	struct Node
+	{
+		unsigned int odo;
+		uint32_t priority;
+		uint64_t sequence;
+		uint32_t left;
+		uint32_t right;
+		uint32_t size;
+	};
+
+	// Ascending order: lower odometer first, later registration first on ties,
+	// so the furthest (and earliest among equals) vehicle is rightmost.
+	bool IsBefore(uint32_t a, uint32_t b) const;
+	// Tree maintenance is skipped while the tree is stale. Returns true when
+	// ordered queries should read the sorted view, sorting it if neither view
+	// is current.
+	bool EnsureOrdered() const;
+	// Called before a change: builds the tree from the sorted view when
+	// changes and queries are interleaving, and marks that view out of date.
+	void PrepareChange();
+	void BuildTree();
+	// Sorts mOrder furthest first by the current keys and renumbers mPosition.
+	void SortOrder() const;
+	// Writes mSortKeys, sorted ascending, into mOrder and mPosition.
+	void WriteOrder() const;
+	void CompactOrder();
+	void ScanFurthest() const;
+	uint32_t SizeOf(uint32_t node) const { return node == NONE ? 0 : mNodes[node].size; }
+	void Recount(uint32_t node);
+
+	void Split(uint32_t root, uint32_t pivot, uint32_t& outBefore, uint32_t& outAfter);
+	uint32_t Merge(uint32_t before, uint32_t after);
+	uint32_t InsertNode(uint32_t root, uint32_t node);
+	uint32_t EraseNode(uint32_t root, uint32_t node);
+	void RefreshFurthest();
+	uint32_t NextPriority();
+
+	// Mutable so const queries can rebuild the lazily maintained parts.
+	mutable std::vector<Node> mNodes;
+	mutable uint32_t mRoot;
+	mutable uint32_t mFurthest;
+	mutable bool mIsTreeStale;
+	mutable bool mIsFurthestStale;
+	// Set by ordered queries, cleared by the sort it brings forward.
+	mutable bool mIsRankPolled;
+	// mOrder matches the current keys exactly and holds no NONE.
+	mutable bool mIsOrderSorted;
+	// An ordered query had to sort since the last bulk reconcile.
+	mutable bool mIsTreeWanted;
+	// Every slot once, furthest first as of the last sort, with NONE left
+	// where a slot was removed since; seeds the next sort. mPosition[slot] is
+	// the slot's index in it.
+	mutable std::vector<uint32_t> mOrder;
+	mutable std::vector<uint32_t> mPosition;
+	// Sort scratch: odometer in the high half, slot in the low half.
+	mutable std::vector<uint64_t> mSortKeys;
+	mutable std::vector<uint64_t> mSortSpare;
+	uint32_t mRandomState;
+};
+
+} // namespace core
+} // namespace engine
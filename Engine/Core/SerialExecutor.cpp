@@ -0,0 +1,63 @@
+#include "SerialExecutor.h"
+#include "EngineTrace.h"
+
+namespace engine {
+namespace core {
+
+	SerialExecutor::SerialExecutor()
+		: mIsStopping(false)
+	{
+	}
+
+	SerialExecutor::~SerialExecutor()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mIsStopping = true;
+		}
+		mWakeCondition.notify_one();
+
+		if (mWorker.joinable())
+		{
+			mWorker.join();
+		}
+	}
+
+	std::future<void> SerialExecutor::Submit(std::function<void()> task)
+	{
+		std::packaged_task<void()> packaged(std::move(task));
+		std::future<void> result = packaged.get_future();
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mTasks.push_back(std::move(packaged));
+			if (!mWorker.joinable())
+			{
+				mWorker = std::thread(&SerialExecutor::WorkerLoop, this);
+			}
+		}
+		mWakeCondition.notify_one();
+		return result;
+	}
+
+	void SerialExecutor::WorkerLoop()
+	{
+		EngineTrace::SetThreadName("serial executor");
+		for (;;)
+		{
+			std::packaged_task<void()> task;
+			{
+				std::unique_lock<std::mutex> lock(mMutex);
+				mWakeCondition.wait(lock, [this] { return mIsStopping || !mTasks.empty(); });
+				if (mTasks.empty())
+				{
+					return;
+				}
+				task = std::move(mTasks.front());
+				mTasks.pop_front();
+			}
+			task();
+		}
+	}
+
+} // namespace core
+} // namespace engine
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+
+namespace engine {
+namespace core {
+
+// One background thread that runs submitted tasks in submission order. The
+// thread is started on the first Submit; the destructor finishes every task
+// already queued before joining it.
+class SerialExecutor
+{
+public:
+	SerialExecutor();
+	~SerialExecutor();
+
+	SerialExecutor(const SerialExecutor&) = delete;
+	SerialExecutor& operator=(const SerialExecutor&) = delete;
+
+	std::future<void> Submit(std::function<void()> task);
+
+private:
+	void WorkerLoop();
+
+	std::thread mWorker;
+	std::mutex mMutex;
+	std::condition_variable mWakeCondition;
+	std::deque<std::packaged_task<void()>> mTasks;
+	bool mIsStopping;
+};
+
+} // namespace core
+} // namespace engine
@@ -0,0 +1,233 @@
+#include "ShardedWorld.h"
+#include "ThreadAffinity.h"
+
+namespace engine {
+namespace core {
+
+using vehicles::Vehicle;
+
+	ShardedWorld::ShardedWorld(unsigned int shardCount, int firstCore)
+		: mContext(nullptr)
+		, mTickEpoch(0)
+		, mPendingWorkers(0)
+		, mIsStopping(false)
+	{
+		if (shardCount == 0)
+		{
+			shardCount = 1;
+		}
+
+		for (unsigned int i = 0; i < shardCount; ++i)
+		{
+			mShards.push_back(std::make_unique<DeusExMachina>());
+		}
+
+		// Shard 0 belongs to the calling thread.
+		for (unsigned int i = 1; i < shardCount; ++i)
+		{
+			int core = firstCore >= 0 ? firstCore + static_cast<int>(i) : NO_AFFINITY;
+			mWorkers.emplace_back(&ShardedWorld::WorkerLoop, this, i, core);
+		}
+	}
+
+	ShardedWorld::~ShardedWorld()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mIsStopping = true;
+		}
+		mWorkerWake.notify_all();
+
+		for (std::thread& worker : mWorkers)
+		{
+			worker.join();
+		}
+	}
+
+	void ShardedWorld::Travel(const TravelContext& context)
+	{
+		if (!mWorkers.empty())
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mContext = &context;
+			mPendingWorkers = static_cast<unsigned int>(mWorkers.size());
+			++mTickEpoch;
+		}
+		mWorkerWake.notify_all();
+
+		mShards[0]->Travel(context);
+
+		std::unique_lock<std::mutex> lock(mMutex);
+		mWorkersDone.wait(lock, [this]() { return mPendingWorkers == 0; });
+		mContext = nullptr;
+	}
+
+	void ShardedWorld::WorkerLoop(unsigned int shard, int core)
+	{
+		if (core >= 0)
+		{
+			PinCurrentThreadToCore(static_cast<unsigned int>(core));
+		}
+
+		unsigned long long seenEpoch = 0;
+		std::unique_lock<std::mutex> lock(mMutex);
+		for (;;)
+		{
+			mWorkerWake.wait(lock, [this, seenEpoch]() { return mIsStopping || mTickEpoch != seenEpoch; });
+			if (mIsStopping)
+			{
+				return;
+			}
+			seenEpoch = mTickEpoch;
+			const TravelContext* context = mContext;
+
+			lock.unlock();
+			mShards[shard]->Travel(*context);
+			lock.lock();
+
+			if (--mPendingWorkers == 0)
+			{
+				mWorkersDone.notify_one();
+			}
+		}
+	}
+
+	bool ShardedWorld::AddVehicle(std::unique_ptr<Vehicle> vehicle, ShardedHandle* outHandle)
+	{
+		uint32_t shard = PickShard();
+		VehicleHandle handle;
+		if (!mShards[shard]->AddVehicle(std::move(vehicle), &handle))
+		{
+			return false;
+		}
+
+		if (outHandle != nullptr)
+		{
+			*outHandle = ShardedHandle(shard, handle);
+		}
+		return true;
+	}
+
+	bool ShardedWorld::RemoveVehicle(ShardedHandle handle)
+	{
+		if (handle.shard >= mShards.size())
+		{
+			return false;
+		}
+		return mShards[handle.shard]->RemoveVehicle(handle.handle);
+	}
+
+	Vehicle* ShardedWorld::GetVehicle(ShardedHandle handle) const
+	{
+		if (handle.shard >= mShards.size())
+		{
+			return nullptr;
+		}
+		return mShards[handle.shard]->GetVehicle(handle.handle);
+	}
+
+	bool ShardedWorld::IsValid(ShardedHandle handle) const
+	{
+		return handle.shard < mShards.size() && mShards[handle.shard]->IsValid(handle.handle);
+	}
+
+	size_t ShardedWorld::GetVehicleCount() const
+	{
+		size_t count = 0;
+		for (const std::unique_ptr<DeusExMachina>& shard : mShards)
+		{
+			count += shard->GetVehicleCount();
+		}
+		return count;
+	}
+
+	void ShardedWorld::ReserveVehicles(size_t count)
+	{
+		size_t perShard = (count + mShards.size() - 1) / mShards.size();
+		for (std::unique_ptr<DeusExMachina>& shard : mShards)
+		{
+			shard->ReserveVehicles(perShard);
+		}
+	}
+
+	const Vehicle* ShardedWorld::GetFurthestTravelled() const
+	{
+		const Vehicle* furthest = nullptr;
+		for (const std::unique_ptr<DeusExMachina>& shard : mShards)
+		{
+			const Vehicle* candidate = shard->GetFurthestTravelled();
+			if (candidate != nullptr && (furthest == nullptr || candidate->GetOdo() > furthest->GetOdo()))
+			{
+				furthest = candidate;
+			}
+		}
+		return furthest;
+	}
+
+	std::vector<const Vehicle*> ShardedWorld::GetTopTravelled(size_t count) const
+	{
+		// Each shard's top `count` is already ordered; merge them.
+		std::vector<std::vector<const Vehicle*>> shardTops;
+		shardTops.reserve(mShards.size());
+		for (const std::unique_ptr<DeusExMachina>& shard : mShards)
+		{
+			shardTops.push_back(shard->GetTopTravelled(count));
+		}
+
+		std::vector<size_t> next(mShards.size(), 0);
+		std::vector<const Vehicle*> top;
+		top.reserve(count);
+		while (top.size() < count)
+		{
+			size_t best = mShards.size();
+			for (size_t shard = 0; shard < shardTops.size(); ++shard)
+			{
+				if (next[shard] == shardTops[shard].size())
+				{
+					continue;
+				}
+				if (best == mShards.size() || shardTops[shard][next[shard]]->GetOdo() > shardTops[best][next[best]]->GetOdo())
+				{
+					best = shard;
+				}
+			}
+
+			if (best == mShards.size())
+			{
+				break;
+			}
+			top.push_back(shardTops[best][next[best]++]);
+		}
+		return top;
+	}
+
+	unsigned int ShardedWorld::GetShardCount() const
+	{
+		return static_cast<unsigned int>(mShards.size());
+	}
+
+	DeusExMachina& ShardedWorld::GetShard(unsigned int shard)
+	{
+		return *mShards[shard];
+	}
+
+	const DeusExMachina& ShardedWorld::GetShard(unsigned int shard) const
+	{
+		return *mShards[shard];
+	}
+
+	uint32_t ShardedWorld::PickShard() const
+	{
+		uint32_t best = 0;
+		for (uint32_t shard = 1; shard < mShards.size(); ++shard)
+		{
+			if (mShards[shard]->GetVehicleCount() < mShards[best]->GetVehicleCount())
+			{
+				best = shard;
+			}
+		}
+		return best;
+	}
+
+} // namespace core
+} // namespace engine
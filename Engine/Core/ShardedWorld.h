@@ -0,0 +1,116 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "DeusExMachina.h"
+#include "TravelContext.h"
+#include "VehicleHandle.h"
+
+namespace engine {
+namespace core {
+
+// A vehicle in a ShardedWorld: which shard holds it, and its handle there.
+struct ShardedHandle
+{
+	uint32_t shard;
+	VehicleHandle handle;
+
+	ShardedHandle()
+		: shard(0)
+	{
+	}
+
+	ShardedHandle(uint32_t s, VehicleHandle h)
+		: shard(s)
+		, handle(h)
+	{
+	}
+
+	bool IsNull() const { return handle.IsNull(); }
+
+	bool operator==(const ShardedHandle& rhs) const { return shard == rhs.shard && handle == rhs.handle; }
+	bool operator!=(const ShardedHandle& rhs) const { return !(*this == rhs); }
+};
+
+// One logical fleet split across independent DeusExMachina shards. Travel
+// advances every shard at once, one thread per shard; the shards share no
+// state, so there is nothing to synchronise beyond the start and the end of
+// the tick. Leaderboard queries are answered per shard and merged.
+//
+// Shard 0 travels on the calling thread; shards 1..N-1 each have a dedicated
+// thread, optionally pinned to cores firstCore + 1 .. firstCore + N - 1 so a
+// shard's travel state stays in one core's cache. Not thread-safe itself:
+// drive it from one thread.
+class ShardedWorld
+{
+public:
+	static constexpr int NO_AFFINITY = -1;
+
+	explicit ShardedWorld(unsigned int shardCount, int firstCore = NO_AFFINITY);
+	~ShardedWorld();
+
+	ShardedWorld(const ShardedWorld&) = delete;
+	ShardedWorld& operator=(const ShardedWorld&) = delete;
+
+	void Travel(const TravelContext& context);
+
+	// Places the vehicle on the shard holding the fewest.
+	bool AddVehicle(std::unique_ptr<vehicles::Vehicle> vehicle, ShardedHandle* outHandle = nullptr);
+	template <typename T>
+	bool AddVehicle(std::unique_ptr<T> vehicle, ShardedHandle* outHandle = nullptr);
+	bool RemoveVehicle(ShardedHandle handle);
+	vehicles::Vehicle* GetVehicle(ShardedHandle handle) const;
+	bool IsValid(ShardedHandle handle) const;
+	size_t GetVehicleCount() const;
+	// Reserves an even share of `count` on every shard.
+	void ReserveVehicles(size_t count);
+
+	// Ties between shards go to the lower shard index.
+	const vehicles::Vehicle* GetFurthestTravelled() const;
+	std::vector<const vehicles::Vehicle*> GetTopTravelled(size_t count) const;
+
+	unsigned int GetShardCount() const;
+	// For per-shard setup (journals, travel threads) and queries.
+	DeusExMachina& GetShard(unsigned int shard);
+	const DeusExMachina& GetShard(unsigned int shard) const;
+
+private:
+	uint32_t PickShard() const;
+	void WorkerLoop(unsigned int shard, int core);
+
+	std::vector<std::unique_ptr<DeusExMachina>> mShards;
+	std::vector<std::thread> mWorkers;
+	std::mutex mMutex;
+	std::condition_variable mWorkerWake;
+	std::condition_variable mWorkersDone;
+	const TravelContext* mContext;
+	unsigned long long mTickEpoch;
+	unsigned int mPendingWorkers;
+	bool mIsStopping;
+};
+
+template <typename T>
+bool ShardedWorld::AddVehicle(std::unique_ptr<T> vehicle, ShardedHandle* outHandle)
+{
+	uint32_t shard = PickShard();
+	VehicleHandle handle;
+	if (!mShards[shard]->AddVehicle(std::move(vehicle), &handle))
+	{
+		return false;
+	}
+
+	if (outHandle != nullptr)
+	{
+		*outHandle = ShardedHandle(shard, handle);
+	}
+	return true;
+}
+
+} // namespace core
+} // namespace engine
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace engine {
+namespace core {
+
+// Move-only vector that keeps its first N elements inside the object and only
+// goes to the heap beyond that, doubling as it grows. An empty or small
+// SmallVector never allocates.
+template <typename T, size_t N>
+class SmallVector
+{
+	static_assert(N > 0, "SmallVector needs at least one inline slot");
+
+public:
+	SmallVector()
+		: mData(GetInlineData())
+		, mSize(0)
+		, mCapacity(static_cast<uint32_t>(N))
+	{
+	}
+
+	~SmallVector()
+	{
+		Clear();
+		FreeHeap();
+	}
+
+	SmallVector(const SmallVector&) = delete;
+	SmallVector& operator=(const SmallVector&) = delete;
+
+	SmallVector(SmallVector&& other) noexcept
+		: SmallVector()
+	{
+		TakeFrom(other);
+	}
+
+	SmallVector& operator=(SmallVector&& rhs) noexcept
+	{
+		if (this != &rhs)
+		{
+			Clear();
+			FreeHeap();
+			TakeFrom(rhs);
+		}
+		return *this;
+	}
+
+	T* begin() { return mData; }
+	T* end() { return mData + mSize; }
+	const T* begin() const { return mData; }
+	const T* end() const { return mData + mSize; }
+
+	T& operator[](size_t i) { return mData[i]; }
+	const T& operator[](size_t i) const { return mData[i]; }
+	T& GetBack() { return mData[mSize - 1]; }
+
+	size_t GetSize() const { return mSize; }
+	size_t GetCapacity() const { return mCapacity; }
+	bool IsEmpty() const { return mSize == 0; }
+	bool IsInline() const { return mData == GetInlineData(); }
+
+	void Reserve(size_t capacity)
+	{
+		if (capacity > mCapacity)
+		{
+			Reallocate(capacity);
+		}
+	}
+
+	void PushBack(T&& value)
+	{
+		if (mSize == mCapacity)
+		{
+			Reallocate(static_cast<size_t>(mCapacity) * 2);
+		}
+		new (mData + mSize) T(std::move(value));
+		++mSize;
+	}
+
+	// Shifts the later elements down one, keeping their order.
+	void Erase(size_t i)
+	{
+		for (size_t next = i + 1; next < mSize; ++next)
+		{
+			mData[next - 1] = std::move(mData[next]);
+		}
+		PopBack();
+	}
+
+	// Moves the last element into `i`; O(1) but reorders.
+	void SwapRemove(size_t i)
+	{
+		if (i != mSize - 1)
+		{
+			mData[i] = std::move(mData[mSize - 1]);
+		}
+		PopBack();
+	}
+
+	void PopBack()
+	{
+		--mSize;
+		mData[mSize].~T();
+	}
+
+	// Keeps the capacity, like std::vector::clear.
+	void Clear()
+	{
+		while (mSize > 0)
+		{
+			PopBack();
+		}
+	}
+
+	// Clears and hands any heap block back, returning to inline storage.
+	void Reset()
+	{
+		Clear();
+		FreeHeap();
+	}
+
+private:
+	T* GetInlineData() { return reinterpret_cast<T*>(mInline); }
+	const T* GetInlineData() const { return reinterpret_cast<const T*>(mInline); }
+
+	void Reallocate(size_t capacity)
+	{
+		T* data = std::allocator<T>().allocate(capacity);
+		for (size_t i = 0; i < mSize; ++i)
+		{
+			new (data + i) T(std::move(mData[i]));
+			mData[i].~T();
+		}
+		if (!IsInline())
+		{
+			std::allocator<T>().deallocate(mData, mCapacity);
+		}
+		mData = data;
+		mCapacity = static_cast<uint32_t>(capacity);
+	}
+
+	// Leaves an empty vector on inline storage; elements must already be gone.
+	void FreeHeap()
+	{
+		if (!IsInline())
+		{
+			std::allocator<T>().deallocate(mData, mCapacity);
+			mData = GetInlineData();
+			mCapacity = static_cast<uint32_t>(N);
+		}
+	}
+
+	// Steals a heap block outright; inline elements have to be moved.
+	void TakeFrom(SmallVector& other)
+	{
+		if (!other.IsInline())
+		{
+			mData = other.mData;
+			mCapacity = other.mCapacity;
+			mSize = other.mSize;
+			other.mData = other.GetInlineData();
+			other.mCapacity = static_cast<uint32_t>(N);
+			other.mSize = 0;
+			return;
+		}
+
+		for (size_t i = 0; i < other.mSize; ++i)
+		{
+			new (mData + i) T(std::move(other.mData[i]));
+		}
+		mSize = other.mSize;
+		other.Clear();
+	}
+
+	T* mData;
+	uint32_t mSize;
+	uint32_t mCapacity;
+	alignas(T) unsigned char mInline[N * sizeof(T)];
+};
+
+} // namespace core
+} // namespace engine
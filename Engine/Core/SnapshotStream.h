@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace engine {
+namespace core {
+
+// Type-specific vehicle state (capability parameters, attachments) travels
+// through a fleet snapshot as a short run of 32-bit words. A vehicle writes
+// them in WriteSnapshot and reads them back in the same order in ReadSnapshot.
+class SnapshotWriter
+{
+public:
+	explicit SnapshotWriter(std::vector<uint32_t>& words)
+		: mWords(words)
+	{
+	}
+
+	void Write(uint32_t value) { mWords.push_back(value); }
+
+private:
+	std::vector<uint32_t>& mWords;
+};
+
+class SnapshotReader
+{
+public:
+	SnapshotReader(const uint32_t* words, size_t count)
+		: mWords(words)
+		, mCount(count)
+		, mPosition(0)
+	{
+	}
+
+	// False once the vehicle's words are exhausted (a truncated record).
+	bool Read(uint32_t& outValue)
+	{
+		if (mPosition >= mCount)
+		{
+			return false;
+		}
+		outValue = mWords[mPosition++];
+		return true;
+	}
+
+	bool IsAtEnd() const { return mPosition == mCount; }
+
+private:
+	const uint32_t* mWords;
+	size_t mCount;
+	size_t mPosition;
+};
+
+} // namespace core
+} // namespace engine
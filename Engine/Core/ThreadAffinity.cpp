@@ -0,0 +1,37 @@
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "ThreadAffinity.h"
+
+namespace engine {
+namespace core {
+
+	bool PinCurrentThreadToCore(unsigned int core)
+	{
+#if defined(_WIN32)
+		if (core >= sizeof(DWORD_PTR) * 8)
+		{
+			return false;
+		}
+		return SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << core) != 0;
+#elif defined(__linux__)
+		if (core >= CPU_SETSIZE)
+		{
+			return false;
+		}
+		cpu_set_t cores;
+		CPU_ZERO(&cores);
+		CPU_SET(core, &cores);
+		return pthread_setaffinity_np(pthread_self(), sizeof(cores), &cores) == 0;
+#else
+		(void)core;
+		return false;
+#endif
+	}
+
+} // namespace core
+} // namespace engine
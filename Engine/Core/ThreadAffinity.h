@@ -0,0 +1,12 @@
+#pragma once
+
+namespace engine {
+namespace core {
+
+// Restricts the calling thread to one logical core. Returns false where the
+// platform offers no affinity control or the core does not exist; the thread
+// then keeps running wherever the scheduler puts it.
+bool PinCurrentThreadToCore(unsigned int core);
+
+} // namespace core
+} // namespace engine
@@ -0,0 +1,44 @@
+#include "TravelBucket.h"
+
+namespace engine {
+namespace core {
+
+	TravelBucket::TravelBucket(uint32_t metricsType)
+		: mMetricsType(metricsType)
+	{
+	}
+
+	uint32_t TravelBucket::Add(vehicles::Vehicle* vehicle, uint32_t denseIndex)
+	{
+		mVehicles.push_back(vehicle);
+		mDenseIndices.push_back(denseIndex);
+		return static_cast<uint32_t>(mVehicles.size() - 1);
+	}
+
+	uint32_t TravelBucket::SwapRemove(uint32_t position)
+	{
+		uint32_t last = static_cast<uint32_t>(mVehicles.size() - 1);
+		uint32_t moved = NONE;
+		if (position != last)
+		{
+			mVehicles[position] = mVehicles[last];
+			mDenseIndices[position] = mDenseIndices[last];
+			moved = mDenseIndices[position];
+		}
+		mVehicles.pop_back();
+		mDenseIndices.pop_back();
+		return moved;
+	}
+
+	void TravelBucket::SetDenseIndex(uint32_t position, uint32_t denseIndex)
+	{
+		mDenseIndices[position] = denseIndex;
+	}
+
+	size_t TravelBucket::GetSize() const
+	{
+		return mVehicles.size();
+	}
+
+} // namespace core
+} // namespace engine
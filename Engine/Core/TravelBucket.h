@@ -0,0 +1,194 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "DutyCycle.h"
+#include "EngineMetrics.h"
+#include "TravelContext.h"
+#include "TravelStateStore.h"
+#include "../Vehicles/Vehicle.h"
+
+namespace engine {
+namespace core {
+
+// A homogeneous run of vehicles that Travel walks in one tight loop. Each
+// entry remembers its dense registry index so removal can be O(1).
+class TravelBucket
+{
+public:
+	static constexpr uint32_t NONE = 0xFFFFFFFFu;
+
+	virtual ~TravelBucket() = default;
+
+	// Entries' travel state lives in `travelState` at their dense index.
+	virtual void TravelRange(const TravelContext& context, TravelStateStore& travelState, size_t begin, size_t end) const = 0;
+	// Buckets whose vehicles follow a fixed duty cycle can be settled lazily
+	// instead of travelled; see TravelStateStore::SetLazy.
+	virtual bool HasDutyCycle() const { return false; }
+	virtual bool GetDutyCycle(size_t, unsigned int&, unsigned int&) const { return false; }
+
+	uint32_t Add(vehicles::Vehicle* vehicle, uint32_t denseIndex);
+	// Swap-and-pop; returns the dense index of the entry that moved into
+	// `position`, or NONE if the removed entry was last.
+	uint32_t SwapRemove(uint32_t position);
+	void SetDenseIndex(uint32_t position, uint32_t denseIndex);
+	size_t GetSize() const;
+
+protected:
+	explicit TravelBucket(uint32_t metricsType);
+
+	// Called once per range, so metrics cost nothing per vehicle beyond the
+	// moving count.
+	void RecordTravelled(size_t count, uint64_t moving) const { EngineMetrics::AddTravelled(mMetricsType, count, moving); }
+
+	std::vector<vehicles::Vehicle*> mVehicles;
+	std::vector<uint32_t> mDenseIndices;
+	uint32_t mMetricsType;
+};
+
+template <typename T, typename = void>
+struct HasTravelPolicy : std::false_type
+{
+};
+
+template <typename T>
+struct HasTravelPolicy<T, std::void_t<typename T::TravelPolicy>> : std::true_type
+{
+};
+
+// Bucket for one concrete Game vehicle type. The qualified call binds
+// TravelByMachina statically, so the loop carries no per-vehicle virtual
+// dispatch and the compiler may inline the body where it is visible.
+//
+// Types that declare a TravelPolicy are advanced by the bucket itself: one
+// policy Batch per range, applied straight to the travel state columns. Such
+// types must travel exactly by their policy (TravelByPolicy<T>).
+template <typename T>
+class TypedTravelBucket final : public TravelBucket
+{
+public:
+	TypedTravelBucket()
+		: TravelBucket(EngineMetrics::RegisterType(typeid(T)))
+	{
+	}
+
+	virtual void TravelRange(const TravelContext& context, TravelStateStore& travelState, size_t begin, size_t end) const override
+	{
+		TravelRangeImpl(context, travelState, begin, end, HasTravelPolicy<T>());
+	}
+
+	virtual bool HasDutyCycle() const override
+	{
+		return HasTravelPolicy<T>::value;
+	}
+
+	virtual bool GetDutyCycle(size_t position, unsigned int& outMoveTime, unsigned int& outIdleTime) const override
+	{
+		return GetDutyCycleImpl(position, outMoveTime, outIdleTime, HasTravelPolicy<T>());
+	}
+
+private:
+	bool GetDutyCycleImpl(size_t, unsigned int&, unsigned int&, std::false_type) const
+	{
+		return false;
+	}
+
+	bool GetDutyCycleImpl(size_t position, unsigned int& outMoveTime, unsigned int& outIdleTime, std::true_type) const
+	{
+		const T& vehicle = *static_cast<const T*>(mVehicles[position]);
+		outMoveTime = T::TravelPolicy::MOVE_TIME;
+		outIdleTime = T::TravelPolicy::GetIdleTime(vehicle);
+		return true;
+	}
+
+	void TravelRangeImpl(const TravelContext& context, TravelStateStore& travelState, size_t begin, size_t end, std::false_type) const
+	{
+		uint64_t moving = 0;
+		for (size_t i = begin; i < end; ++i)
+		{
+			if constexpr (EngineMetrics::IS_ENABLED)
+			{
+				unsigned int odo = travelState.GetOdo(mDenseIndices[i]);
+				static_cast<T*>(mVehicles[i])->T::TravelByMachina(context);
+				moving += travelState.GetOdo(mDenseIndices[i]) != odo;
+			}
+			else
+			{
+				static_cast<T*>(mVehicles[i])->T::TravelByMachina(context);
+			}
+		}
+		RecordTravelled(end - begin, moving);
+	}
+
+	void TravelRangeImpl(const TravelContext& context, TravelStateStore& travelState, size_t begin, size_t end, std::true_type) const
+	{
+		const typename T::TravelPolicy::Batch batch(context.hours);
+		uint64_t moving = 0;
+		for (size_t i = begin; i < end; ++i)
+		{
+			const T& vehicle = *static_cast<const T*>(mVehicles[i]);
+			uint32_t slot = mDenseIndices[i];
+
+			DutyCycleState state{ travelState.GetOdo(slot), travelState.GetMoveTime(slot), travelState.GetIdleTime(slot) };
+			DutyCycleState next = batch.Advance(vehicle, state, vehicle.GetMaxSpeed());
+			travelState.SetOdo(slot, next.odo);
+			travelState.SetMoveTime(slot, next.moveTime);
+			travelState.SetIdleTime(slot, next.idleTime);
+			if constexpr (EngineMetrics::IS_ENABLED)
+			{
+				moving += next.odo != state.odo;
+			}
+		}
+		RecordTravelled(end - begin, moving);
+	}
+};
+
+// Fallback for vehicles whose concrete type was never registered.
+class VirtualTravelBucket final : public TravelBucket
+{
+public:
+	VirtualTravelBucket()
+		: TravelBucket(EngineMetrics::RegisterType("(unregistered types)"))
+	{
+	}
+
+	virtual void TravelRange(const TravelContext& context, TravelStateStore& travelState, size_t begin, size_t end) const override
+	{
+		uint64_t moving = 0;
+		for (size_t i = begin; i < end; ++i)
+		{
+			if constexpr (EngineMetrics::IS_ENABLED)
+			{
+				unsigned int odo = travelState.GetOdo(mDenseIndices[i]);
+				mVehicles[i]->TravelByMachina(context);
+				moving += travelState.GetOdo(mDenseIndices[i]) != odo;
+			}
+			else
+			{
+				mVehicles[i]->TravelByMachina(context);
+			}
+		}
+		RecordTravelled(end - begin, moving);
+	}
+};
+
+// The bucket RegisterVehicleType gives T: TypedTravelBucket<T>, unless T
+// brings its own as `using TravelBucketType = ...;` (a default-constructible
+// TravelBucket that knows how to travel T).
+template <typename T, typename = void>
+struct TravelBucketOf
+{
+	typedef TypedTravelBucket<T> Type;
+};
+
+template <typename T>
+struct TravelBucketOf<T, std::void_t<typename T::TravelBucketType>>
+{
+	typedef typename T::TravelBucketType Type;
+};
+
+} // namespace core
+} // namespace engine
@@ -0,0 +1,242 @@
+#include <limits>
+
+#include "TravelStateStore.h"
+
+namespace engine {
+namespace core {
+
+	TravelStateStore::TravelStateStore()
+		: mNextSequence(0)
+		, mIsBatchingOdo(false)
+		, mClock(0)
+		, mIsSettled(true)
+		, mIsLazy(false)
+	{
+	}
+
+	unsigned int TravelStateStore::Allocate(unsigned int odo, unsigned int moveTime, unsigned int idleTime)
+	{
+		unsigned int slot = static_cast<unsigned int>(mOdo.size());
+		mOdo.push_back(odo);
+		mMoveTime.push_back(moveTime);
+		mIdleTime.push_back(idleTime);
+		mMaxSpeed.push_back(0);
+		mIsMaxSpeedValid.push_back(0);
+		mIsSpeedChangeQueued.push_back(0);
+		mOdoIndex.Insert(slot, odo, mNextSequence++);
+		PushAnchors(1);
+		return slot;
+	}
+
+	unsigned int TravelStateStore::AllocateBulk(const unsigned int* odo, const unsigned int* moveTime, const unsigned int* idleTime, size_t count)
+	{
+		unsigned int first = static_cast<unsigned int>(mOdo.size());
+		mOdo.insert(mOdo.end(), odo, odo + count);
+		mMoveTime.insert(mMoveTime.end(), moveTime, moveTime + count);
+		mIdleTime.insert(mIdleTime.end(), idleTime, idleTime + count);
+		mMaxSpeed.resize(mMaxSpeed.size() + count, 0);
+		mIsMaxSpeedValid.resize(mIsMaxSpeedValid.size() + count, 0);
+		mIsSpeedChangeQueued.resize(mIsSpeedChangeQueued.size() + count, 0);
+		mOdoIndex.InsertBulk(odo, count, mNextSequence);
+		mNextSequence += count;
+		PushAnchors(count);
+		return first;
+	}
+
+	void TravelStateStore::SwapRemove(unsigned int slot)
+	{
+		mOdoIndex.SwapRemove(slot);
+
+		size_t last = mOdo.size() - 1;
+		mOdo[slot] = mOdo[last];
+		mMoveTime[slot] = mMoveTime[last];
+		mIdleTime[slot] = mIdleTime[last];
+		mMaxSpeed[slot] = mMaxSpeed[last];
+		mIsMaxSpeedValid[slot] = mIsMaxSpeedValid[last];
+		mIsSpeedChangeQueued[slot] = mIsSpeedChangeQueued[last];
+		if (slot != last && mIsSpeedChangeQueued[slot] != 0)
+		{
+			mSpeedChangedSlots.push_back(slot);
+		}
+
+		if (mIsLazy)
+		{
+			// A queued last slot is queued under its old number; requeue it.
+			mAnchors[slot] = mAnchors[last];
+			mAnchors.pop_back();
+			if (slot != last && mAnchors[slot].isStale)
+			{
+				mStaleSlots.push_back(slot);
+			}
+		}
+
+		mOdo.pop_back();
+		mMoveTime.pop_back();
+		mIdleTime.pop_back();
+		mMaxSpeed.pop_back();
+		mIsMaxSpeedValid.pop_back();
+		mIsSpeedChangeQueued.pop_back();
+	}
+
+	void TravelStateStore::Reserve(size_t count)
+	{
+		mOdo.reserve(count);
+		mMoveTime.reserve(count);
+		mIdleTime.reserve(count);
+		mMaxSpeed.reserve(count);
+		mIsMaxSpeedValid.reserve(count);
+		mIsSpeedChangeQueued.reserve(count);
+		mOdoIndex.Reserve(count);
+		if (mIsLazy)
+		{
+			mAnchors.reserve(count);
+		}
+	}
+
+	void TravelStateStore::BeginOdoBatch()
+	{
+		mIsBatchingOdo = true;
+	}
+
+	void TravelStateStore::EndOdoBatch()
+	{
+		mIsBatchingOdo = false;
+		if (mIsLazy)
+		{
+			mIsSettled = false;
+			return;
+		}
+		mOdoIndex.Reconcile(mOdo.data(), mOdo.size());
+	}
+
+	void TravelStateStore::SetLazy(bool isLazy)
+	{
+		if (isLazy == mIsLazy)
+		{
+			return;
+		}
+
+		if (!isLazy)
+		{
+			SettleAll();
+			mAnchors.clear();
+			mAnchors.shrink_to_fit();
+			mStaleSlots.clear();
+			mStaleSlots.shrink_to_fit();
+			mIsLazy = false;
+			return;
+		}
+
+		mIsLazy = true;
+		mIsSettled = true;
+		PushAnchors(mOdo.size());
+	}
+
+	void TravelStateStore::SettleSlot(unsigned int slot)
+	{
+		SlotAnchor& anchor = mAnchors[slot];
+		DutyCycleState state{ mOdo[slot], mMoveTime[slot], mIdleTime[slot] };
+		uint64_t elapsed = mClock - anchor.tick;
+		while (elapsed > 0)
+		{
+			unsigned int hours = elapsed > std::numeric_limits<unsigned int>::max() ? std::numeric_limits<unsigned int>::max() : static_cast<unsigned int>(elapsed);
+			state = AdvanceDutyCycle(state, hours, anchor.moveTime, anchor.idleTime, anchor.speed);
+			elapsed -= hours;
+		}
+
+		mOdo[slot] = state.odo;
+		mMoveTime[slot] = state.moveTime;
+		mIdleTime[slot] = state.idleTime;
+		anchor.tick = mClock;
+	}
+
+	void TravelStateStore::SettleAll()
+	{
+		if (!mIsLazy || mIsSettled)
+		{
+			return;
+		}
+
+		for (size_t slot = 0; slot < mOdo.size(); ++slot)
+		{
+			Settle(static_cast<unsigned int>(slot));
+		}
+		mOdoIndex.Reconcile(mOdo.data(), mOdo.size());
+		mIsSettled = true;
+	}
+
+	void TravelStateStore::Anchor(unsigned int slot, unsigned int moveTime, unsigned int idleTime, unsigned int speed)
+	{
+		SlotAnchor& anchor = mAnchors[slot];
+		anchor.moveTime = moveTime;
+		anchor.idleTime = idleTime;
+		anchor.speed = speed;
+	}
+
+	void TravelStateStore::TakeStaleSlots(std::vector<uint32_t>& outSlots)
+	{
+		outSlots.clear();
+		for (uint32_t slot : mStaleSlots)
+		{
+			// Removals can leave numbers behind that no longer exist or were
+			// already handed out under a duplicate entry.
+			if (slot < mAnchors.size() && mAnchors[slot].isStale)
+			{
+				mAnchors[slot].isStale = false;
+				outSlots.push_back(slot);
+			}
+		}
+		mStaleSlots.clear();
+	}
+
+	void TravelStateStore::TakeSpeedChangedSlots(std::vector<uint32_t>& outSlots)
+	{
+		outSlots.clear();
+		for (uint32_t slot : mSpeedChangedSlots)
+		{
+			// Same leftovers as the stale queue after removals.
+			if (slot < mIsSpeedChangeQueued.size() && mIsSpeedChangeQueued[slot] != 0)
+			{
+				mIsSpeedChangeQueued[slot] = 0;
+				outSlots.push_back(slot);
+			}
+		}
+		mSpeedChangedSlots.clear();
+	}
+
+	void TravelStateStore::MarkStale(unsigned int slot)
+	{
+		Settle(slot);
+		SlotAnchor& anchor = mAnchors[slot];
+		anchor.moveTime = 0;
+		anchor.idleTime = 0;
+		anchor.speed = 0;
+		if (!anchor.isStale)
+		{
+			anchor.isStale = true;
+			mStaleSlots.push_back(slot);
+		}
+	}
+
+	void TravelStateStore::PushAnchors(size_t count)
+	{
+		if (!mIsLazy)
+		{
+			return;
+		}
+
+		size_t first = mAnchors.size();
+		mAnchors.resize(first + count, SlotAnchor{ mClock, 0, 0, 0, true });
+		for (size_t slot = first; slot < mAnchors.size(); ++slot)
+		{
+			mStaleSlots.push_back(static_cast<uint32_t>(slot));
+		}
+	}
+
+	size_t TravelStateStore::GetSize() const
+	{
+		return mOdo.size();
+	}
+
+} // namespace core
+} // namespace engine
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "DutyCycle.h"
+#include "OdometerIndex.h"
+
+namespace engine {
+namespace core {
+
+// Structure-of-arrays storage for the per-tick travel state of every vehicle
+// owned by DeusExMachina. Each registered vehicle is bound to one slot; its
+// odometer, move/idle timers and memoized max speed live in these contiguous
+// columns instead of inside the (heap-scattered) Vehicle object.
+class TravelStateStore
+{
+public:
+	TravelStateStore();
+	~TravelStateStore() = default;
+
+	TravelStateStore(const TravelStateStore&) = delete;
+	TravelStateStore& operator=(const TravelStateStore&) = delete;
+
+	unsigned int Allocate(unsigned int odo, unsigned int moveTime, unsigned int idleTime);
+	// Appends `count` slots straight from column data; returns the first one.
+	unsigned int AllocateBulk(const unsigned int* odo, const unsigned int* moveTime, const unsigned int* idleTime, size_t count);
+	// Moves the last slot into `slot` and shrinks by one, mirroring the
+	// registry's swap-and-pop so slot == dense vehicle index at all times.
+	void SwapRemove(unsigned int slot);
+	void Reserve(size_t count);
+	size_t GetSize() const;
+
+	// Hot-path accessors, kept inline so per-vehicle travel compiles down to
+	// plain array loads and stores. In lazy mode they see the slot as of its
+	// anchor; Settle it first for the current state.
+	unsigned int GetOdo(unsigned int slot) const { return mOdo[slot]; }
+	unsigned int GetMoveTime(unsigned int slot) const { return mMoveTime[slot]; }
+	unsigned int GetIdleTime(unsigned int slot) const { return mIdleTime[slot]; }
+
+	void SetOdo(unsigned int slot, unsigned int odo)
+	{
+		mOdo[slot] = odo;
+		if (!mIsBatchingOdo)
+		{
+			mOdoIndex.Update(slot, odo);
+		}
+	}
+	void SetMoveTime(unsigned int slot, unsigned int moveTime) { mMoveTime[slot] = moveTime; }
+	void SetIdleTime(unsigned int slot, unsigned int idleTime) { mIdleTime[slot] = idleTime; }
+
+	// Memoized Vehicle::GetMaxSpeed. Slots start out stale and are refilled on
+	// the next read after an invalidation.
+	bool IsMaxSpeedValid(unsigned int slot) const { return mIsMaxSpeedValid[slot] != 0; }
+	unsigned int GetMaxSpeed(unsigned int slot) const { return mMaxSpeed[slot]; }
+	void SetMaxSpeed(unsigned int slot, unsigned int speed) { mMaxSpeed[slot] = speed; mIsMaxSpeedValid[slot] = 1; }
+	void InvalidateMaxSpeed(unsigned int slot)
+	{
+		mIsMaxSpeedValid[slot] = 0;
+		if (mIsSpeedChangeQueued[slot] == 0)
+		{
+			mIsSpeedChangeQueued[slot] = 1;
+			mSpeedChangedSlots.push_back(slot);
+		}
+		if (mIsLazy)
+		{
+			MarkStale(slot);
+		}
+	}
+
+	// Hands over every slot invalidated since the last call, once each, and
+	// clears the queue; lets the engine refresh what it derives from speeds.
+	void TakeSpeedChangedSlots(std::vector<uint32_t>& outSlots);
+
+	// While batching, odometer writes skip the index; EndOdoBatch reconciles
+	// every changed slot in one serial pass. Travel brackets its (possibly
+	// parallel) fleet walk with these so vehicles never touch the shared index.
+	// In lazy mode the reconcile is left to the next SettleAll.
+	void BeginOdoBatch();
+	void EndOdoBatch();
+	const OdometerIndex& GetOdometerIndex() const { return mOdoIndex; }
+
+	// Lazy mode: slots with a known duty cycle are anchored instead of
+	// travelled. Their columns hold the state at the anchor tick, and Settle
+	// brings them up to the store clock in O(1) with the cycle (move and idle
+	// time, speed) captured when they were anchored. Slots that are new, or
+	// whose max speed was invalidated, are settled and queued; the engine
+	// re-anchors them from the vehicle before the clock next moves. Until
+	// then, and for vehicles without a duty cycle, the anchored cycle is
+	// empty and settling leaves the state alone.
+	void SetLazy(bool isLazy);
+	bool IsLazy() const { return mIsLazy; }
+	uint64_t GetClock() const { return mClock; }
+	void AdvanceClock(unsigned int hours)
+	{
+		mClock += hours;
+		mIsSettled = false;
+	}
+	void Settle(unsigned int slot)
+	{
+		if (mIsLazy && mAnchors[slot].tick != mClock)
+		{
+			SettleSlot(slot);
+		}
+	}
+	// Settles every slot and reconciles the odometer index; a no-op until the
+	// clock moves or a batch ends again.
+	void SettleAll();
+	// `slot` must be settled.
+	void Anchor(unsigned int slot, unsigned int moveTime, unsigned int idleTime, unsigned int speed);
+	// Hands over the slots queued for re-anchoring and clears the queue.
+	void TakeStaleSlots(std::vector<uint32_t>& outSlots);
+
+	const unsigned int* GetOdoData() const { return mOdo.data(); }
+	const unsigned int* GetMoveTimeData() const { return mMoveTime.data(); }
+	const unsigned int* GetIdleTimeData() const { return mIdleTime.data(); }
+	const unsigned int* GetMaxSpeedData() const { return mMaxSpeed.data(); }
+
+private:
+	struct SlotAnchor
+	{
+		uint64_t tick;
+		unsigned int moveTime;
+		unsigned int idleTime;
+		unsigned int speed;
+		bool isStale;
+	};
+
+	void SettleSlot(unsigned int slot);
+	void MarkStale(unsigned int slot);
+	void PushAnchors(size_t count);
+
+	std::vector<unsigned int> mOdo;
+	std::vector<unsigned int> mMoveTime;
+	std::vector<unsigned int> mIdleTime;
+	std::vector<unsigned int> mMaxSpeed;
+	std::vector<unsigned char> mIsMaxSpeedValid;
+	std::vector<unsigned char> mIsSpeedChangeQueued;
+	std::vector<uint32_t> mSpeedChangedSlots;
+	OdometerIndex mOdoIndex;
+	uint64_t mNextSequence;
+	bool mIsBatchingOdo;
+	// Lazy mode only; empty otherwise.
+	std::vector<SlotAnchor> mAnchors;
+	std::vector<uint32_t> mStaleSlots;
+	uint64_t mClock;
+	bool mIsSettled;
+	bool mIsLazy;
+};
+
+} // namespace core
+} // namespace engine
@@ -0,0 +1,145 @@
+#include <thread>
+
+#include "TravelView.h"
+#include "TravelStateStore.h"
+#include "VehicleRegistry.h"
+
+namespace engine {
+namespace core {
+
+	TravelView::TravelView()
+		: mTick(0)
+	{
+	}
+
+	uint64_t TravelView::GetTick() const
+	{
+		return mTick;
+	}
+
+	size_t TravelView::GetVehicleCount() const
+	{
+		return mHandles.size();
+	}
+
+	VehicleHandle TravelView::GetHandle(size_t i) const
+	{
+		return mHandles[i];
+	}
+
+	bool TravelView::TryGetState(VehicleHandle handle, DutyCycleState& outState) const
+	{
+		if (handle.IsNull() || handle.index >= mDenseByHandleIndex.size())
+		{
+			return false;
+		}
+
+		uint32_t i = mDenseByHandleIndex[handle.index];
+		if (i >= mHandles.size() || mHandles[i] != handle)
+		{
+			return false;
+		}
+
+		outState = DutyCycleState{ mOdo[i], mMoveTime[i], mIdleTime[i] };
+		return true;
+	}
+
+	VehicleHandle TravelView::GetFurthestTravelled() const
+	{
+		return mFurthest;
+	}
+
+	void TravelView::Capture(uint64_t tick, const VehicleRegistry& vehicles, const TravelStateStore& travelState)
+	{
+		size_t count = vehicles.GetSize();
+		mTick = tick;
+		mOdo.assign(travelState.GetOdoData(), travelState.GetOdoData() + count);
+		mMoveTime.assign(travelState.GetMoveTimeData(), travelState.GetMoveTimeData() + count);
+		mIdleTime.assign(travelState.GetIdleTimeData(), travelState.GetIdleTimeData() + count);
+
+		mHandles.resize(count);
+		uint32_t handleIndexEnd = 0;
+		for (size_t i = 0; i < count; ++i)
+		{
+			mHandles[i] = vehicles.GetHandle(static_cast<unsigned int>(i));
+			handleIndexEnd = mHandles[i].index >= handleIndexEnd ? mHandles[i].index + 1 : handleIndexEnd;
+		}
+
+		// Unused entries keep whatever they held; the handle check rejects them.
+		if (mDenseByHandleIndex.size() < handleIndexEnd)
+		{
+			mDenseByHandleIndex.resize(handleIndexEnd, 0xFFFFFFFFu);
+		}
+		for (size_t i = 0; i < count; ++i)
+		{
+			mDenseByHandleIndex[mHandles[i].index] = static_cast<uint32_t>(i);
+		}
+
+		uint32_t furthest = travelState.GetOdometerIndex().GetFurthest();
+		mFurthest = furthest != OdometerIndex::NONE ? mHandles[furthest] : VehicleHandle();
+	}
+
+	TravelViewLease::TravelViewLease(const TravelViewBuffer* buffer, unsigned int index, const TravelView* view)
+		: mBuffer(buffer)
+		, mIndex(index)
+		, mView(view)
+	{
+	}
+
+	TravelViewLease::TravelViewLease(TravelViewLease&& other) noexcept
+		: mBuffer(other.mBuffer)
+		, mIndex(other.mIndex)
+		, mView(other.mView)
+	{
+		other.mBuffer = nullptr;
+	}
+
+	TravelViewLease::~TravelViewLease()
+	{
+		if (mBuffer != nullptr)
+		{
+			mBuffer->mReaders[mIndex].fetch_sub(1);
+		}
+	}
+
+	TravelViewBuffer::TravelViewBuffer()
+		: mFront(0)
+	{
+		mReaders[0].store(0);
+		mReaders[1].store(0);
+	}
+
+	TravelViewLease TravelViewBuffer::Acquire() const
+	{
+		// Sequentially consistent on both sides: either the writer sees this
+		// reader's count before reusing the view, or this reader sees the flip
+		// and moves to the new front.
+		for (;;)
+		{
+			unsigned int front = mFront.load();
+			mReaders[front].fetch_add(1);
+			if (mFront.load() == front)
+			{
+				return TravelViewLease(this, front, &mViews[front]);
+			}
+			mReaders[front].fetch_sub(1);
+		}
+	}
+
+	TravelView& TravelViewBuffer::BeginWrite()
+	{
+		unsigned int back = 1 - mFront.load();
+		while (mReaders[back].load() != 0)
+		{
+			std::this_thread::yield();
+		}
+		return mViews[back];
+	}
+
+	void TravelViewBuffer::Publish()
+	{
+		mFront.store(1 - mFront.load());
+	}
+
+} // namespace core
+} // namespace engine
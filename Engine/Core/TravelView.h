@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "DutyCycle.h"
+#include "VehicleHandle.h"
+
+namespace engine {
+namespace core {
+
+class OdometerIndex;
+class TravelStateStore;
+class VehicleRegistry;
+
+// Immutable copy of a fleet's travel state as of one published tick. Holds
+// handles rather than vehicles, so it stays meaningful while the live fleet
+// moves on underneath it.
+class TravelView
+{
+public:
+	TravelView();
+
+	// Number of Travel calls the engine had completed when this was taken.
+	uint64_t GetTick() const;
+	size_t GetVehicleCount() const;
+	VehicleHandle GetHandle(size_t i) const;
+	// False for handles the fleet did not hold at the time.
+	bool TryGetState(VehicleHandle handle, DutyCycleState& outState) const;
+	// Null when the fleet was empty.
+	VehicleHandle GetFurthestTravelled() const;
+
+private:
+	friend class DeusExMachina;
+
+	void Capture(uint64_t tick, const VehicleRegistry& vehicles, const TravelStateStore& travelState);
+
+	uint64_t mTick;
+	std::vector<VehicleHandle> mHandles;
+	std::vector<unsigned int> mOdo;
+	std::vector<unsigned int> mMoveTime;
+	std::vector<unsigned int> mIdleTime;
+	std::vector<uint32_t> mDenseByHandleIndex;
+	VehicleHandle mFurthest;
+};
+
+class TravelViewBuffer;
+
+// Keeps one published TravelView alive while it is read. Hold it briefly:
+// the engine cannot publish past a view that is still leased.
+class TravelViewLease
+{
+public:
+	TravelViewLease(TravelViewLease&& other) noexcept;
+	~TravelViewLease();
+
+	TravelViewLease(const TravelViewLease&) = delete;
+	TravelViewLease& operator=(const TravelViewLease&) = delete;
+	TravelViewLease& operator=(TravelViewLease&&) = delete;
+
+	const TravelView& operator*() const { return *mView; }
+	const TravelView* operator->() const { return mView; }
+
+private:
+	friend class TravelViewBuffer;
+
+	TravelViewLease(const TravelViewBuffer* buffer, unsigned int index, const TravelView* view);
+
+	const TravelViewBuffer* mBuffer;
+	unsigned int mIndex;
+	const TravelView* mView;
+};
+
+// Two TravelViews: readers lease the front one while the writer fills the
+// back one and then flips. Leasing takes no lock -- a reader pins a view
+// with a counter and retries if the flip beat it -- so readers never wait
+// for the writer. The writer waits for the back view's last reader to let
+// go before overwriting it.
+class TravelViewBuffer
+{
+public:
+	TravelViewBuffer();
+
+	TravelViewBuffer(const TravelViewBuffer&) = delete;
+	TravelViewBuffer& operator=(const TravelViewBuffer&) = delete;
+
+	// Any thread, any time.
+	TravelViewLease Acquire() const;
+
+	// Writer side; one writer at a time.
+	TravelView& BeginWrite();
+	void Publish();
+
+private:
+	friend class TravelViewLease;
+
+	TravelView mViews[2];
+	mutable std::atomic<uint32_t> mReaders[2];
+	std::atomic<unsigned int> mFront;
+};
+
+} // namespace core
+} // namespace engine
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+
+namespace engine {
+namespace core {
+
+// Stable reference to a vehicle registered with DeusExMachina. A handle stays
+// valid until that vehicle is removed; after that its generation no longer
+// matches the slot and every lookup through it fails instead of aliasing
+// whichever vehicle reuses the slot.
+struct VehicleHandle
+{
+	uint32_t index;
+	uint32_t generation;
+
+	VehicleHandle()
+		: index(0)
+		, generation(0)
+	{
+	}
+
+	VehicleHandle(uint32_t i, uint32_t g)
+		: index(i)
+		, generation(g)
+	{
+	}
+
+	// Generation 0 is never issued, so a default-constructed handle is null.
+	bool IsNull() const { return generation == 0; }
+
+	bool operator==(const VehicleHandle& rhs) const { return index == rhs.index && generation == rhs.generation; }
+	bool operator!=(const VehicleHandle& rhs) const { return !(*this == rhs); }
+};
+
+} // namespace core
+} // namespace engine
@@ -0,0 +1,97 @@
+#include "VehicleRegistry.h"
+
+namespace engine {
+namespace core {
+
+using vehicles::Vehicle;
+
+	VehicleHandle VehicleRegistry::Add(std::unique_ptr<Vehicle> vehicle)
+	{
+		uint32_t slotIndex;
+		if (mFreeHead != INVALID_INDEX)
+		{
+			slotIndex = mFreeHead;
+			mFreeHead = mSlots[slotIndex].denseIndex;
+		}
+		else
+		{
+			slotIndex = static_cast<uint32_t>(mSlots.size());
+			mSlots.push_back(Slot{ 1, 0 });
+		}
+
+		Slot& slot = mSlots[slotIndex];
+		slot.denseIndex = static_cast<uint32_t>(mDense.size());
+		mDense.push_back(std::move(vehicle));
+		mDenseToSlot.push_back(slotIndex);
+
+		return VehicleHandle(slotIndex, slot.generation);
+	}
+
+	std::unique_ptr<Vehicle> VehicleRegistry::RemoveAt(unsigned int denseIndex)
+	{
+		uint32_t slotIndex = mDenseToSlot[denseIndex];
+		uint32_t lastIndex = static_cast<uint32_t>(mDense.size() - 1);
+
+		std::unique_ptr<Vehicle> removed = std::move(mDense[denseIndex]);
+		if (denseIndex != lastIndex)
+		{
+			mDense[denseIndex] = std::move(mDense[lastIndex]);
+			mDenseToSlot[denseIndex] = mDenseToSlot[lastIndex];
+			mSlots[mDenseToSlot[denseIndex]].denseIndex = denseIndex;
+		}
+		mDense.pop_back();
+		mDenseToSlot.pop_back();
+
+		// Retire the slot: bump its generation (skipping the null generation on
+		// wrap-around) and push it onto the free list.
+		Slot& slot = mSlots[slotIndex];
+		slot.generation = slot.generation + 1 == 0 ? 1 : slot.generation + 1;
+		slot.denseIndex = mFreeHead;
+		mFreeHead = slotIndex;
+
+		return removed;
+	}
+
+	void VehicleRegistry::Reserve(size_t count)
+	{
+		mSlots.reserve(count);
+		mDense.reserve(count);
+		mDenseToSlot.reserve(count);
+	}
+
+	bool VehicleRegistry::IsValid(VehicleHandle handle) const
+	{
+		unsigned int denseIndex;
+		return TryGetDenseIndex(handle, denseIndex);
+	}
+
+	bool VehicleRegistry::TryGetDenseIndex(VehicleHandle handle, unsigned int& outDenseIndex) const
+	{
+		if (handle.IsNull() || handle.index >= mSlots.size())
+		{
+			return false;
+		}
+
+		const Slot& slot = mSlots[handle.index];
+		if (slot.generation != handle.generation)
+		{
+			return false;
+		}
+
+		outDenseIndex = slot.denseIndex;
+		return true;
+	}
+
+	VehicleHandle VehicleRegistry::GetHandle(unsigned int denseIndex) const
+	{
+		if (denseIndex >= mDense.size())
+		{
+			return VehicleHandle();
+		}
+
+		uint32_t slotIndex = mDenseToSlot[denseIndex];
+		return VehicleHandle(slotIndex, mSlots[slotIndex].generation);
+	}
+
+} // namespace core
+} // namespace engine
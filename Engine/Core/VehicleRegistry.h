@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "VehicleHandle.h"
+#include "../Vehicles/Vehicle.h"
+
+namespace engine {
+namespace core {
+
+// Generational slot map owning the fleet. Vehicles are kept densely packed so
+// iteration touches a single contiguous array; a sparse slot table maps stable
+// handles to dense positions. Add and remove are O(1): removal moves the last
+// vehicle into the hole (swap-and-pop) and bumps the slot generation.
+class VehicleRegistry
+{
+public:
+	VehicleRegistry() = default;
+	~VehicleRegistry() = default;
+
+	VehicleRegistry(const VehicleRegistry&) = delete;
+	VehicleRegistry& operator=(const VehicleRegistry&) = delete;
+
+	VehicleHandle Add(std::unique_ptr<vehicles::Vehicle> vehicle);
+	// Swap-and-pop removal by dense position. Whatever vehicle was last now
+	// lives at denseIndex.
+	std::unique_ptr<vehicles::Vehicle> RemoveAt(unsigned int denseIndex);
+	void Reserve(size_t count);
+
+	bool IsValid(VehicleHandle handle) const;
+	// Returns false for null or stale handles.
+	bool TryGetDenseIndex(VehicleHandle handle, unsigned int& outDenseIndex) const;
+	VehicleHandle GetHandle(unsigned int denseIndex) const;
+
+	vehicles::Vehicle* Get(unsigned int denseIndex) const { return mDense[denseIndex].get(); }
+	size_t GetSize() const { return mDense.size(); }
+	bool IsEmpty() const { return mDense.empty(); }
+
+	const std::vector<std::unique_ptr<vehicles::Vehicle>>& GetDense() const { return mDense; }
+
+private:
+	struct Slot
+	{
+		uint32_t generation;
+		uint32_t denseIndex;    // next free slot while the slot is unused
+	};
+
+	static constexpr uint32_t INVALID_INDEX = 0xFFFFFFFFu;
+
+	std::vector<Slot> mSlots;
+	std::vector<std::unique_ptr<vehicles::Vehicle>> mDense;
+	std::vector<uint32_t> mDenseToSlot;
+	uint32_t mFreeHead = INVALID_INDEX;
+};
+
+} // namespace core
+} // namespace engine
@@ -0,0 +1,82 @@
+#include "VehicleTypeRegistry.h"
+
+namespace engine {
+namespace core {
+
+	VehicleTypeRegistry::VehicleTypeRegistry()
+		: mPassengerFactory(nullptr)
+	{
+	}
+
+	void VehicleTypeRegistry::SetPassengerFactory(PassengerFactory factory)
+	{
+		mPassengerFactory = factory;
+	}
+
+	uint32_t VehicleTypeRegistry::FindType(const vehicles::Vehicle& vehicle) const
+	{
+		std::unordered_map<std::type_index, uint32_t>::const_iterator found = mTypeByIndex.find(std::type_index(typeid(vehicle)));
+		return found != mTypeByIndex.end() ? found->second : NONE;
+	}
+
+	uint32_t VehicleTypeRegistry::FindType(std::string_view name) const
+	{
+		std::unordered_map<std::string, uint32_t>::const_iterator found = mTypeByName.find(std::string(name));
+		return found != mTypeByName.end() ? found->second : NONE;
+	}
+
+	const std::string& VehicleTypeRegistry::GetTypeName(uint32_t type) const
+	{
+		return mTypes[type].name;
+	}
+
+	size_t VehicleTypeRegistry::GetTypeCount() const
+	{
+		return mTypes.size();
+	}
+
+	std::unique_ptr<vehicles::Vehicle> VehicleTypeRegistry::CreateVehicle(uint32_t type, unsigned int maxPassengersCount) const
+	{
+		return mTypes[type].factory(maxPassengersCount);
+	}
+
+	std::unique_ptr<const interfaces::IPassenger> VehicleTypeRegistry::CreatePassenger(NameTable::NameId nameId, unsigned int weight) const
+	{
+		if (mPassengerFactory == nullptr)
+		{
+			return nullptr;
+		}
+		return mPassengerFactory(nameId, weight);
+	}
+
+	bool VehicleTypeRegistry::HasPassengerFactory() const
+	{
+		return mPassengerFactory != nullptr;
+	}
+
+	void VehicleTypeRegistry::RegisterBucket(uint32_t type, DeusExMachina& engine) const
+	{
+		mTypes[type].registerBucket(engine);
+	}
+
+	void VehicleTypeRegistry::AddType(std::type_index type, const char* name, VehicleFactory factory, BucketRegistrar registerBucket)
+	{
+		std::unordered_map<std::type_index, uint32_t>::const_iterator found = mTypeByIndex.find(type);
+		if (found != mTypeByIndex.end())
+		{
+			TypeEntry& entry = mTypes[found->second];
+			mTypeByName.erase(entry.name);
+			entry.name = name;
+			entry.factory = factory;
+			mTypeByName[entry.name] = found->second;
+			return;
+		}
+
+		uint32_t index = static_cast<uint32_t>(mTypes.size());
+		mTypes.push_back(TypeEntry{ name, factory, registerBucket });
+		mTypeByIndex.emplace(type, index);
+		mTypeByName[mTypes.back().name] = index;
+	}
+
+} // namespace core
+} // namespace engine
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+#include "DeusExMachina.h"
+#include "NameTable.h"
+#include "../Interfaces/IPassenger.h"
+#include "../Vehicles/Vehicle.h"
+
+namespace engine {
+namespace core {
+
+// Stable names and factories for the Game layer's concrete vehicle types (and
+// its passenger type), so engine-side persistence -- fleet snapshots, the
+// travel journal -- can write a vehicle out and build it again without
+// knowing the type.
+class VehicleTypeRegistry
+{
+public:
+	typedef std::unique_ptr<vehicles::Vehicle> (*VehicleFactory)(unsigned int maxPassengersCount);
+	typedef std::unique_ptr<const interfaces::IPassenger> (*PassengerFactory)(NameTable::NameId nameId, unsigned int weight);
+
+	static constexpr uint32_t NONE = 0xFFFFFFFFu;
+
+	VehicleTypeRegistry();
+	~VehicleTypeRegistry() = default;
+
+	VehicleTypeRegistry(const VehicleTypeRegistry&) = delete;
+	VehicleTypeRegistry& operator=(const VehicleTypeRegistry&) = delete;
+
+	// `name` identifies T on disk and must stay stable across builds.
+	template <typename T>
+	void RegisterVehicleType(const char* name, VehicleFactory factory);
+	void SetPassengerFactory(PassengerFactory factory);
+
+	// NONE for types that were never registered.
+	uint32_t FindType(const vehicles::Vehicle& vehicle) const;
+	uint32_t FindType(std::string_view name) const;
+	const std::string& GetTypeName(uint32_t type) const;
+	size_t GetTypeCount() const;
+
+	std::unique_ptr<vehicles::Vehicle> CreateVehicle(uint32_t type, unsigned int maxPassengersCount) const;
+	// nullptr until a passenger factory is set.
+	std::unique_ptr<const interfaces::IPassenger> CreatePassenger(NameTable::NameId nameId, unsigned int weight) const;
+	bool HasPassengerFactory() const;
+	// Gives the type its statically dispatched travel bucket in `engine`.
+	void RegisterBucket(uint32_t type, DeusExMachina& engine) const;
+
+private:
+	typedef void (*BucketRegistrar)(DeusExMachina& engine);
+
+	struct TypeEntry
+	{
+		std::string name;
+		VehicleFactory factory;
+		BucketRegistrar registerBucket;
+	};
+
+	template <typename T>
+	static void RegisterBucket(DeusExMachina& engine);
+	void AddType(std::type_index type, const char* name, VehicleFactory factory, BucketRegistrar registerBucket);
+
+	std::vector<TypeEntry> mTypes;
+	std::unordered_map<std::type_index, uint32_t> mTypeByIndex;
+	std::unordered_map<std::string, uint32_t> mTypeByName;
+	PassengerFactory mPassengerFactory;
+};
+
+template <typename T>
+void VehicleTypeRegistry::RegisterVehicleType(const char* name, VehicleFactory factory)
+{
+	static_assert(std::is_base_of<vehicles::Vehicle, T>::value, "T must derive from engine::vehicles::Vehicle");
+
+	AddType(std::type_index(typeid(T)), name, factory, &VehicleTypeRegistry::RegisterBucket<T>);
+}
+
+template <typename T>
+void VehicleTypeRegistry::RegisterBucket(DeusExMachina& engine)
+{
+	engine.RegisterVehicleType<T>();
+}
+
+} // namespace core
+} // namespace engine
@@ -0,0 +1,168 @@
+#include <string>
+
+#include "WorkStealingPool.h"
+#include "EngineTrace.h"
+
+namespace engine {
+namespace core {
+
+	WorkStealingPool::WorkStealingPool(unsigned int threadCount)
+		: mJobEpoch(0)
+		, mIsStopping(false)
+		, mPendingTasks(0)
+	{
+		if (threadCount == 0)
+		{
+			threadCount = 1;
+		}
+
+		for (unsigned int i = 0; i < threadCount; ++i)
+		{
+			mQueues.push_back(std::make_unique<TaskQueue>());
+		}
+
+		// Queue 0 belongs to the calling thread.
+		for (unsigned int i = 1; i < threadCount; ++i)
+		{
+			mWorkers.emplace_back(&WorkStealingPool::WorkerLoop, this, i);
+		}
+	}
+
+	WorkStealingPool::~WorkStealingPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mWakeMutex);
+			mIsStopping = true;
+		}
+		mWakeCondition.notify_all();
+
+		for (std::thread& worker : mWorkers)
+		{
+			worker.join();
+		}
+	}
+
+	void WorkStealingPool::ParallelFor(size_t count, size_t chunkSize, const RangeFunction& body)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+		if (chunkSize == 0)
+		{
+			chunkSize = 1;
+		}
+
+		size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+		if (mWorkers.empty() || chunkCount == 1)
+		{
+			body(0, count);
+			return;
+		}
+
+		// Deal contiguous runs of chunks to each queue so that, absent stealing,
+		// every thread walks one contiguous stretch of the fleet.
+		size_t queueCount = mQueues.size();
+		mPendingTasks.store(chunkCount, std::memory_order_relaxed);
+		for (size_t q = 0; q < queueCount; ++q)
+		{
+			size_t firstChunk = chunkCount * q / queueCount;
+			size_t lastChunk = chunkCount * (q + 1) / queueCount;
+
+			std::lock_guard<std::mutex> lock(mQueues[q]->mutex);
+			for (size_t chunk = firstChunk; chunk < lastChunk; ++chunk)
+			{
+				size_t begin = chunk * chunkSize;
+				size_t end = begin + chunkSize < count ? begin + chunkSize : count;
+				mQueues[q]->tasks.push_back(Task{ &body, begin, end });
+			}
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mWakeMutex);
+			++mJobEpoch;
+		}
+		mWakeCondition.notify_all();
+
+		while (mPendingTasks.load(std::memory_order_acquire) != 0)
+		{
+			if (!TryRunTask(0))
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	unsigned int WorkStealingPool::GetThreadCount() const
+	{
+		return static_cast<unsigned int>(mQueues.size());
+	}
+
+	void WorkStealingPool::WorkerLoop(unsigned int queueIndex)
+	{
+		EngineTrace::SetThreadName(("travel worker " + std::to_string(queueIndex)).c_str());
+		unsigned long long seenEpoch = 0;
+		for (;;)
+		{
+			{
+				std::unique_lock<std::mutex> lock(mWakeMutex);
+				mWakeCondition.wait(lock, [this, seenEpoch] { return mIsStopping || mJobEpoch != seenEpoch; });
+				if (mIsStopping)
+				{
+					return;
+				}
+				seenEpoch = mJobEpoch;
+			}
+
+			while (TryRunTask(queueIndex))
+			{
+			}
+		}
+	}
+
+	bool WorkStealingPool::TryRunTask(unsigned int queueIndex)
+	{
+		Task task;
+		if (!TryPopLocal(queueIndex, task) && !TrySteal(queueIndex, task))
+		{
+			return false;
+		}
+
+		(*task.body)(task.begin, task.end);
+		mPendingTasks.fetch_sub(1, std::memory_order_acq_rel);
+		return true;
+	}
+
+	bool WorkStealingPool::TryPopLocal(unsigned int queueIndex, Task& outTask)
+	{
+		TaskQueue& queue = *mQueues[queueIndex];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.tasks.empty())
+		{
+			return false;
+		}
+
+		outTask = queue.tasks.back();
+		queue.tasks.pop_back();
+		return true;
+	}
+
+	bool WorkStealingPool::TrySteal(unsigned int thiefIndex, Task& outTask)
+	{
+		size_t queueCount = mQueues.size();
+		for (size_t offset = 1; offset < queueCount; ++offset)
+		{
+			TaskQueue& victim = *mQueues[(thiefIndex + offset) % queueCount];
+			std::lock_guard<std::mutex> lock(victim.mutex);
+			if (!victim.tasks.empty())
+			{
+				outTask = victim.tasks.front();
+				victim.tasks.pop_front();
+				return true;
+			}
+		}
+		return false;
+	}
+
+} // namespace core
+} // namespace engine
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace engine {
+namespace core {
+
+// Fixed-size fork/join pool for data-parallel loops over the fleet. A job is
+// split into chunks that are dealt out as contiguous runs to one deque per
+// participant; each participant drains its own deque from the back and, once
+// empty, steals from the front of the others. The calling thread participates
+// as well, so a pool of N threads spawns N - 1 workers.
+class WorkStealingPool
+{
+public:
+	using RangeFunction = std::function<void(size_t begin, size_t end)>;
+
+	explicit WorkStealingPool(unsigned int threadCount);
+	~WorkStealingPool();
+
+	WorkStealingPool(const WorkStealingPool&) = delete;
+	WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+	// Runs body over [0, count) in chunks of at most chunkSize elements and
+	// returns once every chunk has completed. Not reentrant.
+	void ParallelFor(size_t count, size_t chunkSize, const RangeFunction& body);
+	unsigned int GetThreadCount() const;
+
+private:
+	struct Task
+	{
+		const RangeFunction* body;
+		size_t begin;
+		size_t end;
+	};
+
+	struct TaskQueue
+	{
+		std::mutex mutex;
+		std::deque<Task> tasks;
+	};
+
+	void WorkerLoop(unsigned int queueIndex);
+	bool TryRunTask(unsigned int queueIndex);
+	bool TryPopLocal(unsigned int queueIndex, Task& outTask);
+	bool TrySteal(unsigned int thiefIndex, Task& outTask);
+
+	std::vector<std::unique_ptr<TaskQueue>> mQueues;
+	std::vector<std::thread> mWorkers;
+	std::mutex mWakeMutex;
+	std::condition_variable mWakeCondition;
+	unsigned long long mJobEpoch;
+	bool mIsStopping;
+	std::atomic<size_t> mPendingTasks;
+};
+
+} // namespace core
+} // namespace engine
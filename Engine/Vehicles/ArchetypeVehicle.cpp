@@ -0,0 +1,52 @@
+#include "ArchetypeVehicle.h"
+
+namespace engine {
+namespace vehicles {
+
+	ArchetypeVehicle::ArchetypeVehicle(const core::ArchetypeTable& table, uint32_t archetype)
+		: Vehicle(table.GetArchetype(archetype).capacity)
+		, mTable(&table)
+		, mArchetype(archetype)
+	{
+	}
+
+	ArchetypeVehicle::~ArchetypeVehicle() = default;
+
+	std::unique_ptr<ArchetypeVehicle> ArchetypeVehicle::Create(const core::ArchetypeTable& table, std::string_view name)
+	{
+		uint32_t archetype = table.Find(name);
+		if (archetype == core::ArchetypeTable::NONE)
+		{
+			return nullptr;
+		}
+		return std::make_unique<ArchetypeVehicle>(table, archetype);
+	}
+
+	void ArchetypeVehicle::TravelByMachina(const core::TravelContext& context)
+	{
+		const core::ArchetypeTable::Archetype& archetype = mTable->GetArchetype(mArchetype);
+		AdvanceDutyCycle(context.hours, archetype.moveTime, archetype.idleTime, GetMaxSpeed());
+	}
+
+	capabilities::CapabilityMask ArchetypeVehicle::GetCapabilities() const
+	{
+		return mTable->GetArchetype(mArchetype).capabilities;
+	}
+
+	unsigned int ArchetypeVehicle::GetCapabilitySpeed(capabilities::Capability capability) const
+	{
+		return mTable->EvaluateCapabilitySpeed(mArchetype, capability, GetPassengersWeight());
+	}
+
+	unsigned int ArchetypeVehicle::EstimateMaxSpeed(unsigned int passengersWeight) const
+	{
+		return mTable->EvaluateMaxSpeed(mArchetype, passengersWeight);
+	}
+
+	unsigned int ArchetypeVehicle::ComputeMaxSpeed() const
+	{
+		return EstimateMaxSpeed(GetPassengersWeight());
+	}
+
+} // namespace vehicles
+} // namespace engine
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+#include "Vehicle.h"
+#include "../Core/ArchetypeTable.h"
+#include "../Core/ArchetypeTravelBucket.h"
+
+namespace engine {
+namespace vehicles {
+
+// A vehicle whose type is an ArchetypeTable entry: capacity, capabilities,
+// speed curves and duty cycle are all read from the shared table, so the
+// vehicle itself carries nothing beyond the Vehicle base and a reference.
+// The table must outlive every vehicle built from it.
+class ArchetypeVehicle : public Vehicle
+{
+public:
+	using TravelBucketType = core::ArchetypeTravelBucket;
+
+	ArchetypeVehicle(const core::ArchetypeTable& table, uint32_t archetype);
+	virtual ~ArchetypeVehicle();
+
+	// nullptr for names the table does not define.
+	static std::unique_ptr<ArchetypeVehicle> Create(const core::ArchetypeTable& table, std::string_view name);
+
+	// Move-only (inherited from Vehicle)
+	ArchetypeVehicle(ArchetypeVehicle&& other) noexcept = default;
+	ArchetypeVehicle& operator=(ArchetypeVehicle&&) = default;
+
+	const core::ArchetypeTable& GetTable() const { return *mTable; }
+	uint32_t GetArchetype() const { return mArchetype; }
+
+	virtual void TravelByMachina(const core::TravelContext& context) override;
+
+	virtual capabilities::CapabilityMask GetCapabilities() const override;
+	virtual unsigned int GetCapabilitySpeed(capabilities::Capability capability) const override;
+	virtual unsigned int EstimateMaxSpeed(unsigned int passengersWeight) const override;
+
+protected:
+	virtual unsigned int ComputeMaxSpeed() const override;
+
+private:
+	const core::ArchetypeTable* mTable;
+	uint32_t mArchetype;
+};
+
+} // namespace vehicles
+} // namespace engine
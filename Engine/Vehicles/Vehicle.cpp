@@ -1,18 +1,26 @@
 #include "Vehicle.h"
+#include "../Core/EngineMetrics.h"
+#include "../Core/FleetJournal.h"
+#include "../Core/TravelStateStore.h"
 
 namespace engine {
 namespace vehicles {
 
 using engine::interfaces::IPassenger;
 
-	Vehicle::Vehicle(unsigned int maxPassengersCount)
+	Vehicle::Vehicle(unsigned int maxPassengersCount, PassengerOrder passengerOrder)
 		: mMaxPassengersCount(maxPassengersCount)
 		, mPassengersWeight(0)
 		, mOdo(0)
 		, mIdleTime(0)
 		, mMoveTime(0)
+		, mMaxSpeed(0)
+		, mIsMaxSpeedValid(false)
+		, mTravelState(nullptr)
+		, mTravelSlot(0)
+		, mJournal(nullptr)
+		, mPassengerOrder(passengerOrder)
 	{
-		mPassengers.reserve(mMaxPassengersCount);
 	}
 
 	Vehicle::~Vehicle() = default;
@@ -20,15 +28,20 @@ using engine::interfaces::IPassenger;
 	Vehicle::Vehicle(Vehicle&& other) noexcept
 		: mMaxPassengersCount(other.mMaxPassengersCount)
 		, mPassengersWeight(other.mPassengersWeight)
-		, mOdo(other.mOdo)
-		, mIdleTime(other.mIdleTime)
-		, mMoveTime(other.mMoveTime)
+		, mOdo(other.GetOdo())
+		, mIdleTime(other.GetIdleTime())
+		, mMoveTime(other.GetMoveTime())
+		, mMaxSpeed(0)
+		, mIsMaxSpeedValid(false)
+		, mTravelState(nullptr)
+		, mTravelSlot(0)
+		, mJournal(nullptr)
+		, mPassengerOrder(other.mPassengerOrder)
 		, mPassengers(std::move(other.mPassengers))
 	{
 		other.mPassengersWeight = 0;
-		other.mOdo = 0;
-		other.mIdleTime = 0;
-		other.mMoveTime = 0;
+		other.SetTravelState(0, 0, 0);
+		other.InvalidateSpeedCache();
 	}
 
 	Vehicle& Vehicle::operator=(Vehicle&& rhs) noexcept
@@ -40,59 +53,68 @@ using engine::interfaces::IPassenger;
 
 		mMaxPassengersCount = rhs.mMaxPassengersCount;
 		mPassengersWeight = rhs.mPassengersWeight;
-		mOdo = rhs.mOdo;
-		mIdleTime = rhs.mIdleTime;
-		mMoveTime = rhs.mMoveTime;
+		SetTravelState(rhs.GetOdo(), rhs.GetMoveTime(), rhs.GetIdleTime());
+		mPassengerOrder = rhs.mPassengerOrder;
 		mPassengers = std::move(rhs.mPassengers);
 
 		rhs.mPassengersWeight = 0;
-		rhs.mOdo = 0;
-		rhs.mIdleTime = 0;
-		rhs.mMoveTime = 0;
+		rhs.SetTravelState(0, 0, 0);
+
+		InvalidateSpeedCache();
+		rhs.InvalidateSpeedCache();
 
 		return *this;
 	}
 
 	bool Vehicle::AddPassenger(std::unique_ptr<const IPassenger> passenger)
 	{
-		if (mPassengers.size() >= mMaxPassengersCount)
+		if (mPassengers.GetSize() >= mMaxPassengersCount)
 		{
 			return false;
 		}
 
+		if (mJournal != nullptr)
+		{
+			mJournal->RecordAddPassenger(mTravelSlot, *passenger);
+		}
+
 		mPassengersWeight += passenger->GetWeight();
-		mPassengers.push_back(std::move(passenger));
+		mPassengers.PushBack(std::move(passenger));
+		InvalidateSpeedCache();
+		core::EngineMetrics::AddPassengersBoarded(1);
 		return true;
 	}
 
 	bool Vehicle::RemovePassenger(unsigned int i)
 	{
-		if (i >= mPassengers.size())
+		if (i >= mPassengers.GetSize())
 		{
 			return false;
 		}
 
-		mPassengersWeight -= mPassengers[i]->GetWeight();
-		mPassengers.erase(mPassengers.begin() + i);
+		NotePassengerRemoved(i, *mPassengers[i]);
+		ErasePassenger(i);
+		NotePassengersRemoved(1);
 		return true;
 	}
 
 	std::unique_ptr<const IPassenger> Vehicle::ReleasePassenger(unsigned int i)
 	{
-		if (i >= mPassengers.size())
+		if (i >= mPassengers.GetSize())
 		{
 			return nullptr;
 		}
 
-		mPassengersWeight -= mPassengers[i]->GetWeight();
+		NotePassengerRemoved(i, *mPassengers[i]);
 		std::unique_ptr<const IPassenger> released = std::move(mPassengers[i]);
-		mPassengers.erase(mPassengers.begin() + i);
+		ErasePassenger(i);
+		NotePassengersRemoved(1);
 		return released;
 	}
 
 	unsigned int Vehicle::GetPassengersCount() const
 	{
-		return static_cast<unsigned int>(mPassengers.size());
+		return static_cast<unsigned int>(mPassengers.GetSize());
 	}
 
 	unsigned int Vehicle::GetMaxPassengersCount() const
@@ -102,7 +124,7 @@ using engine::interfaces::IPassenger;
 
 	const IPassenger* Vehicle::GetPassenger(unsigned int i) const
 	{
-		if (i >= mPassengers.size())
+		if (i >= mPassengers.GetSize())
 		{
 			return nullptr;
 		}
@@ -116,49 +138,330 @@ using engine::interfaces::IPassenger;
 
 	std::vector<std::unique_ptr<const IPassenger>> Vehicle::ReleaseAllPassengers()
 	{
+		core::EngineTrace::Scope trace("Vehicle::ReleaseAllPassengers", "passengers");
+		trace.SetArg("passengers", mPassengers.GetSize());
+		if (mJournal != nullptr)
+		{
+			mJournal->RecordReleaseAllPassengers(mTravelSlot);
+		}
+
+		std::vector<std::unique_ptr<const IPassenger>> released;
+		released.reserve(mPassengers.GetSize());
+		for (std::unique_ptr<const IPassenger>& passenger : mPassengers)
+		{
+			released.push_back(std::move(passenger));
+		}
+		mPassengers.Reset();
+
 		mPassengersWeight = 0;
-		return std::move(mPassengers);
+		InvalidateSpeedCache();
+		core::EngineMetrics::AddPassengersAlighted(released.size());
+		return released;
+	}
+
+	const Vehicle::PassengerList& Vehicle::GetPassengers() const
+	{
+		return mPassengers;
+	}
+
+	Vehicle::PassengerOrder Vehicle::GetPassengerOrder() const
+	{
+		return mPassengerOrder;
+	}
+
+	bool Vehicle::SplicePassengersFrom(Vehicle& source)
+	{
+		size_t count = source.mPassengers.GetSize();
+		if (&source == this || count > mMaxPassengersCount - mPassengers.GetSize())
+		{
+			return false;
+		}
+
+		if (count == 0)
+		{
+			return true;
+		}
+
+		core::EngineTrace::Scope trace("Vehicle::SplicePassengersFrom", "passengers");
+		trace.SetArg("passengers", count);
+		if (source.mJournal != nullptr)
+		{
+			source.mJournal->RecordReleaseAllPassengers(source.mTravelSlot);
+		}
+		if (mJournal != nullptr)
+		{
+			for (const std::unique_ptr<const IPassenger>& passenger : source.mPassengers)
+			{
+				mJournal->RecordAddPassenger(mTravelSlot, *passenger);
+			}
+		}
+
+		// Take over the source's storage outright unless ours is the larger
+		// reservation, which would then be lost.
+		if (mPassengers.IsEmpty() && source.mPassengers.GetCapacity() >= mPassengers.GetCapacity())
+		{
+			mPassengers = std::move(source.mPassengers);
+		}
+		else
+		{
+			mPassengers.Reserve(mPassengers.GetSize() + count);
+			for (std::unique_ptr<const IPassenger>& passenger : source.mPassengers)
+			{
+				mPassengers.PushBack(std::move(passenger));
+			}
+			source.mPassengers.Reset();
+		}
+
+		mPassengersWeight += source.mPassengersWeight;
+		source.mPassengersWeight = 0;
+		InvalidateSpeedCache();
+		source.InvalidateSpeedCache();
+		core::EngineMetrics::AddPassengersAlighted(count);
+		core::EngineMetrics::AddPassengersBoarded(count);
+		return true;
+	}
+
+	void Vehicle::NotePassengerRemoved(unsigned int i, const IPassenger& passenger)
+	{
+		if (mJournal != nullptr)
+		{
+			mJournal->RecordRemovePassenger(mTravelSlot, i);
+		}
+		mPassengersWeight -= passenger.GetWeight();
+	}
+
+	void Vehicle::NotePassengersRemoved(unsigned int count)
+	{
+		InvalidateSpeedCache();
+		core::EngineMetrics::AddPassengersAlighted(count);
+	}
+
+	void Vehicle::ErasePassenger(unsigned int i)
+	{
+		if (mPassengerOrder == PassengerOrder::UNORDERED)
+		{
+			mPassengers.SwapRemove(i);
+			return;
+		}
+		mPassengers.Erase(i);
+	}
+
+	unsigned int Vehicle::GetMaxSpeed() const
+	{
+		if (mTravelState != nullptr)
+		{
+			if (!mTravelState->IsMaxSpeedValid(mTravelSlot))
+			{
+				mTravelState->SetMaxSpeed(mTravelSlot, ComputeMaxSpeed());
+			}
+			return mTravelState->GetMaxSpeed(mTravelSlot);
+		}
+
+		if (!mIsMaxSpeedValid)
+		{
+			mMaxSpeed = ComputeMaxSpeed();
+			mIsMaxSpeedValid = true;
+		}
+		return mMaxSpeed;
+	}
+
+	capabilities::CapabilityMask Vehicle::GetCapabilities() const
+	{
+		return 0;
+	}
+
+	unsigned int Vehicle::GetCapabilitySpeed(capabilities::Capability) const
+	{
+		return 0;
+	}
+
+	unsigned int Vehicle::EstimateMaxSpeed(unsigned int) const
+	{
+		return GetMaxSpeed();
+	}
+
+	void Vehicle::InvalidateMaxSpeed()
+	{
+		if (mJournal != nullptr)
+		{
+			mJournal->MarkVehicleStateDirty(*this);
+		}
+		InvalidateSpeedCache();
+	}
+
+	void Vehicle::InvalidateSpeedCache()
+	{
+		if (mTravelState != nullptr)
+		{
+			mTravelState->InvalidateMaxSpeed(mTravelSlot);
+			return;
+		}
+		mIsMaxSpeedValid = false;
 	}
 
 	unsigned int Vehicle::GetOdo() const
 	{
+		if (mTravelState != nullptr)
+		{
+			mTravelState->Settle(mTravelSlot);
+			return mTravelState->GetOdo(mTravelSlot);
+		}
 		return mOdo;
 	}
 
 	void Vehicle::AddOdo(unsigned int distance)
 	{
+		if (mTravelState != nullptr)
+		{
+			mTravelState->Settle(mTravelSlot);
+			mTravelState->SetOdo(mTravelSlot, mTravelState->GetOdo(mTravelSlot) + distance);
+			RecordTravelStateChange();
+			return;
+		}
 		mOdo += distance;
 	}
 
 	unsigned int Vehicle::GetIdleTime() const
 	{
+		if (mTravelState != nullptr)
+		{
+			mTravelState->Settle(mTravelSlot);
+			return mTravelState->GetIdleTime(mTravelSlot);
+		}
 		return mIdleTime;
 	}
 
 	void Vehicle:: AddIdleTime()
 	{
+		if (mTravelState != nullptr)
+		{
+			mTravelState->Settle(mTravelSlot);
+			mTravelState->SetIdleTime(mTravelSlot, mTravelState->GetIdleTime(mTravelSlot) + 1);
+			RecordTravelStateChange();
+			return;
+		}
 		mIdleTime++;
 	}
 
 	void Vehicle::ResetIdleTIme()
 	{
+		if (mTravelState != nullptr)
+		{
+			mTravelState->Settle(mTravelSlot);
+			mTravelState->SetIdleTime(mTravelSlot, 0);
+			RecordTravelStateChange();
+			return;
+		}
 		mIdleTime = 0;
 	}
 
 	unsigned int Vehicle::GetMoveTime() const
 	{
+		if (mTravelState != nullptr)
+		{
+			mTravelState->Settle(mTravelSlot);
+			return mTravelState->GetMoveTime(mTravelSlot);
+		}
 		return mMoveTime;
 	}
 
 	void Vehicle::AddMoveTime()
 	{
+		if (mTravelState != nullptr)
+		{
+			mTravelState->Settle(mTravelSlot);
+			mTravelState->SetMoveTime(mTravelSlot, mTravelState->GetMoveTime(mTravelSlot) + 1);
+			RecordTravelStateChange();
+			return;
+		}
 		mMoveTime++;
 	}
 
 	void Vehicle::ResetMoveTime()
 	{
+		if (mTravelState != nullptr)
+		{
+			mTravelState->Settle(mTravelSlot);
+			mTravelState->SetMoveTime(mTravelSlot, 0);
+			RecordTravelStateChange();
+			return;
+		}
 		mMoveTime = 0;
 	}
 
+	void Vehicle::AdvanceDutyCycle(unsigned int hours, unsigned int moveTime, unsigned int idleTime, unsigned int speed)
+	{
+		SetDutyCycleState(core::AdvanceDutyCycle(GetDutyCycleState(), hours, moveTime, idleTime, speed));
+	}
+
+	void Vehicle::WriteSnapshot(core::SnapshotWriter&) const
+	{
+	}
+
+	bool Vehicle::ReadSnapshot(core::SnapshotReader&)
+	{
+		return true;
+	}
+
+	void Vehicle::BindTravelState(core::TravelStateStore* store, unsigned int slot)
+	{
+		mTravelState = store;
+		mTravelSlot = slot;
+	}
+
+	void Vehicle::SetJournal(core::FleetJournal* journal)
+	{
+		mJournal = journal;
+	}
+
+	void Vehicle::RecordTravelStateChange()
+	{
+		if (mJournal != nullptr)
+		{
+			mJournal->RecordTravelState(mTravelSlot, GetOdo(), GetMoveTime(), GetIdleTime());
+		}
+	}
+
+	void Vehicle::UnbindTravelState()
+	{
+		if (mTravelState == nullptr)
+		{
+			return;
+		}
+
+		mTravelState->Settle(mTravelSlot);
+		mOdo = mTravelState->GetOdo(mTravelSlot);
+		mIdleTime = mTravelState->GetIdleTime(mTravelSlot);
+		mMoveTime = mTravelState->GetMoveTime(mTravelSlot);
+		mIsMaxSpeedValid = false;
+		mTravelState = nullptr;
+		mTravelSlot = 0;
+	}
+
+	void Vehicle::SetTravelState(unsigned int odo, unsigned int moveTime, unsigned int idleTime)
+	{
+		if (mTravelState != nullptr)
+		{
+			mTravelState->Settle(mTravelSlot);
+			mTravelState->SetOdo(mTravelSlot, odo);
+			mTravelState->SetMoveTime(mTravelSlot, moveTime);
+			mTravelState->SetIdleTime(mTravelSlot, idleTime);
+			return;
+		}
+		mOdo = odo;
+		mMoveTime = moveTime;
+		mIdleTime = idleTime;
+	}
+
+	core::DutyCycleState Vehicle::GetDutyCycleState() const
+	{
+		return core::DutyCycleState{ GetOdo(), GetMoveTime(), GetIdleTime() };
+	}
+
+	void Vehicle::SetDutyCycleState(const core::DutyCycleState& state)
+	{
+		SetTravelState(state.odo, state.moveTime, state.idleTime);
+	}
+
 } // namespace vehicles
 } // namespace engine
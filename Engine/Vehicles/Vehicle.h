@@ -1,18 +1,48 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 
+#include "../Capabilities/Capability.h"
+#include "../Core/DutyCycle.h"
+#include "../Core/EngineTrace.h"
+#include "../Core/SmallVector.h"
 #include "../Core/TravelContext.h"
 #include "../Interfaces/IPassenger.h"
 
 namespace engine {
+namespace core {
+class DeusExMachina;
+class FleetJournal;
+class FleetSnapshot;
+class JournalReplay;
+class SnapshotReader;
+class SnapshotWriter;
+class TravelStateStore;
+} // namespace core
+
 namespace vehicles {
 
 class Vehicle
 {
 public:
-	Vehicle(unsigned int maxPassengersCount);
+	// How removal treats the passengers behind the removed one. STABLE shifts
+	// them down, keeping boarding order; UNORDERED moves the last passenger
+	// into the gap in O(1). Chosen by the vehicle type at construction, so
+	// snapshots and journals rebuild vehicles with the same order.
+	enum class PassengerOrder : uint8_t
+	{
+		STABLE,
+		UNORDERED,
+	};
+
+	// Manifests up to this size live inside the vehicle; larger ones grow
+	// on the heap as passengers board.
+	static constexpr size_t INLINE_PASSENGERS = 4;
+	typedef core::SmallVector<std::unique_ptr<const engine::interfaces::IPassenger>, INLINE_PASSENGERS> PassengerList;
+
+	Vehicle(unsigned int maxPassengersCount, PassengerOrder passengerOrder = PassengerOrder::STABLE);
 	virtual ~Vehicle();
 
 	// Move-only
@@ -21,7 +51,23 @@ public:
 	Vehicle(Vehicle&& other) noexcept;
 	Vehicle& operator=(Vehicle&& rhs) noexcept;
 
-	virtual unsigned int GetMaxSpeed() const = 0;
+	// Memoized; recomputed through ComputeMaxSpeed only after InvalidateMaxSpeed.
+	unsigned int GetMaxSpeed() const;
+	// Called whenever an input of ComputeMaxSpeed changes: passengers, attached
+	// loads or capability parameters. Also tells an attached journal that the
+	// type-specific state (WriteSnapshot) may have changed.
+	void InvalidateMaxSpeed();
+
+	// The capabilities this type has, fixed for the vehicle's lifetime, and
+	// the current effective speed for one of them (0 for any it lacks). Both
+	// feed the engine's capability queries; a speed may only change along
+	// with an InvalidateMaxSpeed.
+	virtual capabilities::CapabilityMask GetCapabilities() const;
+	virtual unsigned int GetCapabilitySpeed(capabilities::Capability capability) const;
+	// Max speed this vehicle would have with `passengersWeight` aboard and
+	// everything else as it is now; used to plan boarding without boarding
+	// anyone. The default assumes weight does not matter.
+	virtual unsigned int EstimateMaxSpeed(unsigned int passengersWeight) const;
 
 	bool AddPassenger(std::unique_ptr<const engine::interfaces::IPassenger> passenger);
 	bool RemovePassenger(unsigned int i);
@@ -31,6 +77,20 @@ public:
 	unsigned int GetMaxPassengersCount() const;
 	unsigned int GetPassengersWeight() const;
 	std::vector<std::unique_ptr<const engine::interfaces::IPassenger>> ReleaseAllPassengers();
+	// Moves every passenger of `source` onto the end of this vehicle, weight
+	// included. All or nothing: fails without change if they would not fit.
+	// Adopts the source's storage in constant time when this vehicle is empty
+	// and has no larger reservation, otherwise moves the pointers across. The
+	// weight is carried over as one sum either way.
+	bool SplicePassengersFrom(Vehicle& source);
+	// Read-only view for enumeration; use RemovePassengersIf to drop
+	// passengers while walking the manifest.
+	const PassengerList& GetPassengers() const;
+	PassengerOrder GetPassengerOrder() const;
+	// Removes every passenger `predicate` accepts in one pass and returns how
+	// many went. Survivors keep their relative order in STABLE vehicles.
+	template <typename Predicate>
+	unsigned int RemovePassengersIf(Predicate predicate);
 
 	unsigned int GetOdo() const;
 	void AddOdo(unsigned int distance);
@@ -42,14 +102,128 @@ public:
 	void ResetMoveTime();
 	virtual void TravelByMachina(const core::TravelContext& context) = 0;
 
+protected:
+	virtual unsigned int ComputeMaxSpeed() const = 0;
+
+	// Advances a fixed duty cycle (moveTime ticks moving at `speed`, then
+	// idleTime ticks idle) by `hours` ticks in O(1); see core::AdvanceDutyCycle.
+	void AdvanceDutyCycle(unsigned int hours, unsigned int moveTime, unsigned int idleTime, unsigned int speed);
+	// TravelByMachina for types that declare a compile-time TravelPolicy
+	// (core::DutyCycle). The durations fold into constants; TVehicle is the
+	// concrete type, so the policy's modifiers can query it directly.
+	template <typename TVehicle>
+	void TravelByPolicy(const core::TravelContext& context);
+
+	// Fleet snapshots record the passenger limit, travel state and passengers
+	// themselves; these carry whatever else a type needs to be rebuilt
+	// (capability parameters, attachments). Read back in write order;
+	// ReadSnapshot replaces the current state, as journal replay applies it to
+	// live vehicles.
+	virtual void WriteSnapshot(core::SnapshotWriter& writer) const;
+	virtual bool ReadSnapshot(core::SnapshotReader& reader);
+
 private:
+	friend class core::DeusExMachina;
+	friend class core::FleetJournal;
+	friend class core::FleetSnapshot;
+	friend class core::JournalReplay;
+
+	// Moves the travel state into an engine-owned slot (and back out again).
+	// While bound, the odometer, timers and max speed cache below are unused.
+	void BindTravelState(core::TravelStateStore* store, unsigned int slot);
+	void UnbindTravelState();
+	// Mutations made outside Travel are recorded to `journal` (may be null).
+	void SetJournal(core::FleetJournal* journal);
+	void InvalidateSpeedCache();
+	void RecordTravelStateChange();
+	// Bookkeeping for one removal at index `i` (journal, weight), and for the
+	// end of a batch of `count` removals (speed cache, metrics).
+	void NotePassengerRemoved(unsigned int i, const engine::interfaces::IPassenger& passenger);
+	void NotePassengersRemoved(unsigned int count);
+	void ErasePassenger(unsigned int i);
+	void SetTravelState(unsigned int odo, unsigned int moveTime, unsigned int idleTime);
+	core::DutyCycleState GetDutyCycleState() const;
+	void SetDutyCycleState(const core::DutyCycleState& state);
+
 	unsigned int mMaxPassengersCount;
 	unsigned int mPassengersWeight;
 	unsigned int mOdo;
 	unsigned int mIdleTime;
 	unsigned int mMoveTime;
-	std::vector<std::unique_ptr<const engine::interfaces::IPassenger>> mPassengers;
+	mutable unsigned int mMaxSpeed;
+	mutable bool mIsMaxSpeedValid;
+	core::TravelStateStore* mTravelState;
+	unsigned int mTravelSlot;
+	core::FleetJournal* mJournal;
+	PassengerOrder mPassengerOrder;
+	PassengerList mPassengers;
 };
 
+template <typename Predicate>
+unsigned int Vehicle::RemovePassengersIf(Predicate predicate)
+{
+	core::EngineTrace::Scope trace("Vehicle::RemovePassengersIf", "passengers");
+	unsigned int removed = 0;
+	if (mPassengerOrder == PassengerOrder::UNORDERED)
+	{
+		// Each removal is an ordinary swap-remove, so a journal replays it
+		// exactly; the passenger swapped in is tested next.
+		unsigned int i = 0;
+		while (i < mPassengers.GetSize())
+		{
+			if (predicate(*mPassengers[i]))
+			{
+				NotePassengerRemoved(i, *mPassengers[i]);
+				mPassengers.SwapRemove(i);
+				++removed;
+			}
+			else
+			{
+				++i;
+			}
+		}
+	}
+	else
+	{
+		// Compacts in place. Each removal is recorded at the index it has
+		// once the earlier ones are gone, i.e. the write position.
+		unsigned int write = 0;
+		for (unsigned int read = 0; read < mPassengers.GetSize(); ++read)
+		{
+			if (predicate(*mPassengers[read]))
+			{
+				NotePassengerRemoved(write, *mPassengers[read]);
+				++removed;
+				continue;
+			}
+			if (write != read)
+			{
+				mPassengers[write] = std::move(mPassengers[read]);
+			}
+			++write;
+		}
+		while (mPassengers.GetSize() > write)
+		{
+			mPassengers.PopBack();
+		}
+	}
+
+	if (removed > 0)
+	{
+		NotePassengersRemoved(removed);
+	}
+	trace.SetArg("removed", removed);
+	return removed;
+}
+
+template <typename TVehicle>
+void Vehicle::TravelByPolicy(const core::TravelContext& context)
+{
+	using Policy = typename TVehicle::TravelPolicy;
+
+	const TVehicle& self = static_cast<const TVehicle&>(*this);
+	SetDutyCycleState(Policy::Advance(self, GetDutyCycleState(), context.hours, GetMaxSpeed()));
+}
+
 } // namespace vehicles
 } // namespace engine
\ No newline at end of file
@@ -4,17 +4,16 @@
 #include "Airplane.h"
 #include "Boat.h"
 #include "Boatplane.h"
-#include "../../Engine/Interfaces/IPassenger.h"
+#include "../../Engine/Core/EngineTrace.h"
+#include "../../Engine/Core/SnapshotStream.h"
 
 namespace game {
 namespace vehicles {
 
-using engine::interfaces::IPassenger;
-
 Airplane::Airplane(unsigned int maxPassengersCount)
 	: Vehicle(maxPassengersCount)
-	, mFlying(800)    // base fly speed parameter
-	, mDriving(400)   // base drive speed parameter
+	, mFlying(800, this)    // base fly speed parameter
+	, mDriving(400, this)   // base drive speed parameter
 {
 }
 
@@ -22,43 +21,56 @@ Airplane::~Airplane()
 {
 }
 
+Airplane::Airplane(Airplane&& other) noexcept
+	: Vehicle(std::move(other))
+	, mFlying(other.mFlying.GetFlySpeed(), this)
+	, mDriving(other.mDriving.GetDriveSpeed(), this)
+{
+}
+
 Boatplane Airplane::operator+(Boat& boat)
 {
+	engine::core::EngineTrace::Scope trace("Airplane::operator+", "game");
 	unsigned int totalMaxPassengersCount = GetMaxPassengersCount() + boat.GetMaxPassengersCount();
 	Boatplane bp(totalMaxPassengersCount);
-
-	std::vector<std::unique_ptr<const IPassenger>> myPassengers = ReleaseAllPassengers();
-	for (std::unique_ptr<const IPassenger>& passenger : myPassengers)
-	{
-		bp.AddPassenger(std::move(passenger));
-	}
-
-	std::vector<std::unique_ptr<const IPassenger>> boatPassengers = boat.ReleaseAllPassengers();
-	for (std::unique_ptr<const IPassenger>& passenger : boatPassengers)
-	{
-		bp.AddPassenger(std::move(passenger));
-	}
+	bp.SplicePassengersFrom(*this);
+	bp.SplicePassengersFrom(boat);
 
 	return bp;
 }
 
-unsigned int Airplane::GetMaxSpeed() const
+unsigned int Airplane::ComputeMaxSpeed() const
+{
+	return EstimateMaxSpeed(GetPassengersWeight());
+}
+
+unsigned int Airplane::EstimateMaxSpeed(unsigned int passengersWeight) const
 {
-	unsigned int flyingSpeed = GetFlySpeed();
-	unsigned int drivingSpeed = GetDriveSpeed();
+	unsigned int flyingSpeed = FlySpeedAt(passengersWeight);
+	unsigned int drivingSpeed = DriveSpeedAt(passengersWeight);
 	return flyingSpeed > drivingSpeed ? flyingSpeed : drivingSpeed;
 }
 
 unsigned int Airplane::GetFlySpeed() const
+{
+	return FlySpeedAt(GetPassengersWeight());
+}
+
+unsigned int Airplane::FlySpeedAt(unsigned int passengersWeight) const
 {
 	unsigned int baseParam = mFlying.GetFlySpeed();
-	return static_cast<unsigned int>((200.0 * exp((static_cast<double>(baseParam) - GetPassengersWeight()) / 500.0)) + 0.5);
+	return static_cast<unsigned int>((200.0 * exp((static_cast<double>(baseParam) - passengersWeight) / 500.0)) + 0.5);
 }
 
 unsigned int Airplane::GetDriveSpeed() const
+{
+	return DriveSpeedAt(GetPassengersWeight());
+}
+
+unsigned int Airplane::DriveSpeedAt(unsigned int passengersWeight) const
 {
 	unsigned int baseParam = mDriving.GetDriveSpeed();
-	return static_cast<unsigned int>(4.0 * exp((static_cast<double>(baseParam) - GetPassengersWeight()) / 70.0) + 0.5);
+	return static_cast<unsigned int>(4.0 * exp((static_cast<double>(baseParam) - passengersWeight) / 70.0) + 0.5);
 }
 
 const engine::capabilities::FlyingCapability& Airplane::GetFlyingCapability() const
@@ -71,27 +83,45 @@ const engine::capabilities::DrivingCapability& Airplane::GetDrivingCapability()
 	return mDriving;
 }
 
-void Airplane::TravelByMachina(const engine::core::TravelContext& /*context*/)
+engine::capabilities::CapabilityMask Airplane::GetCapabilities() const
+{
+	return engine::capabilities::ToMask(engine::capabilities::Capability::FLYING)
+		| engine::capabilities::ToMask(engine::capabilities::Capability::DRIVING);
+}
+
+unsigned int Airplane::GetCapabilitySpeed(engine::capabilities::Capability capability) const
 {
-	unsigned int moveTime = GetMoveTime();
-	unsigned int idleTime = GetIdleTime();
-	unsigned int speed = GetMaxSpeed();
-	//check available
-	if (moveTime < MOVE_TIME)
+	switch (capability)
 	{
-		//move
-		AddMoveTime();
-		AddOdo(speed);
+	case engine::capabilities::Capability::FLYING: return GetFlySpeed();
+	case engine::capabilities::Capability::DRIVING: return GetDriveSpeed();
+	default: return 0;
 	}
-	else if (moveTime == MOVE_TIME && idleTime < IDLE_TIME)
+}
+
+void Airplane::TravelByMachina(const engine::core::TravelContext& context)
+{
+	TravelByPolicy<Airplane>(context);
+}
+
+void Airplane::WriteSnapshot(engine::core::SnapshotWriter& writer) const
+{
+	writer.Write(mFlying.GetFlySpeed());
+	writer.Write(mDriving.GetDriveSpeed());
+}
+
+bool Airplane::ReadSnapshot(engine::core::SnapshotReader& reader)
+{
+	uint32_t flySpeed;
+	uint32_t driveSpeed;
+	if (!reader.Read(flySpeed) || !reader.Read(driveSpeed))
 	{
-		AddIdleTime();
-		if (GetIdleTime() == IDLE_TIME)
-		{
-			ResetMoveTime();
-			ResetIdleTIme();
-		}
+		return false;
 	}
+
+	mFlying.SetFlySpeed(flySpeed);
+	mDriving.SetDriveSpeed(driveSpeed);
+	return true;
 }
 
 } // namespace vehicles
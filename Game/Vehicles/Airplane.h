@@ -13,16 +13,17 @@ class Boatplane;
 class Airplane : public engine::vehicles::Vehicle
 {
 public:
+	using TravelPolicy = engine::core::DutyCycle<1, 3>;
+
 	Airplane(unsigned int maxPassengersCount);
 	virtual ~Airplane();
 
 	// Move-only (inherited from Vehicle)
-	Airplane(Airplane&&) = default;
+	Airplane(Airplane&& other) noexcept;
 	Airplane& operator=(Airplane&&) = default;
 
 	Boatplane operator+(Boat& boat);
 
-	virtual unsigned int GetMaxSpeed() const override;
 	virtual void TravelByMachina(const engine::core::TravelContext& context) override;
 
 	// Capability accessors
@@ -32,8 +33,18 @@ public:
 	const engine::capabilities::FlyingCapability& GetFlyingCapability() const;
 	const engine::capabilities::DrivingCapability& GetDrivingCapability() const;
 
+	virtual engine::capabilities::CapabilityMask GetCapabilities() const override;
+	virtual unsigned int GetCapabilitySpeed(engine::capabilities::Capability capability) const override;
+	virtual unsigned int EstimateMaxSpeed(unsigned int passengersWeight) const override;
+
+protected:
+	virtual unsigned int ComputeMaxSpeed() const override;
+	virtual void WriteSnapshot(engine::core::SnapshotWriter& writer) const override;
+	virtual bool ReadSnapshot(engine::core::SnapshotReader& reader) override;
+
 private:
-	enum { IDLE_TIME = 3, MOVE_TIME = 1 };
+	unsigned int FlySpeedAt(unsigned int passengersWeight) const;
+	unsigned int DriveSpeedAt(unsigned int passengersWeight) const;
 
 	engine::capabilities::FlyingCapability mFlying;
 	engine::capabilities::DrivingCapability mDriving;
@@ -4,16 +4,14 @@
 #include "Boat.h"
 #include "Airplane.h"
 #include "Boatplane.h"
-#include "../../Engine/Interfaces/IPassenger.h"
+#include "../../Engine/Core/SnapshotStream.h"
 
 namespace game {
 namespace vehicles {
 
-using engine::interfaces::IPassenger;
-
 Boat::Boat(unsigned int maxPassengersCount)
 	: Vehicle(maxPassengersCount)
-	, mSailing(800)  // base sail speed parameter
+	, mSailing(800, this)  // base sail speed parameter
 {
 }
 
@@ -21,35 +19,41 @@ Boat::~Boat()
 {
 }
 
+Boat::Boat(Boat&& other) noexcept
+	: Vehicle(std::move(other))
+	, mSailing(other.mSailing.GetSailSpeed(), this)
+{
+}
+
 Boatplane Boat::operator+(Airplane& plane)
 {
 	unsigned int totalMaxPassengersCount = GetMaxPassengersCount() + plane.GetMaxPassengersCount();
 	Boatplane bp(totalMaxPassengersCount);
-
-	std::vector<std::unique_ptr<const IPassenger>> planePassengers = plane.ReleaseAllPassengers();
-	for (std::unique_ptr<const IPassenger>& passenger : planePassengers)
-	{
-		bp.AddPassenger(std::move(passenger));
-	}
-
-	std::vector<std::unique_ptr<const IPassenger>> myPassengers = ReleaseAllPassengers();
-	for (std::unique_ptr<const IPassenger>& passenger : myPassengers)
-	{
-		bp.AddPassenger(std::move(passenger));
-	}
+	bp.SplicePassengersFrom(plane);
+	bp.SplicePassengersFrom(*this);
 
 	return bp;
 }
 
 unsigned int Boat::GetSailSpeed() const
+{
+	return SailSpeedAt(GetPassengersWeight());
+}
+
+unsigned int Boat::SailSpeedAt(unsigned int passengersWeight) const
 {
 	int baseSpeed = static_cast<int>(mSailing.GetSailSpeed());
-	return static_cast<unsigned int>(std::max(baseSpeed - 10 * static_cast<int>(GetPassengersWeight()), 20));
+	return static_cast<unsigned int>(std::max(baseSpeed - 10 * static_cast<int>(passengersWeight), 20));
+}
+
+unsigned int Boat::ComputeMaxSpeed() const
+{
+	return EstimateMaxSpeed(GetPassengersWeight());
 }
 
-unsigned int Boat::GetMaxSpeed() const
+unsigned int Boat::EstimateMaxSpeed(unsigned int passengersWeight) const
 {
-	return GetSailSpeed();
+	return SailSpeedAt(passengersWeight);
 }
 
 const engine::capabilities::SailingCapability& Boat::GetSailingCapability() const
@@ -57,27 +61,36 @@ const engine::capabilities::SailingCapability& Boat::GetSailingCapability() cons
 	return mSailing;
 }
 
-void Boat::TravelByMachina(const engine::core::TravelContext& /*context*/)
+engine::capabilities::CapabilityMask Boat::GetCapabilities() const
 {
-	unsigned int moveTime = GetMoveTime();
-	unsigned int idleTime = GetIdleTime();
-	unsigned int speed = GetMaxSpeed();
-	//check available
-	if (moveTime < MOVE_TIME)
-	{
-		//move
-		AddMoveTime();
-		AddOdo(speed);
-	}
-	else if (moveTime == MOVE_TIME && idleTime < IDLE_TIME)
+	return engine::capabilities::ToMask(engine::capabilities::Capability::SAILING);
+}
+
+unsigned int Boat::GetCapabilitySpeed(engine::capabilities::Capability capability) const
+{
+	return capability == engine::capabilities::Capability::SAILING ? GetSailSpeed() : 0;
+}
+
+void Boat::TravelByMachina(const engine::core::TravelContext& context)
+{
+	TravelByPolicy<Boat>(context);
+}
+
+void Boat::WriteSnapshot(engine::core::SnapshotWriter& writer) const
+{
+	writer.Write(mSailing.GetSailSpeed());
+}
+
+bool Boat::ReadSnapshot(engine::core::SnapshotReader& reader)
+{
+	uint32_t sailSpeed;
+	if (!reader.Read(sailSpeed))
 	{
-		AddIdleTime();
-		if (GetIdleTime() == IDLE_TIME)
-		{
-			ResetMoveTime();
-			ResetIdleTIme();
-		}
+		return false;
 	}
+
+	mSailing.SetSailSpeed(sailSpeed);
+	return true;
 }
 
 } // namespace vehicles
@@ -11,24 +11,34 @@ class Boatplane;
 class Boat : public engine::vehicles::Vehicle
 {
 public:
+	using TravelPolicy = engine::core::DutyCycle<2, 1>;
+
 	Boat(unsigned int maxPassengersCount);
 	virtual ~Boat();
 
 	// Move-only (inherited from Vehicle)
-	Boat(Boat&&) = default;
+	Boat(Boat&& other) noexcept;
 	Boat& operator=(Boat&&) = default;
 
 	Boatplane operator+(Airplane& plane);
 
-	virtual unsigned int GetMaxSpeed() const override;
 	virtual void TravelByMachina(const engine::core::TravelContext& context) override;
 
 	// Capability accessor
 	unsigned int GetSailSpeed() const;
 	const engine::capabilities::SailingCapability& GetSailingCapability() const;
 
+	virtual engine::capabilities::CapabilityMask GetCapabilities() const override;
+	virtual unsigned int GetCapabilitySpeed(engine::capabilities::Capability capability) const override;
+	virtual unsigned int EstimateMaxSpeed(unsigned int passengersWeight) const override;
+
+protected:
+	virtual unsigned int ComputeMaxSpeed() const override;
+	virtual void WriteSnapshot(engine::core::SnapshotWriter& writer) const override;
+	virtual bool ReadSnapshot(engine::core::SnapshotReader& reader) override;
+
 private:
-	enum { IDLE_TIME = 1, MOVE_TIME = 2 };
+	unsigned int SailSpeedAt(unsigned int passengersWeight) const;
 
 	engine::capabilities::SailingCapability mSailing;
 };
@@ -1,14 +1,17 @@
 #include <cmath>
 #include <algorithm>
 #include "Boatplane.h"
+#include "Airplane.h"
+#include "Boat.h"
+#include "../../Engine/Core/SnapshotStream.h"
 
 namespace game {
 namespace vehicles {
 
 Boatplane::Boatplane(unsigned int maxPassengersCount)
 	: Vehicle(maxPassengersCount)
-	, mFlying(500)    // base fly speed parameter
-	, mSailing(800)   // base sail speed parameter
+	, mFlying(500, this)    // base fly speed parameter
+	, mSailing(800, this)   // base sail speed parameter
 {
 }
 
@@ -16,22 +19,58 @@ Boatplane::~Boatplane()
 {
 }
 
+Boatplane::Boatplane(Boatplane&& other) noexcept
+	: Vehicle(std::move(other))
+	, mFlying(other.mFlying.GetFlySpeed(), this)
+	, mSailing(other.mSailing.GetSailSpeed(), this)
+{
+}
+
+std::vector<Boatplane> Boatplane::MergeConvoy(std::vector<Airplane>& planes, std::vector<Boat>& boats)
+{
+	size_t count = std::min(planes.size(), boats.size());
+	std::vector<Boatplane> merged;
+	merged.reserve(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		merged.emplace_back(planes[i].GetMaxPassengersCount() + boats[i].GetMaxPassengersCount());
+		merged.back().SplicePassengersFrom(planes[i]);
+		merged.back().SplicePassengersFrom(boats[i]);
+	}
+	return merged;
+}
+
 unsigned int Boatplane::GetFlySpeed() const
+{
+	return FlySpeedAt(GetPassengersWeight());
+}
+
+unsigned int Boatplane::FlySpeedAt(unsigned int passengersWeight) const
 {
 	double baseParam = static_cast<double>(mFlying.GetFlySpeed());
-	return static_cast<unsigned int>(round(150.0 * exp((baseParam - GetPassengersWeight()) / 300.0)));
+	return static_cast<unsigned int>(round(150.0 * exp((baseParam - passengersWeight) / 300.0)));
 }
 
 unsigned int Boatplane::GetSailSpeed() const
+{
+	return SailSpeedAt(GetPassengersWeight());
+}
+
+unsigned int Boatplane::SailSpeedAt(unsigned int passengersWeight) const
 {
 	double baseParam = static_cast<double>(mSailing.GetSailSpeed());
-	return static_cast<unsigned int>(std::max(static_cast<int>(round(baseParam - 1.7 * GetPassengersWeight())), 20));
+	return static_cast<unsigned int>(std::max(static_cast<int>(round(baseParam - 1.7 * passengersWeight)), 20));
+}
+
+unsigned int Boatplane::ComputeMaxSpeed() const
+{
+	return EstimateMaxSpeed(GetPassengersWeight());
 }
 
-unsigned int Boatplane::GetMaxSpeed() const
+unsigned int Boatplane::EstimateMaxSpeed(unsigned int passengersWeight) const
 {
-	unsigned int flyingSpeed = GetFlySpeed();
-	unsigned int sailingSpeed = GetSailSpeed();
+	unsigned int flyingSpeed = FlySpeedAt(passengersWeight);
+	unsigned int sailingSpeed = SailSpeedAt(passengersWeight);
 	return flyingSpeed > sailingSpeed ? flyingSpeed : sailingSpeed;
 }
 
@@ -45,28 +84,45 @@ const engine::capabilities::SailingCapability& Boatplane::GetSailingCapability()
 	return mSailing;
 }
 
-void Boatplane::TravelByMachina(const engine::core::TravelContext& /*context*/)
+engine::capabilities::CapabilityMask Boatplane::GetCapabilities() const
+{
+	return engine::capabilities::ToMask(engine::capabilities::Capability::FLYING)
+		| engine::capabilities::ToMask(engine::capabilities::Capability::SAILING);
+}
+
+unsigned int Boatplane::GetCapabilitySpeed(engine::capabilities::Capability capability) const
 {
-	unsigned int moveTime = GetMoveTime();
-	unsigned int idleTime = GetIdleTime();
-	unsigned int speed = GetMaxSpeed();
-	//check available
-	if (moveTime < MOVE_TIME)
+	switch (capability)
 	{
-		//move
-		AddMoveTime();
-		AddOdo(speed);
+	case engine::capabilities::Capability::FLYING: return GetFlySpeed();
+	case engine::capabilities::Capability::SAILING: return GetSailSpeed();
+	default: return 0;
 	}
-	else if (moveTime == MOVE_TIME && idleTime < IDLE_TIME)
+}
+
+void Boatplane::TravelByMachina(const engine::core::TravelContext& context)
+{
+	TravelByPolicy<Boatplane>(context);
+}
+
+void Boatplane::WriteSnapshot(engine::core::SnapshotWriter& writer) const
+{
+	writer.Write(mFlying.GetFlySpeed());
+	writer.Write(mSailing.GetSailSpeed());
+}
+
+bool Boatplane::ReadSnapshot(engine::core::SnapshotReader& reader)
+{
+	uint32_t flySpeed;
+	uint32_t sailSpeed;
+	if (!reader.Read(flySpeed) || !reader.Read(sailSpeed))
 	{
-		//idle time
-		AddIdleTime();
-		if (GetIdleTime() == IDLE_TIME)
-		{
-			ResetMoveTime();
-			ResetIdleTIme();
-		}
+		return false;
 	}
+
+	mFlying.SetFlySpeed(flySpeed);
+	mSailing.SetSailSpeed(sailSpeed);
+	return true;
 }
 
 } // namespace vehicles
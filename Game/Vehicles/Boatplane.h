@@ -1,4 +1,6 @@
 #pragma once
+#include <vector>
+
 #include "../../Engine/Vehicles/Vehicle.h"
 #include "../../Engine/Capabilities/FlyingCapability.h"
 #include "../../Engine/Capabilities/SailingCapability.h"
@@ -6,17 +8,25 @@
 namespace game {
 namespace vehicles {
 
+class Airplane;
+class Boat;
+
 class Boatplane : public engine::vehicles::Vehicle
 {
 public:
+	using TravelPolicy = engine::core::DutyCycle<1, 3>;
+
 	Boatplane(unsigned int maxPassengersCount);
 	virtual ~Boatplane();
 
 	// Move-only (inherited from Vehicle)
-	Boatplane(Boatplane&&) = default;
+	Boatplane(Boatplane&& other) noexcept;
 	Boatplane& operator=(Boatplane&&) = default;
 
-	virtual unsigned int GetMaxSpeed() const override;
+	// planes[i] + boats[i] for every pair, into one preallocated result; the
+	// longer input's extra vehicles are left alone.
+	static std::vector<Boatplane> MergeConvoy(std::vector<Airplane>& planes, std::vector<Boat>& boats);
+
 	virtual void TravelByMachina(const engine::core::TravelContext& context) override;
 
 	// Capability accessors
@@ -26,8 +36,18 @@ public:
 	const engine::capabilities::FlyingCapability& GetFlyingCapability() const;
 	const engine::capabilities::SailingCapability& GetSailingCapability() const;
 
+	virtual engine::capabilities::CapabilityMask GetCapabilities() const override;
+	virtual unsigned int GetCapabilitySpeed(engine::capabilities::Capability capability) const override;
+	virtual unsigned int EstimateMaxSpeed(unsigned int passengersWeight) const override;
+
+protected:
+	virtual unsigned int ComputeMaxSpeed() const override;
+	virtual void WriteSnapshot(engine::core::SnapshotWriter& writer) const override;
+	virtual bool ReadSnapshot(engine::core::SnapshotReader& reader) override;
+
 private:
-	enum { IDLE_TIME = 3, MOVE_TIME = 1 };
+	unsigned int FlySpeedAt(unsigned int passengersWeight) const;
+	unsigned int SailSpeedAt(unsigned int passengersWeight) const;
 
 	engine::capabilities::FlyingCapability mFlying;
 	engine::capabilities::SailingCapability mSailing;
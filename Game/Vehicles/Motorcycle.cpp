@@ -1,13 +1,14 @@
 #include <cmath>
 #include <algorithm>
 #include "Motorcycle.h"
+#include "../../Engine/Core/SnapshotStream.h"
 
 namespace game {
 namespace vehicles {
 
 Motorcycle::Motorcycle()
 	: Vehicle(2)
-	, mDriving(400)   // base drive speed parameter
+	, mDriving(400, this)   // base drive speed parameter
 {
 }
 
@@ -15,15 +16,31 @@ Motorcycle::~Motorcycle()
 {
 }
 
-unsigned int Motorcycle::GetMaxSpeed() const
+Motorcycle::Motorcycle(Motorcycle&& other) noexcept
+	: Vehicle(std::move(other))
+	, mDriving(other.mDriving.GetDriveSpeed(), this)
 {
-	return GetDriveSpeed();
+}
+
+unsigned int Motorcycle::ComputeMaxSpeed() const
+{
+	return EstimateMaxSpeed(GetPassengersWeight());
+}
+
+unsigned int Motorcycle::EstimateMaxSpeed(unsigned int passengersWeight) const
+{
+	return DriveSpeedAt(passengersWeight);
 }
 
 unsigned int Motorcycle::GetDriveSpeed() const
+{
+	return DriveSpeedAt(GetPassengersWeight());
+}
+
+unsigned int Motorcycle::DriveSpeedAt(unsigned int passengersWeight) const
 {
 	double baseSpeed = static_cast<double>(mDriving.GetDriveSpeed());
-	double weight = static_cast<double>(GetPassengersWeight());
+	double weight = static_cast<double>(passengersWeight);
 	return static_cast<unsigned int>(std::max(baseSpeed + (2 * weight) - pow(weight / 15.0, 3) + 0.5, 0.0));
 }
 
@@ -32,27 +49,36 @@ const engine::capabilities::DrivingCapability& Motorcycle::GetDrivingCapability(
 	return mDriving;
 }
 
-void Motorcycle::TravelByMachina(const engine::core::TravelContext& /*context*/)
+engine::capabilities::CapabilityMask Motorcycle::GetCapabilities() const
 {
-	unsigned int moveTime = GetMoveTime();
-	unsigned int idleTime = GetIdleTime();
-	unsigned int speed = GetMaxSpeed();
-	//check available
-	if (moveTime < MOVE_TIME)
-	{
-		//move
-		AddMoveTime();
-		AddOdo(speed);
-	}
-	else if (moveTime == MOVE_TIME && idleTime < IDLE_TIME)
+	return engine::capabilities::ToMask(engine::capabilities::Capability::DRIVING);
+}
+
+unsigned int Motorcycle::GetCapabilitySpeed(engine::capabilities::Capability capability) const
+{
+	return capability == engine::capabilities::Capability::DRIVING ? GetDriveSpeed() : 0;
+}
+
+void Motorcycle::TravelByMachina(const engine::core::TravelContext& context)
+{
+	TravelByPolicy<Motorcycle>(context);
+}
+
+void Motorcycle::WriteSnapshot(engine::core::SnapshotWriter& writer) const
+{
+	writer.Write(mDriving.GetDriveSpeed());
+}
+
+bool Motorcycle::ReadSnapshot(engine::core::SnapshotReader& reader)
+{
+	uint32_t driveSpeed;
+	if (!reader.Read(driveSpeed))
 	{
-		AddIdleTime();
-		if (GetIdleTime() == IDLE_TIME)
-		{
-			ResetMoveTime();
-			ResetIdleTIme();
-		}
+		return false;
 	}
+
+	mDriving.SetDriveSpeed(driveSpeed);
+	return true;
 }
 
 } // namespace vehicles
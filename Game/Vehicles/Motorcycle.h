@@ -8,22 +8,32 @@ namespace vehicles {
 class Motorcycle : public engine::vehicles::Vehicle
 {
 public:
+	using TravelPolicy = engine::core::DutyCycle<5, 1>;
+
 	Motorcycle();
 	virtual ~Motorcycle();
 
 	// Move-only (inherited from Vehicle)
-	Motorcycle(Motorcycle&&) = default;
+	Motorcycle(Motorcycle&& other) noexcept;
 	Motorcycle& operator=(Motorcycle&&) = default;
 
-	virtual unsigned int GetMaxSpeed() const override;
 	virtual void TravelByMachina(const engine::core::TravelContext& context) override;
 
 	// Capability accessor
 	unsigned int GetDriveSpeed() const;
 	const engine::capabilities::DrivingCapability& GetDrivingCapability() const;
 
+	virtual engine::capabilities::CapabilityMask GetCapabilities() const override;
+	virtual unsigned int GetCapabilitySpeed(engine::capabilities::Capability capability) const override;
+	virtual unsigned int EstimateMaxSpeed(unsigned int passengersWeight) const override;
+
+protected:
+	virtual unsigned int ComputeMaxSpeed() const override;
+	virtual void WriteSnapshot(engine::core::SnapshotWriter& writer) const override;
+	virtual bool ReadSnapshot(engine::core::SnapshotReader& reader) override;
+
 private:
-	enum { IDLE_TIME = 1, MOVE_TIME = 5 };
+	unsigned int DriveSpeedAt(unsigned int passengersWeight) const;
 
 	engine::capabilities::DrivingCapability mDriving;
 };
@@ -1,10 +1,33 @@
+#include <new>
 #include "Person.h"
+#include "../../Engine/Core/FixedBlockPool.h"
 
 namespace game {
 namespace vehicles {
 
+using engine::core::FixedBlockPool;
+using engine::core::NameTable;
+
+namespace {
+
+	FixedBlockPool* GetPersonPool()
+	{
+		// Leaked on purpose so passengers destroyed during static destruction
+		// still have a pool to return to.
+		static FixedBlockPool* pool = new FixedBlockPool(sizeof(Person), 4096);
+		return pool;
+	}
+
+} // namespace
+
 	Person::Person(const char* name, unsigned int weight)
-		: mName(name)
+		: mNameId(NameTable::GetInstance()->Intern(name))
+		, mWeight(weight)
+	{
+	}
+
+	Person::Person(NameTable::NameId nameId, unsigned int weight)
+		: mNameId(nameId)
 		, mWeight(weight)
 	{
 	}
@@ -15,7 +38,7 @@ namespace vehicles {
 
 	const std::string& Person::GetName() const
 	{
-		return mName;
+		return NameTable::GetInstance()->Resolve(mNameId);
 	}
 
 	unsigned int Person::GetWeight() const
@@ -23,5 +46,30 @@ namespace vehicles {
 		return mWeight;
 	}
 
+	NameTable::NameId Person::GetNameId() const
+	{
+		return mNameId;
+	}
+
+	void* Person::operator new(size_t size)
+	{
+		// Subclasses are larger than a pool block; send them to the heap.
+		if (size != sizeof(Person))
+		{
+			return ::operator new(size);
+		}
+		return GetPersonPool()->Allocate();
+	}
+
+	void Person::operator delete(void* ptr, size_t size)
+	{
+		if (size != sizeof(Person))
+		{
+			::operator delete(ptr);
+			return;
+		}
+		GetPersonPool()->Deallocate(ptr);
+	}
+
 } // namespace vehicles
-} // namespace game
\ No newline at end of file
+} // namespace game
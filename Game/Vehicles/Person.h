@@ -1,24 +1,34 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
 #include "../../Engine/Interfaces/IPassenger.h"
+#include "../../Engine/Core/NameTable.h"
 
 namespace game {
 namespace vehicles {
 
+// Passengers are created by the million, so a Person is kept small: its name
+// is an id into the engine's NameTable and the object itself comes from a
+// shared fixed-block pool rather than the general heap.
 class Person : public engine::interfaces::IPassenger
 {
 public:
 	Person(const char* name, unsigned int weight);
+	Person(engine::core::NameTable::NameId nameId, unsigned int weight);
 	virtual ~Person();
 
 	virtual const std::string& GetName() const override;
 	virtual unsigned int GetWeight() const override;
+	engine::core::NameTable::NameId GetNameId() const;
+
+	static void* operator new(size_t size);
+	static void operator delete(void* ptr, size_t size);
 
 private:
-	std::string mName;
+	engine::core::NameTable::NameId mNameId;
 	unsigned int mWeight;
 };
 
 } // namespace vehicles
-} // namespace game
\ No newline at end of file
+} // namespace game
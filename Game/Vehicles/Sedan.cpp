@@ -1,12 +1,13 @@
 #include "Sedan.h"
 #include "Trailer.h"
+#include "../../Engine/Core/SnapshotStream.h"
 
 namespace game {
 namespace vehicles {
 
 Sedan::Sedan()
 	: Vehicle(4)
-	, mDriving(480)   // base drive speed (max speed when empty)
+	, mDriving(480, this)   // base drive speed (max speed when empty)
 	, mTrailer(nullptr)
 {
 }
@@ -15,7 +16,7 @@ Sedan::~Sedan() = default;
 
 Sedan::Sedan(Sedan&& other) noexcept
 	: Vehicle(std::move(other))
-	, mDriving(other.mDriving)
+	, mDriving(other.mDriving.GetDriveSpeed(), this)
 	, mTrailer(std::move(other.mTrailer))
 {
 }
@@ -42,6 +43,7 @@ bool Sedan::AddTrailer(std::unique_ptr<Trailer> trailer)
 	}
 
 	mTrailer = std::move(trailer);
+	InvalidateMaxSpeed();
 	return true;
 }
 
@@ -53,6 +55,7 @@ bool Sedan::RemoveTrailer()
 	}
 
 	mTrailer.reset();
+	InvalidateMaxSpeed();
 	return true;
 }
 
@@ -61,15 +64,30 @@ const Trailer* Sedan::GetTrailer() const
 	return mTrailer.get();
 }
 
-unsigned int Sedan::GetMaxSpeed() const
+bool Sedan::IsTowing() const
 {
-	return GetDriveSpeed();
+	return mTrailer != nullptr;
+}
+
+unsigned int Sedan::ComputeMaxSpeed() const
+{
+	return EstimateMaxSpeed(GetPassengersWeight());
+}
+
+unsigned int Sedan::EstimateMaxSpeed(unsigned int passengersWeight) const
+{
+	return DriveSpeedAt(passengersWeight);
 }
 
 unsigned int Sedan::GetDriveSpeed() const
+{
+	return DriveSpeedAt(GetPassengersWeight());
+}
+
+unsigned int Sedan::DriveSpeedAt(unsigned int passengersWeight) const
 {
 	unsigned int ret;
-	unsigned int totalWeight = GetPassengersWeight();
+	unsigned int totalWeight = passengersWeight;
 	if (mTrailer != nullptr)
 	{
 		totalWeight += mTrailer->GetWeight();
@@ -105,37 +123,51 @@ const engine::capabilities::DrivingCapability& Sedan::GetDrivingCapability() con
 	return mDriving;
 }
 
-void Sedan::TravelByMachina(const engine::core::TravelContext& /*context*/)
+engine::capabilities::CapabilityMask Sedan::GetCapabilities() const
+{
+	return engine::capabilities::ToMask(engine::capabilities::Capability::DRIVING);
+}
+
+unsigned int Sedan::GetCapabilitySpeed(engine::capabilities::Capability capability) const
+{
+	return capability == engine::capabilities::Capability::DRIVING ? GetDriveSpeed() : 0;
+}
+
+void Sedan::TravelByMachina(const engine::core::TravelContext& context)
 {
-	unsigned int moveTime = GetMoveTime();
-	unsigned int speed = GetMaxSpeed();
-	//check available
-	if (moveTime < MOVE_TIME)
+	TravelByPolicy<Sedan>(context);
+}
+
+void Sedan::WriteSnapshot(engine::core::SnapshotWriter& writer) const
+{
+	writer.Write(mDriving.GetDriveSpeed());
+	writer.Write(mTrailer != nullptr ? 1 : 0);
+	if (mTrailer != nullptr)
+	{
+		writer.Write(mTrailer->GetWeight());
+	}
+}
+
+bool Sedan::ReadSnapshot(engine::core::SnapshotReader& reader)
+{
+	uint32_t driveSpeed;
+	uint32_t hasTrailer;
+	if (!reader.Read(driveSpeed) || !reader.Read(hasTrailer))
 	{
-		//move
-		AddMoveTime();
-		AddOdo(speed);
+		return false;
 	}
-	else if (moveTime == MOVE_TIME)
+
+	mDriving.SetDriveSpeed(driveSpeed);
+	RemoveTrailer();
+	if (hasTrailer != 0)
 	{
-		AddIdleTime();
-		if (mTrailer != nullptr)
+		uint32_t trailerWeight;
+		if (!reader.Read(trailerWeight) || !AddTrailer(std::make_unique<Trailer>(trailerWeight)))
 		{
-			if (GetIdleTime() == IDLE_TIME_TRAIL_ON)
-			{
-				ResetIdleTIme();
-				ResetMoveTime();
-			}
-		}
-		else
-		{
-			if (GetIdleTime() == IDLE_TIME)
-			{
-				ResetMoveTime();
-				ResetIdleTIme();
-			}
+			return false;
 		}
 	}
+	return true;
 }
 
 } // namespace vehicles
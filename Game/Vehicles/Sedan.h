@@ -11,6 +11,9 @@ class Trailer;
 class Sedan : public engine::vehicles::Vehicle
 {
 public:
+	// Idles 2 ticks instead of 1 while a trailer is attached.
+	using TravelPolicy = engine::core::DutyCycle<5, 1, engine::core::TowingIdleModifier<2>>;
+
 	Sedan();
 	virtual ~Sedan();
 
@@ -23,16 +26,25 @@ public:
 	bool AddTrailer(std::unique_ptr<Trailer> trailer);
 	bool RemoveTrailer();
 	const Trailer* GetTrailer() const;
+	bool IsTowing() const;
 
-	virtual unsigned int GetMaxSpeed() const override;
 	virtual void TravelByMachina(const engine::core::TravelContext& context) override;
 
 	// Capability accessor
 	unsigned int GetDriveSpeed() const;
 	const engine::capabilities::DrivingCapability& GetDrivingCapability() const;
 
+	virtual engine::capabilities::CapabilityMask GetCapabilities() const override;
+	virtual unsigned int GetCapabilitySpeed(engine::capabilities::Capability capability) const override;
+	virtual unsigned int EstimateMaxSpeed(unsigned int passengersWeight) const override;
+
+protected:
+	virtual unsigned int ComputeMaxSpeed() const override;
+	virtual void WriteSnapshot(engine::core::SnapshotWriter& writer) const override;
+	virtual bool ReadSnapshot(engine::core::SnapshotReader& reader) override;
+
 private:
-	enum { IDLE_TIME = 1, MOVE_TIME = 5, IDLE_TIME_TRAIL_ON = 2 };
+	unsigned int DriveSpeedAt(unsigned int passengersWeight) const;
 
 	engine::capabilities::DrivingCapability mDriving;
 	std::unique_ptr<Trailer> mTrailer;
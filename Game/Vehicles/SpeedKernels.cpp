@@ -0,0 +1,440 @@
+#include <algorithm>
+#include <cmath>
+#include "SpeedKernels.h"
+#include "Airplane.h"
+#include "Boatplane.h"
+#include "Motorcycle.h"
+#include "UBoat.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define MACHINA_SPEED_KERNELS_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace game {
+namespace vehicles {
+namespace kernels {
+
+namespace {
+
+// Scalar curves. These must stay expression-for-expression identical to the
+// per-vehicle accessors so the fallback path is bit-exact.
+
+unsigned int AirplaneFly1(double base, unsigned int weight)
+{
+	return static_cast<unsigned int>((200.0 * exp((base - weight) / 500.0)) + 0.5);
+}
+
+unsigned int AirplaneDrive1(double base, unsigned int weight)
+{
+	return static_cast<unsigned int>(4.0 * exp((base - weight) / 70.0) + 0.5);
+}
+
+unsigned int BoatplaneFly1(double base, unsigned int weight)
+{
+	return static_cast<unsigned int>(round(150.0 * exp((base - weight) / 300.0)));
+}
+
+unsigned int BoatplaneSail1(double base, unsigned int weight)
+{
+	return static_cast<unsigned int>(std::max(static_cast<int>(round(base - 1.7 * weight)), 20));
+}
+
+unsigned int UBoatSail1(double base, unsigned int weight)
+{
+	return static_cast<unsigned int>(std::max(static_cast<int>((base - weight / 10.0) + 0.5), 200));
+}
+
+unsigned int UBoatDive1(double base, unsigned int weight)
+{
+	return static_cast<unsigned int>((500 * log((weight + base) / base) + 30) + 0.5);
+}
+
+unsigned int MotorcycleDrive1(double base, unsigned int weight)
+{
+	double w = static_cast<double>(weight);
+	return static_cast<unsigned int>(std::max(base + (2 * w) - pow(w / 15.0, 3) + 0.5, 0.0));
+}
+
+typedef unsigned int (*ScalarCurve)(double base, unsigned int weight);
+
+void RunScalar(ScalarCurve curve, unsigned int base, const unsigned int* weights, unsigned int* outSpeeds, size_t count)
+{
+	double baseParam = static_cast<double>(base);
+	for (size_t i = 0; i < count; ++i)
+	{
+		outSpeeds[i] = curve(baseParam, weights[i]);
+	}
+}
+
+void RunScalarMax(ScalarCurve first, unsigned int firstBase, ScalarCurve second, unsigned int secondBase,
+	const unsigned int* weights, unsigned int* outSpeeds, size_t count)
+{
+	double firstParam = static_cast<double>(firstBase);
+	double secondParam = static_cast<double>(secondBase);
+	for (size_t i = 0; i < count; ++i)
+	{
+		unsigned int a = first(firstParam, weights[i]);
+		unsigned int b = second(secondParam, weights[i]);
+		outSpeeds[i] = a > b ? a : b;
+	}
+}
+
+#if MACHINA_SPEED_KERNELS_AVX2
+
+#define MACHINA_AVX2_TARGET __attribute__((target("avx2,fma")))
+
+const double LN2_HI = 6.93147180369123816490e-01;
+const double LN2_LO = 1.90821492927058770002e-10;
+// Adding 2^52 + 2^51 to an integral double leaves the integer in the low
+// mantissa bits, which is the cheapest double <-> int64 conversion in AVX2.
+const double INT_MAGIC = 6755399441055744.0;
+
+// exp(x): x = k*ln2 + r with |r| <= ln2/2, e^r by a degree-12 Taylor
+// polynomial (truncation error < 2e-16), 2^k spliced into the exponent bits.
+MACHINA_AVX2_TARGET inline __m256d Exp4(__m256d x)
+{
+	x = _mm256_max_pd(_mm256_min_pd(x, _mm256_set1_pd(700.0)), _mm256_set1_pd(-700.0));
+
+	__m256d k = _mm256_round_pd(_mm256_mul_pd(x, _mm256_set1_pd(1.4426950408889634)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+	__m256d r = _mm256_fnmadd_pd(k, _mm256_set1_pd(LN2_HI), x);
+	r = _mm256_fnmadd_pd(k, _mm256_set1_pd(LN2_LO), r);
+
+	__m256d p = _mm256_set1_pd(1.0 / 479001600.0);
+	p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1.0 / 39916800.0));
+	p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1.0 / 3628800.0));
+	p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1.0 / 362880.0));
+	p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1.0 / 40320.0));
+	p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1.0 / 5040.0));
+	p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1.0 / 720.0));
+	p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1.0 / 120.0));
+	p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1.0 / 24.0));
+	p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1.0 / 6.0));
+	p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(0.5));
+	p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1.0));
+	p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1.0));
+
+	__m256i magic = _mm256_castpd_si256(_mm256_set1_pd(INT_MAGIC));
+	__m256i ki = _mm256_sub_epi64(_mm256_castpd_si256(_mm256_add_pd(k, _mm256_set1_pd(INT_MAGIC))), magic);
+	__m256i scaleBits = _mm256_slli_epi64(_mm256_add_epi64(ki, _mm256_set1_epi64x(1023)), 52);
+	return _mm256_mul_pd(p, _mm256_castsi256_pd(scaleBits));
+}
+
+// log(x) for positive normal x: x = 2^e * m with m in [sqrt(2)/2, sqrt(2)),
+// log(m) = 2*atanh(s) with s = (m - 1) / (m + 1), |s| < 0.172, by an 11-term
+// odd series (truncation error < 1e-17).
+MACHINA_AVX2_TARGET inline __m256d Log4(__m256d x)
+{
+	__m256i bits = _mm256_castpd_si256(x);
+	__m256i exponent = _mm256_sub_epi64(_mm256_srli_epi64(bits, 52), _mm256_set1_epi64x(1023));
+	__m256i mantissaBits = _mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi64x(0x000FFFFFFFFFFFFFLL)), _mm256_set1_epi64x(0x3FF0000000000000LL));
+	__m256d m = _mm256_castsi256_pd(mantissaBits);
+
+	__m256i magic = _mm256_castpd_si256(_mm256_set1_pd(INT_MAGIC));
+	__m256d e = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_add_epi64(exponent, magic)), _mm256_set1_pd(INT_MAGIC));
+
+	__m256d isHigh = _mm256_cmp_pd(m, _mm256_set1_pd(1.4142135623730951), _CMP_GT_OQ);
+	m = _mm256_blendv_pd(m, _mm256_mul_pd(m, _mm256_set1_pd(0.5)), isHigh);
+	e = _mm256_add_pd(e, _mm256_and_pd(isHigh, _mm256_set1_pd(1.0)));
+
+	__m256d f = _mm256_sub_pd(m, _mm256_set1_pd(1.0));
+	__m256d s = _mm256_div_pd(f, _mm256_add_pd(f, _mm256_set1_pd(2.0)));
+	__m256d s2 = _mm256_mul_pd(s, s);
+
+	__m256d p = _mm256_set1_pd(1.0 / 21.0);
+	p = _mm256_fmadd_pd(p, s2, _mm256_set1_pd(1.0 / 19.0));
+	p = _mm256_fmadd_pd(p, s2, _mm256_set1_pd(1.0 / 17.0));
+	p = _mm256_fmadd_pd(p, s2, _mm256_set1_pd(1.0 / 15.0));
+	p = _mm256_fmadd_pd(p, s2, _mm256_set1_pd(1.0 / 13.0));
+	p = _mm256_fmadd_pd(p, s2, _mm256_set1_pd(1.0 / 11.0));
+	p = _mm256_fmadd_pd(p, s2, _mm256_set1_pd(1.0 / 9.0));
+	p = _mm256_fmadd_pd(p, s2, _mm256_set1_pd(1.0 / 7.0));
+	p = _mm256_fmadd_pd(p, s2, _mm256_set1_pd(1.0 / 5.0));
+	p = _mm256_fmadd_pd(p, s2, _mm256_set1_pd(1.0 / 3.0));
+	p = _mm256_mul_pd(_mm256_mul_pd(p, s2), s);
+	__m256d logM = _mm256_add_pd(_mm256_add_pd(s, p), _mm256_add_pd(s, p));
+
+	__m256d lo = _mm256_fmadd_pd(e, _mm256_set1_pd(LN2_LO), logM);
+	return _mm256_fmadd_pd(e, _mm256_set1_pd(LN2_HI), lo);
+}
+
+// A vector curve yields, per lane, the value the accessor truncates (rounding
+// offset included, lower clamp not yet applied), the largest term summed
+// into it, which scales its approximation error, and the clamp.
+struct Lanes
+{
+	__m256d value;
+	__m256d magnitude;
+	__m256d minimum;
+};
+
+MACHINA_AVX2_TARGET inline Lanes MakeLanes(__m256d value, __m256d magnitude, double minimum)
+{
+	Lanes lanes;
+	lanes.value = value;
+	lanes.magnitude = magnitude;
+	lanes.minimum = _mm256_set1_pd(minimum);
+	return lanes;
+}
+
+MACHINA_AVX2_TARGET inline Lanes AirplaneFly4(__m256d base, __m256d w)
+{
+	__m256d x = _mm256_div_pd(_mm256_sub_pd(base, w), _mm256_set1_pd(500.0));
+	__m256d v = _mm256_mul_pd(_mm256_set1_pd(200.0), Exp4(x));
+	return MakeLanes(_mm256_add_pd(v, _mm256_set1_pd(0.5)), v, 0.0);
+}
+
+MACHINA_AVX2_TARGET inline Lanes AirplaneDrive4(__m256d base, __m256d w)
+{
+	__m256d x = _mm256_div_pd(_mm256_sub_pd(base, w), _mm256_set1_pd(70.0));
+	__m256d v = _mm256_mul_pd(_mm256_set1_pd(4.0), Exp4(x));
+	return MakeLanes(_mm256_add_pd(v, _mm256_set1_pd(0.5)), v, 0.0);
+}
+
+MACHINA_AVX2_TARGET inline Lanes BoatplaneFly4(__m256d base, __m256d w)
+{
+	__m256d x = _mm256_div_pd(_mm256_sub_pd(base, w), _mm256_set1_pd(300.0));
+	__m256d v = _mm256_mul_pd(_mm256_set1_pd(150.0), Exp4(x));
+	return MakeLanes(_mm256_add_pd(v, _mm256_set1_pd(0.5)), v, 0.0);
+}
+
+MACHINA_AVX2_TARGET inline Lanes BoatplaneSail4(__m256d base, __m256d w)
+{
+	__m256d load = _mm256_mul_pd(_mm256_set1_pd(1.7), w);
+	__m256d v = _mm256_sub_pd(base, load);
+	return MakeLanes(_mm256_add_pd(v, _mm256_set1_pd(0.5)), _mm256_add_pd(base, load), 20.0);
+}
+
+MACHINA_AVX2_TARGET inline Lanes UBoatSail4(__m256d base, __m256d w)
+{
+	__m256d load = _mm256_div_pd(w, _mm256_set1_pd(10.0));
+	__m256d v = _mm256_add_pd(_mm256_sub_pd(base, load), _mm256_set1_pd(0.5));
+	return MakeLanes(v, _mm256_add_pd(base, load), 200.0);
+}
+
+MACHINA_AVX2_TARGET inline Lanes UBoatDive4(__m256d base, __m256d w)
+{
+	__m256d ratio = _mm256_div_pd(_mm256_add_pd(w, base), base);
+	__m256d v = _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(500.0), Log4(ratio)), _mm256_set1_pd(30.0));
+	return MakeLanes(_mm256_add_pd(v, _mm256_set1_pd(0.5)), v, 0.0);
+}
+
+MACHINA_AVX2_TARGET inline Lanes MotorcycleDrive4(__m256d base, __m256d w)
+{
+	__m256d x = _mm256_div_pd(w, _mm256_set1_pd(15.0));
+	__m256d cube = _mm256_mul_pd(_mm256_mul_pd(x, x), x);
+	__m256d gain = _mm256_add_pd(base, _mm256_add_pd(w, w));
+	__m256d v = _mm256_add_pd(_mm256_sub_pd(gain, cube), _mm256_set1_pd(0.5));
+	return MakeLanes(v, _mm256_add_pd(gain, cube), 0.0);
+}
+
+typedef Lanes (*VectorCurve)(__m256d base, __m256d weights);
+
+// Relative guard band around rounding boundaries; see the header.
+const double BOUNDARY_GUARD = 1.0 / 68719476736.0;    // 2^-36
+// _mm256_cvttpd_epi32 only covers speeds below 2^31.
+const double SPEED_LIMIT = 2147483648.0;
+
+// Clamps and truncates `lanes` like the accessor does, and flags in
+// `outUnsure` the lanes whose result the approximation cannot guarantee.
+MACHINA_AVX2_TARGET inline __m256d Resolve(const Lanes& lanes, __m256d& outUnsure)
+{
+	__m256d guard = _mm256_mul_pd(_mm256_add_pd(lanes.magnitude, _mm256_set1_pd(1.0)), _mm256_set1_pd(BOUNDARY_GUARD));
+	__m256d nearest = _mm256_round_pd(lanes.value, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+	__m256d distance = _mm256_andnot_pd(_mm256_set1_pd(-0.0), _mm256_sub_pd(lanes.value, nearest));
+	// Far enough below the clamp, both paths clamp.
+	__m256d isClamped = _mm256_cmp_pd(_mm256_add_pd(lanes.value, guard), lanes.minimum, _CMP_LE_OQ);
+	__m256d isNearBoundary = _mm256_andnot_pd(isClamped, _mm256_cmp_pd(distance, guard, _CMP_LT_OQ));
+	__m256d isTooFast = _mm256_cmp_pd(lanes.value, _mm256_set1_pd(SPEED_LIMIT), _CMP_GE_OQ);
+	outUnsure = _mm256_or_pd(outUnsure, _mm256_or_pd(isNearBoundary, isTooFast));
+	return _mm256_max_pd(lanes.value, lanes.minimum);
+}
+
+MACHINA_AVX2_TARGET inline __m256d LoadWeights4(const unsigned int* weights)
+{
+	// Converted as signed; weights from 2^31 up come out 2^32 too small.
+	__m256d w = _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(weights)));
+	__m256d isWrapped = _mm256_cmp_pd(w, _mm256_setzero_pd(), _CMP_LT_OQ);
+	return _mm256_add_pd(w, _mm256_and_pd(isWrapped, _mm256_set1_pd(4294967296.0)));
+}
+
+MACHINA_AVX2_TARGET inline void StoreSpeeds4(unsigned int* outSpeeds, __m256d speeds)
+{
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(outSpeeds), _mm256_cvttpd_epi32(speeds));
+}
+
+template <VectorCurve Curve>
+MACHINA_AVX2_TARGET void RunAvx2(ScalarCurve scalar, unsigned int base, const unsigned int* weights, unsigned int* outSpeeds, size_t count)
+{
+	__m256d baseParam = _mm256_set1_pd(static_cast<double>(base));
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m256d unsure = _mm256_setzero_pd();
+		StoreSpeeds4(outSpeeds + i, Resolve(Curve(baseParam, LoadWeights4(weights + i)), unsure));
+		int unsureMask = _mm256_movemask_pd(unsure);
+		if (unsureMask != 0)
+		{
+			for (size_t lane = 0; lane < 4; ++lane)
+			{
+				if ((unsureMask >> lane) & 1)
+				{
+					RunScalar(scalar, base, weights + i + lane, outSpeeds + i + lane, 1);
+				}
+			}
+		}
+	}
+	RunScalar(scalar, base, weights + i, outSpeeds + i, count - i);
+}
+
+// Both curves are non-negative and truncation is monotonic, so the max can be
+// taken before converting to integers.
+template <VectorCurve First, VectorCurve Second>
+MACHINA_AVX2_TARGET void RunAvx2Max(ScalarCurve firstScalar, unsigned int firstBase, ScalarCurve secondScalar, unsigned int secondBase,
+	const unsigned int* weights, unsigned int* outSpeeds, size_t count)
+{
+	__m256d firstParam = _mm256_set1_pd(static_cast<double>(firstBase));
+	__m256d secondParam = _mm256_set1_pd(static_cast<double>(secondBase));
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m256d w = LoadWeights4(weights + i);
+		__m256d unsure = _mm256_setzero_pd();
+		__m256d first = Resolve(First(firstParam, w), unsure);
+		__m256d second = Resolve(Second(secondParam, w), unsure);
+		StoreSpeeds4(outSpeeds + i, _mm256_max_pd(first, second));
+		int unsureMask = _mm256_movemask_pd(unsure);
+		if (unsureMask != 0)
+		{
+			for (size_t lane = 0; lane < 4; ++lane)
+			{
+				if ((unsureMask >> lane) & 1)
+				{
+					RunScalarMax(firstScalar, firstBase, secondScalar, secondBase, weights + i + lane, outSpeeds + i + lane, 1);
+				}
+			}
+		}
+	}
+	RunScalarMax(firstScalar, firstBase, secondScalar, secondBase, weights + i, outSpeeds + i, count - i);
+}
+
+bool DetectAvx2()
+{
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+}
+
+const bool HAS_AVX2 = DetectAvx2();
+
+#endif // MACHINA_SPEED_KERNELS_AVX2
+
+} // namespace
+
+#if MACHINA_SPEED_KERNELS_AVX2
+#define MACHINA_DISPATCH(vectorCall, scalarCall) if (HAS_AVX2) { vectorCall; } else { scalarCall; }
+#else
+#define MACHINA_DISPATCH(vectorCall, scalarCall) scalarCall;
+#endif
+
+void AirplaneFlySpeeds(unsigned int baseFlySpeed, const unsigned int* weights, unsigned int* outSpeeds, size_t count)
+{
+	MACHINA_DISPATCH(
+		(RunAvx2<AirplaneFly4>(AirplaneFly1, baseFlySpeed, weights, outSpeeds, count)),
+		(RunScalar(AirplaneFly1, baseFlySpeed, weights, outSpeeds, count)))
+}
+
+void AirplaneDriveSpeeds(unsigned int baseDriveSpeed, const unsigned int* weights, unsigned int* outSpeeds, size_t count)
+{
+	MACHINA_DISPATCH(
+		(RunAvx2<AirplaneDrive4>(AirplaneDrive1, baseDriveSpeed, weights, outSpeeds, count)),
+		(RunScalar(AirplaneDrive1, baseDriveSpeed, weights, outSpeeds, count)))
+}
+
+void AirplaneMaxSpeeds(unsigned int baseFlySpeed, unsigned int baseDriveSpeed, const unsigned int* weights, unsigned int* outSpeeds, size_t count)
+{
+	MACHINA_DISPATCH(
+		(RunAvx2Max<AirplaneFly4, AirplaneDrive4>(AirplaneFly1, baseFlySpeed, AirplaneDrive1, baseDriveSpeed, weights, outSpeeds, count)),
+		(RunScalarMax(AirplaneFly1, baseFlySpeed, AirplaneDrive1, baseDriveSpeed, weights, outSpeeds, count)))
+}
+
+void BoatplaneFlySpeeds(unsigned int baseFlySpeed, const unsigned int* weights, unsigned int* outSpeeds, size_t count)
+{
+	MACHINA_DISPATCH(
+		(RunAvx2<BoatplaneFly4>(BoatplaneFly1, baseFlySpeed, weights, outSpeeds, count)),
+		(RunScalar(BoatplaneFly1, baseFlySpeed, weights, outSpeeds, count)))
+}
+
+void BoatplaneSailSpeeds(unsigned int baseSailSpeed, const unsigned int* weights, unsigned int* outSpeeds, size_t count)
+{
+	MACHINA_DISPATCH(
+		(RunAvx2<BoatplaneSail4>(BoatplaneSail1, baseSailSpeed, weights, outSpeeds, count)),
+		(RunScalar(BoatplaneSail1, baseSailSpeed, weights, outSpeeds, count)))
+}
+
+void BoatplaneMaxSpeeds(unsigned int baseFlySpeed, unsigned int baseSailSpeed, const unsigned int* weights, unsigned int* outSpeeds, size_t count)
+{
+	MACHINA_DISPATCH(
+		(RunAvx2Max<BoatplaneFly4, BoatplaneSail4>(BoatplaneFly1, baseFlySpeed, BoatplaneSail1, baseSailSpeed, weights, outSpeeds, count)),
+		(RunScalarMax(BoatplaneFly1, baseFlySpeed, BoatplaneSail1, baseSailSpeed, weights, outSpeeds, count)))
+}
+
+void UBoatSailSpeeds(unsigned int baseSailSpeed, const unsigned int* weights, unsigned int* outSpeeds, size_t count)
+{
+	MACHINA_DISPATCH(
+		(RunAvx2<UBoatSail4>(UBoatSail1, baseSailSpeed, weights, outSpeeds, count)),
+		(RunScalar(UBoatSail1, baseSailSpeed, weights, outSpeeds, count)))
+}
+
+void UBoatDiveSpeeds(unsigned int baseDiveSpeed, const unsigned int* weights, unsigned int* outSpeeds, size_t count)
+{
+	MACHINA_DISPATCH(
+		(RunAvx2<UBoatDive4>(UBoatDive1, baseDiveSpeed, weights, outSpeeds, count)),
+		(RunScalar(UBoatDive1, baseDiveSpeed, weights, outSpeeds, count)))
+}
+
+void UBoatMaxSpeeds(unsigned int baseSailSpeed, unsigned int baseDiveSpeed, const unsigned int* weights, unsigned int* outSpeeds, size_t count)
+{
+	MACHINA_DISPATCH(
+		(RunAvx2Max<UBoatSail4, UBoatDive4>(UBoatSail1, baseSailSpeed, UBoatDive1, baseDiveSpeed, weights, outSpeeds, count)),
+		(RunScalarMax(UBoatSail1, baseSailSpeed, UBoatDive1, baseDiveSpeed, weights, outSpeeds, count)))
+}
+
+void MotorcycleDriveSpeeds(unsigned int baseDriveSpeed, const unsigned int* weights, unsigned int* outSpeeds, size_t count)
+{
+	MACHINA_DISPATCH(
+		(RunAvx2<MotorcycleDrive4>(MotorcycleDrive1, baseDriveSpeed, weights, outSpeeds, count)),
+		(RunScalar(MotorcycleDrive1, baseDriveSpeed, weights, outSpeeds, count)))
+}
+
+void EstimateMaxSpeeds(const Airplane& vehicle, const unsigned int* weights, unsigned int* outSpeeds, size_t count)
+{
+	AirplaneMaxSpeeds(vehicle.GetFlyingCapability().GetFlySpeed(), vehicle.GetDrivingCapability().GetDriveSpeed(), weights, outSpeeds, count);
+}
+
+void EstimateMaxSpeeds(const Boatplane& vehicle, const unsigned int* weights, unsigned int* outSpeeds, size_t count)
+{
+	BoatplaneMaxSpeeds(vehicle.GetFlyingCapability().GetFlySpeed(), vehicle.GetSailingCapability().GetSailSpeed(), weights, outSpeeds, count);
+}
+
+void EstimateMaxSpeeds(const UBoat& vehicle, const unsigned int* weights, unsigned int* outSpeeds, size_t count)
+{
+	UBoatMaxSpeeds(vehicle.GetSailingCapability().GetSailSpeed(), vehicle.GetDivingCapability().GetDiveSpeed(), weights, outSpeeds, count);
+}
+
+void EstimateMaxSpeeds(const Motorcycle& vehicle, const unsigned int* weights, unsigned int* outSpeeds, size_t count)
+{
+	MotorcycleDriveSpeeds(vehicle.GetDrivingCapability().GetDriveSpeed(), weights, outSpeeds, count);
+}
+
+bool IsVectorized()
+{
+#if MACHINA_SPEED_KERNELS_AVX2
+	return HAS_AVX2;
+#else
+	return false;
+#endif
+}
+
+} // namespace kernels
+} // namespace vehicles
+} // namespace game
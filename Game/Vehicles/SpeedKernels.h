@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+
+namespace game {
+namespace vehicles {
+
+class Airplane;
+class Boatplane;
+class Motorcycle;
+class UBoat;
+
+namespace kernels {
+
+// Batch versions of the per-vehicle speed curves. Each kernel takes one
+// passenger weight per vehicle and writes one speed per vehicle, using the
+// capability base parameter shared by the batch.
+//
+// Every kernel returns exactly what the matching accessor (Airplane::
+// GetFlySpeed etc.) returns for the same weight: the maximum error against
+// the accessors' rounding is zero, on every path.
+//
+// On x86-64 GCC/Clang builds running on an AVX2+FMA CPU the curves are
+// evaluated four vehicles at a time, with exp and log replaced by polynomial
+// approximations and the Motorcycle cubic by x*x*x. Before rounding, a lane
+// differs from the libm value by at most 2^-51 of its largest term (measured
+// at the game's base speeds for weights 0..10^6). A lane whose unrounded
+// speed lies within 2^-36 of its largest term of a rounding boundary is
+// recomputed with the scalar curve, so truncation and round() always land on
+// the accessor's integer. No exp/log lane was recomputed over that range; the
+// linear Boatplane and UBoat sail curves hit a boundary exactly at some
+// weights (UBoat sail at every tenth) and take the scalar curve there. All
+// other builds and CPUs use the scalar curves, which are
+// expression-for-expression the accessors'.
+
+void AirplaneFlySpeeds(unsigned int baseFlySpeed, const unsigned int* weights, unsigned int* outSpeeds, size_t count);
+void AirplaneDriveSpeeds(unsigned int baseDriveSpeed, const unsigned int* weights, unsigned int* outSpeeds, size_t count);
+void AirplaneMaxSpeeds(unsigned int baseFlySpeed, unsigned int baseDriveSpeed, const unsigned int* weights, unsigned int* outSpeeds, size_t count);
+
+void BoatplaneFlySpeeds(unsigned int baseFlySpeed, const unsigned int* weights, unsigned int* outSpeeds, size_t count);
+void BoatplaneSailSpeeds(unsigned int baseSailSpeed, const unsigned int* weights, unsigned int* outSpeeds, size_t count);
+void BoatplaneMaxSpeeds(unsigned int baseFlySpeed, unsigned int baseSailSpeed, const unsigned int* weights, unsigned int* outSpeeds, size_t count);
+
+void UBoatSailSpeeds(unsigned int baseSailSpeed, const unsigned int* weights, unsigned int* outSpeeds, size_t count);
+void UBoatDiveSpeeds(unsigned int baseDiveSpeed, const unsigned int* weights, unsigned int* outSpeeds, size_t count);
+void UBoatMaxSpeeds(unsigned int baseSailSpeed, unsigned int baseDiveSpeed, const unsigned int* weights, unsigned int* outSpeeds, size_t count);
+
+void MotorcycleDriveSpeeds(unsigned int baseDriveSpeed, const unsigned int* weights, unsigned int* outSpeeds, size_t count);
+
+// Batch EstimateMaxSpeed for vehicles sharing `vehicle`'s base speeds, e.g.
+// to reweigh a fleet after mass boarding: outSpeeds[i] ==
+// vehicle.EstimateMaxSpeed(weights[i]).
+void EstimateMaxSpeeds(const Airplane& vehicle, const unsigned int* weights, unsigned int* outSpeeds, size_t count);
+void EstimateMaxSpeeds(const Boatplane& vehicle, const unsigned int* weights, unsigned int* outSpeeds, size_t count);
+void EstimateMaxSpeeds(const UBoat& vehicle, const unsigned int* weights, unsigned int* outSpeeds, size_t count);
+void EstimateMaxSpeeds(const Motorcycle& vehicle, const unsigned int* weights, unsigned int* outSpeeds, size_t count);
+
+// True when the vectorized path is compiled in and supported by this CPU.
+bool IsVectorized();
+
+} // namespace kernels
+} // namespace vehicles
+} // namespace game
@@ -1,14 +1,15 @@
 #include <cmath>
 #include <algorithm>
 #include "UBoat.h"
+#include "../../Engine/Core/SnapshotStream.h"
 
 namespace game {
 namespace vehicles {
 
 UBoat::UBoat()
 	: Vehicle(50)
-	, mSailing(550)   // base sail speed parameter
-	, mDiving(150)    // base dive speed parameter
+	, mSailing(550, this)   // base sail speed parameter
+	, mDiving(150, this)    // base dive speed parameter
 {
 }
 
@@ -16,21 +17,45 @@ UBoat::~UBoat()
 {
 }
 
-unsigned int UBoat::GetMaxSpeed() const
+UBoat::UBoat(UBoat&& other) noexcept
+	: Vehicle(std::move(other))
+	, mSailing(other.mSailing.GetSailSpeed(), this)
+	, mDiving(other.mDiving.GetDiveSpeed(), this)
 {
-	return GetSailSpeed() > GetDiveSpeed() ? GetSailSpeed() : GetDiveSpeed();
+}
+
+unsigned int UBoat::ComputeMaxSpeed() const
+{
+	return EstimateMaxSpeed(GetPassengersWeight());
+}
+
+unsigned int UBoat::EstimateMaxSpeed(unsigned int passengersWeight) const
+{
+	unsigned int sailingSpeed = SailSpeedAt(passengersWeight);
+	unsigned int divingSpeed = DiveSpeedAt(passengersWeight);
+	return sailingSpeed > divingSpeed ? sailingSpeed : divingSpeed;
 }
 
 unsigned int UBoat::GetSailSpeed() const
+{
+	return SailSpeedAt(GetPassengersWeight());
+}
+
+unsigned int UBoat::SailSpeedAt(unsigned int passengersWeight) const
 {
 	double baseParam = static_cast<double>(mSailing.GetSailSpeed());
-	return static_cast<unsigned int>(std::max(static_cast<int>((baseParam - GetPassengersWeight() / 10.0) + 0.5), 200));
+	return static_cast<unsigned int>(std::max(static_cast<int>((baseParam - passengersWeight / 10.0) + 0.5), 200));
 }
 
 unsigned int UBoat::GetDiveSpeed() const
+{
+	return DiveSpeedAt(GetPassengersWeight());
+}
+
+unsigned int UBoat::DiveSpeedAt(unsigned int passengersWeight) const
 {
 	double baseParam = static_cast<double>(mDiving.GetDiveSpeed());
-	return static_cast<unsigned int>((500 * log((GetPassengersWeight() + baseParam) / baseParam) + 30) + 0.5);
+	return static_cast<unsigned int>((500 * log((passengersWeight + baseParam) / baseParam) + 30) + 0.5);
 }
 
 const engine::capabilities::SailingCapability& UBoat::GetSailingCapability() const
@@ -43,27 +68,45 @@ const engine::capabilities::DivingCapability& UBoat::GetDivingCapability() const
 	return mDiving;
 }
 
-void UBoat::TravelByMachina(const engine::core::TravelContext& /*context*/)
+engine::capabilities::CapabilityMask UBoat::GetCapabilities() const
 {
-	unsigned int moveTime = GetMoveTime();
-	unsigned int idleTime = GetIdleTime();
-	unsigned int speed = GetMaxSpeed();
-	//check available
-	if (moveTime < MOVE_TIME)
+	return engine::capabilities::ToMask(engine::capabilities::Capability::SAILING)
+		| engine::capabilities::ToMask(engine::capabilities::Capability::DIVING);
+}
+
+unsigned int UBoat::GetCapabilitySpeed(engine::capabilities::Capability capability) const
+{
+	switch (capability)
 	{
-		//move
-		AddMoveTime();
-		AddOdo(speed);
+	case engine::capabilities::Capability::SAILING: return GetSailSpeed();
+	case engine::capabilities::Capability::DIVING: return GetDiveSpeed();
+	default: return 0;
 	}
-	else if (moveTime == MOVE_TIME && idleTime < IDLE_TIME)
+}
+
+void UBoat::TravelByMachina(const engine::core::TravelContext& context)
+{
+	TravelByPolicy<UBoat>(context);
+}
+
+void UBoat::WriteSnapshot(engine::core::SnapshotWriter& writer) const
+{
+	writer.Write(mSailing.GetSailSpeed());
+	writer.Write(mDiving.GetDiveSpeed());
+}
+
+bool UBoat::ReadSnapshot(engine::core::SnapshotReader& reader)
+{
+	uint32_t sailSpeed;
+	uint32_t diveSpeed;
+	if (!reader.Read(sailSpeed) || !reader.Read(diveSpeed))
 	{
-		AddIdleTime();
-		if (GetIdleTime() == IDLE_TIME)
-		{
-			ResetMoveTime();
-			ResetIdleTIme();
-		}
+		return false;
 	}
+
+	mSailing.SetSailSpeed(sailSpeed);
+	mDiving.SetDiveSpeed(diveSpeed);
+	return true;
 }
 
 } // namespace vehicles
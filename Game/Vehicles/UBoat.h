@@ -9,14 +9,15 @@ namespace vehicles {
 class UBoat : public engine::vehicles::Vehicle
 {
 public:
+	using TravelPolicy = engine::core::DutyCycle<2, 4>;
+
 	UBoat();
 	virtual ~UBoat();
 
 	// Move-only (inherited from Vehicle)
-	UBoat(UBoat&&) = default;
+	UBoat(UBoat&& other) noexcept;
 	UBoat& operator=(UBoat&&) = default;
 
-	virtual unsigned int GetMaxSpeed() const override;
 	virtual void TravelByMachina(const engine::core::TravelContext& context) override;
 
 	// Capability accessors
@@ -26,8 +27,18 @@ public:
 	const engine::capabilities::SailingCapability& GetSailingCapability() const;
 	const engine::capabilities::DivingCapability& GetDivingCapability() const;
 
+	virtual engine::capabilities::CapabilityMask GetCapabilities() const override;
+	virtual unsigned int GetCapabilitySpeed(engine::capabilities::Capability capability) const override;
+	virtual unsigned int EstimateMaxSpeed(unsigned int passengersWeight) const override;
+
+protected:
+	virtual unsigned int ComputeMaxSpeed() const override;
+	virtual void WriteSnapshot(engine::core::SnapshotWriter& writer) const override;
+	virtual bool ReadSnapshot(engine::core::SnapshotReader& reader) override;
+
 private:
-	enum { IDLE_TIME = 4, MOVE_TIME = 2 };
+	unsigned int SailSpeedAt(unsigned int passengersWeight) const;
+	unsigned int DiveSpeedAt(unsigned int passengersWeight) const;
 
 	engine::capabilities::SailingCapability mSailing;
 	engine::capabilities::DivingCapability mDiving;
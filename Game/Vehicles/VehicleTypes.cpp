@@ -0,0 +1,54 @@
+#include <memory>
+#include "VehicleTypes.h"
+#include "Airplane.h"
+#include "Boat.h"
+#include "Boatplane.h"
+#include "Motorcycle.h"
+#include "Person.h"
+#include "Sedan.h"
+#include "UBoat.h"
+
+namespace game {
+namespace vehicles {
+
+using engine::core::NameTable;
+using engine::core::VehicleTypeRegistry;
+using engine::interfaces::IPassenger;
+using engine::vehicles::Vehicle;
+
+void RegisterVehicleTypes(VehicleTypeRegistry& types)
+{
+	// Fixed-capacity types ignore the stored count; Restore rejects a mismatch.
+	types.RegisterVehicleType<Airplane>("Airplane", [](unsigned int maxPassengersCount) -> std::unique_ptr<Vehicle>
+	{
+		return std::make_unique<Airplane>(maxPassengersCount);
+	});
+	types.RegisterVehicleType<Boat>("Boat", [](unsigned int maxPassengersCount) -> std::unique_ptr<Vehicle>
+	{
+		return std::make_unique<Boat>(maxPassengersCount);
+	});
+	types.RegisterVehicleType<Boatplane>("Boatplane", [](unsigned int maxPassengersCount) -> std::unique_ptr<Vehicle>
+	{
+		return std::make_unique<Boatplane>(maxPassengersCount);
+	});
+	types.RegisterVehicleType<Motorcycle>("Motorcycle", [](unsigned int) -> std::unique_ptr<Vehicle>
+	{
+		return std::make_unique<Motorcycle>();
+	});
+	types.RegisterVehicleType<Sedan>("Sedan", [](unsigned int) -> std::unique_ptr<Vehicle>
+	{
+		return std::make_unique<Sedan>();
+	});
+	types.RegisterVehicleType<UBoat>("UBoat", [](unsigned int) -> std::unique_ptr<Vehicle>
+	{
+		return std::make_unique<UBoat>();
+	});
+
+	types.SetPassengerFactory([](NameTable::NameId nameId, unsigned int weight) -> std::unique_ptr<const IPassenger>
+	{
+		return std::make_unique<Person>(nameId, weight);
+	});
+}
+
+} // namespace vehicles
+} // namespace game
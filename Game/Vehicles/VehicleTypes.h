@@ -0,0 +1,13 @@
+#pragma once
+
+#include "../../Engine/Core/VehicleTypeRegistry.h"
+
+namespace game {
+namespace vehicles {
+
+// Registers every Game vehicle type (and Person as the passenger type) for
+// snapshots and journals. The names are the on-disk type keys; never rename them.
+void RegisterVehicleTypes(engine::core::VehicleTypeRegistry& types);
+
+} // namespace vehicles
+} // namespace game
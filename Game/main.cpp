@@ -1,17 +1,32 @@
 #include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
 #include <iomanip>
 #include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
 
+#include "../Engine/Vehicles/ArchetypeVehicle.h"
 #include "../Engine/Vehicles/Vehicle.h"
 #include "Vehicles/Airplane.h"
 #include "Vehicles/Boat.h"
 #include "Vehicles/Boatplane.h"
 #include "Vehicles/Motorcycle.h"
 #include "Vehicles/Sedan.h"
+#include "Vehicles/SpeedKernels.h"
 #include "Vehicles/Trailer.h"
 #include "Vehicles/UBoat.h"
+#include "Vehicles/VehicleTypes.h"
+#include "../Engine/Core/ArchetypeTable.h"
 #include "../Engine/Core/DeusExMachina.h"
+#include "../Engine/Core/EngineMetrics.h"
+#include "../Engine/Core/EngineTrace.h"
+#include "../Engine/Core/FleetSnapshot.h"
+#include "../Engine/Core/JournalReplay.h"
+#include "../Engine/Core/ShardedWorld.h"
 #include "../Engine/Core/TravelContext.h"
 #include "Vehicles/Person.h"
 
@@ -25,6 +40,11 @@ int main()
 	assert(p->GetName() == std::string("Bob"));
 	assert(p->GetWeight() == 85);
 
+	// Names are interned: equal names share one id and one stored string.
+	Person bobAgain("Bob", 90);
+	assert(bobAgain.GetNameId() == p->GetNameId());
+	assert(&bobAgain.GetName() == &p->GetName());
+
 	std::unique_ptr<Person> p2 = std::make_unique<Person>("James", 75);
 	std::unique_ptr<Person> p3 = std::make_unique<Person>("Tina", 52);
 
@@ -56,6 +76,26 @@ int main()
 
 	assert(a.GetPassengersCount() == 0);
 	assert(b.GetPassengersCount() == 0);
+	assert(bp.GetPassengersWeight() == 85 + 75 + 52 + 78 + 48 + 88);
+	assert(bp.GetPassenger(3)->GetName() == "Peter");
+
+	// Splicing is all or nothing.
+	Boat full(2);
+	full.AddPassenger(std::make_unique<Person>("Ann", 60));
+	[[maybe_unused]] bool bSpliced = full.SplicePassengersFrom(bp);
+	assert(!bSpliced);
+	assert(bp.GetPassengersCount() == 6);
+
+	// Drop the heavy passengers while walking the manifest; order is kept.
+	[[maybe_unused]] unsigned int dropped = bp.RemovePassengersIf([](const engine::interfaces::IPassenger& passenger) { return passenger.GetWeight() > 80; });
+	assert(dropped == 2);
+	assert(bp.GetPassengersWeight() == 75 + 52 + 78 + 48);
+	assert(bp.GetPassenger(0)->GetName() == "James");
+	assert(bp.GetPassenger(3)->GetName() == "Jane");
+	for ([[maybe_unused]] const std::unique_ptr<const engine::interfaces::IPassenger>& passenger : bp.GetPassengers())
+	{
+		assert(passenger->GetWeight() <= 80);
+	}
 
 	DeusExMachina* deusExMachina1 = DeusExMachina::GetInstance();
 	[[maybe_unused]] DeusExMachina* deusExMachina2 = DeusExMachina::GetInstance();
@@ -76,6 +116,72 @@ int main()
 	bAdded = sedan2->AddTrailer(std::make_unique<Trailer>(60));
 	assert(!bAdded);
 
+	// Max speed is memoized; attaching a heavy trailer must invalidate it.
+	Sedan hauler;
+	assert(hauler.GetMaxSpeed() == 480);
+	hauler.AddTrailer(std::make_unique<Trailer>(100));
+	assert(hauler.GetMaxSpeed() == 458);
+	hauler.RemoveTrailer();
+	assert(hauler.GetMaxSpeed() == 480);
+
+	// The batch speed kernels reproduce EstimateMaxSpeed at every weight, on
+	// the vector path as well as the scalar one, and GetMaxSpeed once loaded.
+	{
+		std::vector<unsigned int> weights;
+		for (unsigned int weight = 0; weight <= 1000; ++weight)
+		{
+			weights.push_back(weight);
+		}
+		weights.push_back(5000);
+		weights.push_back(123456);
+		weights.push_back(4000000000u);
+		std::vector<unsigned int> speeds(weights.size());
+
+		auto checkKernels = [&weights, &speeds](auto& vehicle)
+		{
+			kernels::EstimateMaxSpeeds(vehicle, weights.data(), speeds.data(), weights.size());
+			for (size_t i = 0; i < weights.size(); ++i)
+			{
+				assert(speeds[i] == vehicle.EstimateMaxSpeed(weights[i]));
+			}
+
+			vehicle.AddPassenger(std::make_unique<Person>("Kernel", 77));
+			vehicle.AddPassenger(std::make_unique<Person>("Kernel", 64));
+			unsigned int loaded[4] = { vehicle.GetPassengersWeight(), vehicle.GetPassengersWeight(), vehicle.GetPassengersWeight(), vehicle.GetPassengersWeight() };
+			unsigned int loadedSpeeds[4];
+			kernels::EstimateMaxSpeeds(vehicle, loaded, loadedSpeeds, 4);
+			assert(loadedSpeeds[0] == vehicle.GetMaxSpeed() && loadedSpeeds[3] == vehicle.GetMaxSpeed());
+		};
+
+		Airplane kernelPlane(5);
+		Boatplane kernelBoatplane(5);
+		UBoat kernelUBoat;
+		Motorcycle kernelBike;
+		checkKernels(kernelPlane);
+		checkKernels(kernelBoatplane);
+		checkKernels(kernelUBoat);
+		checkKernels(kernelBike);
+
+		// Single-capability kernels match the capability accessors; each
+		// vehicle above now carries 141.
+		unsigned int loaded[4] = { 141, 141, 141, 141 };
+		unsigned int loadedSpeeds[4];
+		kernels::AirplaneFlySpeeds(kernelPlane.GetFlyingCapability().GetFlySpeed(), loaded, loadedSpeeds, 4);
+		assert(loadedSpeeds[3] == kernelPlane.GetFlySpeed());
+		kernels::AirplaneDriveSpeeds(kernelPlane.GetDrivingCapability().GetDriveSpeed(), loaded, loadedSpeeds, 4);
+		assert(loadedSpeeds[3] == kernelPlane.GetDriveSpeed());
+		kernels::BoatplaneFlySpeeds(kernelBoatplane.GetFlyingCapability().GetFlySpeed(), loaded, loadedSpeeds, 4);
+		assert(loadedSpeeds[3] == kernelBoatplane.GetFlySpeed());
+		kernels::BoatplaneSailSpeeds(kernelBoatplane.GetSailingCapability().GetSailSpeed(), loaded, loadedSpeeds, 4);
+		assert(loadedSpeeds[3] == kernelBoatplane.GetSailSpeed());
+		kernels::UBoatSailSpeeds(kernelUBoat.GetSailingCapability().GetSailSpeed(), loaded, loadedSpeeds, 4);
+		assert(loadedSpeeds[3] == kernelUBoat.GetSailSpeed());
+		kernels::UBoatDiveSpeeds(kernelUBoat.GetDivingCapability().GetDiveSpeed(), loaded, loadedSpeeds, 4);
+		assert(loadedSpeeds[3] == kernelUBoat.GetDiveSpeed());
+		kernels::MotorcycleDriveSpeeds(kernelBike.GetDrivingCapability().GetDriveSpeed(), loaded, loadedSpeeds, 4);
+		assert(loadedSpeeds[3] == kernelBike.GetDriveSpeed());
+	}
+
 	// GetFurthestTravelled raw pointer check for testing.
 	[[maybe_unused]] const Boat* boatPtr = boat.get();
 
@@ -92,33 +198,392 @@ int main()
 	deusExMachina1->AddVehicle(std::make_unique<Airplane>(5));
 	deusExMachina1->AddVehicle(std::make_unique<Airplane>(5));
 
-	bAdded = deusExMachina1->AddVehicle(std::make_unique<Airplane>(5));
+	// The fleet is no longer capped at ten vehicles.
+	engine::core::VehicleHandle extraHandle;
+	bAdded = deusExMachina1->AddVehicle(std::make_unique<Airplane>(5), &extraHandle);
 
-	assert(!bAdded);
+	assert(bAdded);
+	assert(deusExMachina1->GetVehicleCount() == 11);
+	assert(deusExMachina1->GetVehicle(extraHandle) != nullptr);
+
+	[[maybe_unused]] bool bRemoved = deusExMachina1->RemoveVehicle(extraHandle);
+	assert(bRemoved);
+	assert(!deusExMachina1->IsValid(extraHandle));
 
+	// Stale handles are rejected rather than aliasing a reused slot.
+	bAdded = deusExMachina1->AddVehicle(std::make_unique<Airplane>(5));
+	assert(bAdded);
+	bRemoved = deusExMachina1->RemoveVehicle(extraHandle);
+	assert(!bRemoved);
+	assert(deusExMachina1->GetVehicle(extraHandle) == nullptr);
+
+	deusExMachina1->RemoveVehicle(10);
 	deusExMachina1->RemoveVehicle(9);
 	deusExMachina1->RemoveVehicle(8);
-	bool bRemoved = deusExMachina1->RemoveVehicle(7);
+	bRemoved = deusExMachina1->RemoveVehicle(7);
 	assert(bRemoved);
 
 	bRemoved = deusExMachina1->RemoveVehicle(9);
 	assert(!bRemoved);
 
-	engine::core::TravelContext context;
-	deusExMachina1->Travel(context);
-	deusExMachina1->Travel(context);
-	deusExMachina1->Travel(context);
-	deusExMachina1->Travel(context);
-	deusExMachina1->Travel(context);
-	deusExMachina1->Travel(context);
-	deusExMachina1->Travel(context);
-	deusExMachina1->Travel(context);
-	deusExMachina1->Travel(context);
-	deusExMachina1->Travel(context);
-	deusExMachina1->Travel(context);
+	// One call covers all twelve hours; each vehicle advances in O(1).
+	engine::core::TravelContext context(12);
 	deusExMachina1->Travel(context);
 
 	assert(deusExMachina1->GetFurthestTravelled() == boatPtr);
+	assert(deusExMachina1->GetTopTravelled(3).size() == 3);
+	assert(deusExMachina1->GetTopTravelled(3).front() == boatPtr);
+	assert(deusExMachina1->GetTravelPercentile(100.0) == boatPtr);
+	assert(!engine::core::EngineMetrics::IS_ENABLED || engine::core::EngineMetrics::Read().ticks == 1);
+
+	// Checkpoint the fleet and bring it back in a fresh engine.
+	engine::core::VehicleTypeRegistry vehicleTypes;
+	RegisterVehicleTypes(vehicleTypes);
+	engine::core::FleetSnapshot snapshot(vehicleTypes);
+	const char* snapshotPath = "machina_fleet.snapshot";
+	[[maybe_unused]] unsigned int furthestOdo = boatPtr->GetOdo();
+	[[maybe_unused]] size_t fleetSize = deusExMachina1->GetVehicleCount();
+
+	[[maybe_unused]] bool bSaved = snapshot.Save(*deusExMachina1, snapshotPath);
+	assert(bSaved);
+
+	DeusExMachina::ResetInstance();
+	deusExMachina1 = DeusExMachina::GetInstance();
+	[[maybe_unused]] bool bRestored = snapshot.Restore(*deusExMachina1, snapshotPath);
+	std::remove(snapshotPath);
+
+	assert(bRestored);
+	assert(deusExMachina1->GetVehicleCount() == fleetSize);
+	assert(deusExMachina1->GetFurthestTravelled()->GetOdo() == furthestOdo);
+
+	// Journal a few ticks and rebuild the same fleet from the journal.
+	const char* journalPath = "machina_fleet.journal";
+	[[maybe_unused]] bool bJournaling = deusExMachina1->StartJournal(journalPath, vehicleTypes);
+	assert(bJournaling);
+
+	deusExMachina1->GetVehicle(deusExMachina1->GetVehicleHandle(0))->ReleaseAllPassengers();
+	deusExMachina1->RemoveVehicle(1u);
+	for (unsigned int tick = 0; tick < 24; ++tick)
+	{
+		deusExMachina1->Travel(engine::core::TravelContext(1));
+
+		// Polled every tick, the leaderboard is re-sorted inside Travel.
+		[[maybe_unused]] std::vector<const engine::vehicles::Vehicle*> leaders = deusExMachina1->GetTopTravelled(deusExMachina1->GetVehicleCount());
+		assert(leaders.size() == deusExMachina1->GetVehicleCount());
+		assert(leaders.front() == deusExMachina1->GetFurthestTravelled());
+		for (size_t rank = 1; rank < leaders.size(); ++rank)
+		{
+			assert(leaders[rank - 1]->GetOdo() >= leaders[rank]->GetOdo());
+		}
+		assert(deusExMachina1->GetTravelPercentile(100.0) == leaders.front());
+		assert(deusExMachina1->GetTravelRank(deusExMachina1->GetVehicleHandle(0)) >= 1);
+	}
+	deusExMachina1->StopJournal();
+	furthestOdo = deusExMachina1->GetFurthestTravelled()->GetOdo();
+	fleetSize = deusExMachina1->GetVehicleCount();
+
+	DeusExMachina::ResetInstance();
+	deusExMachina1 = DeusExMachina::GetInstance();
+	engine::core::JournalReplay replay(vehicleTypes);
+	[[maybe_unused]] bool bReplayed = replay.Replay(*deusExMachina1, journalPath);
+	std::remove(journalPath);
+
+	assert(bReplayed);
+	assert(replay.GetTravelCallCount() == 1);
+	assert(deusExMachina1->GetVehicleCount() == fleetSize);
+	assert(deusExMachina1->GetFurthestTravelled()->GetOdo() == furthestOdo);
+
+	// A LAZY engine settles to exactly what an EAGER one computes.
+	DeusExMachina eager;
+	DeusExMachina lazy;
+	lazy.SetTravelMode(DeusExMachina::TravelMode::LAZY);
+	for (DeusExMachina* engine : { &eager, &lazy })
+	{
+		engine->AddVehicle(std::make_unique<Sedan>());
+		engine->AddVehicle(std::make_unique<UBoat>());
+		for (unsigned int tick = 0; tick < 24; ++tick)
+		{
+			if (tick == 10)
+			{
+				engine->GetVehicle(engine->GetVehicleHandle(0))->AddPassenger(std::make_unique<Person>("Late", 90));
+			}
+			engine->Travel(engine::core::TravelContext(1));
+		}
+	}
+	assert(lazy.GetTravelMode() == DeusExMachina::TravelMode::LAZY);
+	assert(lazy.GetFurthestTravelled()->GetOdo() == eager.GetFurthestTravelled()->GetOdo());
+	assert(lazy.GetVehicle(lazy.GetVehicleHandle(0))->GetOdo() == eager.GetVehicle(eager.GetVehicleHandle(0))->GetOdo());
+
+	// TravelAsync publishes a view that matches the synchronous result; until
+	// then readers see the last published tick.
+	DeusExMachina async;
+	async.AddVehicle(std::make_unique<Sedan>());
+	async.AddVehicle(std::make_unique<UBoat>());
+	assert(async.GetTravelView()->GetVehicleCount() == 0);
+	async.GetVehicle(async.GetVehicleHandle(0))->AddPassenger(std::make_unique<Person>("Late", 90));
+	for (unsigned int tick = 0; tick < 24; ++tick)
+	{
+		async.TravelAsync(engine::core::TravelContext(1)).get();
+	}
+	{
+		engine::core::TravelViewLease view = async.GetTravelView();
+		[[maybe_unused]] engine::core::DutyCycleState viewState;
+		assert(view->GetTick() == 24);
+		assert(view->GetVehicleCount() == 2);
+		assert(view->TryGetState(async.GetVehicleHandle(1), viewState));
+		assert(viewState.odo == async.GetVehicle(async.GetVehicleHandle(1))->GetOdo());
+		assert(view->TryGetState(view->GetFurthestTravelled(), viewState));
+		assert(viewState.odo == async.GetFurthestTravelled()->GetOdo());
+	}
+
+	// Queued mutations land at the next tick, in the order they were made.
+	DeusExMachina ingest;
+	engine::core::VehicleHandle boatHandle;
+	ingest.AddVehicle(std::make_unique<Boat>(2), &boatHandle);
+	ingest.EnqueueAddVehicle(std::make_unique<Sedan>());
+	ingest.EnqueueAddPassenger(boatHandle, std::make_unique<Person>("Queued", 70));
+	ingest.EnqueueAddPassenger(boatHandle, std::make_unique<Person>("Queued", 80));
+	ingest.EnqueueAddPassenger(boatHandle, std::make_unique<Person>("Overflow", 90));
+	ingest.EnqueueRemovePassenger(boatHandle, 0);
+	assert(ingest.GetVehicleCount() == 1);
+	ingest.Travel(context);
+	assert(ingest.GetVehicleCount() == 2);
+	assert(ingest.GetVehicle(boatHandle)->GetPassengersCount() == 1);
+	assert(ingest.GetVehicle(boatHandle)->GetPassengersWeight() == 80);
+	ingest.EnqueueRemoveVehicle(boatHandle);
+	ingest.EnqueueRemoveVehicle(boatHandle);
+	assert(ingest.ApplyCommands() == 1);
+	assert(!ingest.IsValid(boatHandle));
+
+	// Capability queries see only the vehicles that have the capability, at
+	// their current effective speed.
+	DeusExMachina dispatch;
+	engine::core::VehicleHandle lightSub;
+	engine::core::VehicleHandle heavySub;
+	dispatch.AddVehicle(std::make_unique<Airplane>(5));
+	dispatch.AddVehicle(std::make_unique<UBoat>(), &lightSub);
+	dispatch.AddVehicle(std::make_unique<Sedan>());
+	dispatch.AddVehicle(std::make_unique<UBoat>(), &heavySub);
+	dispatch.AddVehicle(std::make_unique<Boatplane>(5));
+	assert(dispatch.GetCapableCount(engine::capabilities::Capability::FLYING) == 2);
+	assert(dispatch.GetCapableCount(engine::capabilities::Capability::DRIVING) == 2);
+	assert(dispatch.FindCapable(engine::capabilities::ToMask(engine::capabilities::Capability::SAILING)
+		| engine::capabilities::ToMask(engine::capabilities::Capability::DIVING)).size() == 2);
+	dispatch.GetVehicle(heavySub)->AddPassenger(std::make_unique<Person>("Diver", 200));
+	assert(dispatch.GetFastestCapable(engine::capabilities::Capability::DIVING) == dispatch.GetVehicle(heavySub));
+	assert(dispatch.GetFastestCapable(engine::capabilities::Capability::DIVING, 100) == dispatch.GetVehicle(lightSub));
+	dispatch.RemoveVehicle(lightSub);
+	assert(dispatch.GetFastestCapable(engine::capabilities::Capability::DIVING, 100) == nullptr);
+	assert(dispatch.GetCapableCount(engine::capabilities::Capability::SAILING) == 2);
+
+	// Planned boarding covers at least the distance first-fit boarding does,
+	// and leaves the heaviest passengers behind when seats run out.
+	DeusExMachina planned;
+	DeusExMachina firstFit;
+	for (DeusExMachina* engine : { &planned, &firstFit })
+	{
+		engine->AddVehicle(std::make_unique<Airplane>(2));
+		engine->AddVehicle(std::make_unique<Motorcycle>());
+		engine->AddVehicle(std::make_unique<Sedan>());
+		engine->AddVehicle(std::make_unique<Boat>(2));
+	}
+	std::vector<std::unique_ptr<const engine::interfaces::IPassenger>> pool;
+	for (unsigned int weight : { 95u, 40u, 70u, 120u, 55u, 85u, 60u, 75u, 50u, 65u, 300u })
+	{
+		pool.push_back(std::make_unique<Person>("Pool", weight));
+	}
+	engine::core::BoardingPlan plan = planned.PlanBoarding(pool);
+	assert(plan.boardedCount == 10);
+	assert(plan.vehicles.back().IsNull());
+	assert(planned.Board(pool, plan) == 10);
+	assert(pool.back() != nullptr && pool.front() == nullptr);
+	for (unsigned int weight : { 95u, 40u, 70u, 120u, 55u, 85u, 60u, 75u, 50u, 65u })
+	{
+		for (unsigned int i = 0; i < firstFit.GetVehicleCount(); ++i)
+		{
+			if (firstFit.GetVehicle(firstFit.GetVehicleHandle(i))->AddPassenger(std::make_unique<Person>("Pool", weight)))
+			{
+				break;
+			}
+		}
+	}
+	planned.Travel(engine::core::TravelContext(12));
+	firstFit.Travel(engine::core::TravelContext(12));
+	unsigned int plannedOdo = 0;
+	unsigned int firstFitOdo = 0;
+	for (unsigned int i = 0; i < planned.GetVehicleCount(); ++i)
+	{
+		plannedOdo += planned.GetVehicle(planned.GetVehicleHandle(i))->GetOdo();
+		firstFitOdo += firstFit.GetVehicle(firstFit.GetVehicleHandle(i))->GetOdo();
+	}
+	assert(plannedOdo >= firstFitOdo);
+	assert(std::abs(plannedOdo / 12.0 - plan.distancePerTick) < 1.0);
+
+	// Archetypes restating the compiled types reproduce their speeds, and
+	// travel to the same odometers in either mode.
+	engine::core::ArchetypeTable archetypes;
+	[[maybe_unused]] bool bLoaded = archetypes.Load(MACHINA_DATA_DIR "/Archetypes.txt");
+	assert(bLoaded);
+	std::vector<std::unique_ptr<engine::vehicles::Vehicle>> compiled;
+	compiled.push_back(std::make_unique<Airplane>(5));
+	compiled.push_back(std::make_unique<Boat>(5));
+	compiled.push_back(std::make_unique<Boatplane>(10));
+	compiled.push_back(std::make_unique<Motorcycle>());
+	compiled.push_back(std::make_unique<Sedan>());
+	compiled.push_back(std::make_unique<UBoat>());
+	const char* restatedNames[] = { "Airplane", "Boat", "Boatplane", "Motorcycle", "Sedan", "UBoat" };
+	for (size_t type = 0; type < compiled.size(); ++type)
+	{
+		std::unique_ptr<engine::vehicles::ArchetypeVehicle> restated = engine::vehicles::ArchetypeVehicle::Create(archetypes, restatedNames[type]);
+		assert(restated != nullptr);
+		assert(restated->GetMaxPassengersCount() == compiled[type]->GetMaxPassengersCount());
+		assert(restated->GetCapabilities() == compiled[type]->GetCapabilities());
+		for (unsigned int weight = 0; weight <= 1000; ++weight)
+		{
+			assert(restated->EstimateMaxSpeed(weight) == compiled[type]->EstimateMaxSpeed(weight));
+		}
+	}
+	assert(engine::vehicles::ArchetypeVehicle::Create(archetypes, "Zeppelin") == nullptr);
+
+	DeusExMachina compiledFleet;
+	DeusExMachina archetypeFleet;
+	DeusExMachina lazyArchetypeFleet;
+	lazyArchetypeFleet.SetTravelMode(DeusExMachina::TravelMode::LAZY);
+	compiledFleet.AddVehicle(std::make_unique<Airplane>(5));
+	compiledFleet.AddVehicle(std::make_unique<UBoat>());
+	for (DeusExMachina* engine : { &archetypeFleet, &lazyArchetypeFleet })
+	{
+		engine->AddVehicle(engine::vehicles::ArchetypeVehicle::Create(archetypes, "Airplane"));
+		engine->AddVehicle(engine::vehicles::ArchetypeVehicle::Create(archetypes, "UBoat"));
+	}
+	for (DeusExMachina* engine : { &compiledFleet, &archetypeFleet, &lazyArchetypeFleet })
+	{
+		for (unsigned int tick = 0; tick < 24; ++tick)
+		{
+			if (tick == 7)
+			{
+				engine->GetVehicle(engine->GetVehicleHandle(0))->AddPassenger(std::make_unique<Person>("Late", 90));
+				engine->GetVehicle(engine->GetVehicleHandle(1))->AddPassenger(std::make_unique<Person>("Late", 140));
+			}
+			engine->Travel(engine::core::TravelContext(1));
+		}
+	}
+	for (unsigned int i = 0; i < 2; ++i)
+	{
+		[[maybe_unused]] unsigned int compiledOdo = compiledFleet.GetVehicle(compiledFleet.GetVehicleHandle(i))->GetOdo();
+		assert(archetypeFleet.GetVehicle(archetypeFleet.GetVehicleHandle(i))->GetOdo() == compiledOdo);
+		assert(lazyArchetypeFleet.GetVehicle(lazyArchetypeFleet.GetVehicleHandle(i))->GetOdo() == compiledOdo);
+	}
+	assert(archetypeFleet.GetFastestCapable(engine::capabilities::Capability::DIVING)
+		->GetCapabilitySpeed(engine::capabilities::Capability::DIVING)
+		== compiledFleet.GetVehicle(compiledFleet.GetVehicleHandle(1))->GetCapabilitySpeed(engine::capabilities::Capability::DIVING));
+
+	// A rejected definition names its line and leaves the table as it was.
+	[[maybe_unused]] bool bParsed = archetypes.Parse("archetype Blimp\ncapacity 2\nduty 1 1\nspeed flying quadratic base=90\n");
+	assert(!bParsed);
+	assert(archetypes.GetErrorLine() == 4);
+	assert(archetypes.Find("Hovercraft") != engine::core::ArchetypeTable::NONE);
+
+	// Reparsing a table nobody uses any more takes effect on the next tick,
+	// even on a thread that already travelled the old definitions.
+	{
+		engine::core::ArchetypeTable reloaded;
+		[[maybe_unused]] bool bReparsed = reloaded.Parse("archetype Cart\ncapacity 1\nduty 1 1\nspeed driving linear base=5\n");
+		assert(bReparsed);
+		DeusExMachina reloadFleet;
+		engine::core::VehicleHandle cart;
+		reloadFleet.AddVehicle(engine::vehicles::ArchetypeVehicle::Create(reloaded, "Cart"), &cart);
+		reloadFleet.Travel(engine::core::TravelContext(4));
+		reloadFleet.RemoveVehicle(cart);
+		reloadFleet.GetGraveyard().ReclaimAll();
+
+		bReparsed = reloaded.Parse("archetype Wagon\ncapacity 1\nduty 1 1\nspeed driving linear base=5\n"
+			"archetype Cart\ncapacity 1\nduty 4 0\nspeed driving linear base=10\n");
+		assert(bReparsed);
+		reloadFleet.AddVehicle(engine::vehicles::ArchetypeVehicle::Create(reloaded, "Cart"), &cart);
+		reloadFleet.Travel(engine::core::TravelContext(4));
+		assert(reloadFleet.GetVehicle(cart)->GetOdo() == 40);
+	}
+
+	// The same fleet split over three shards travels to the same odometers.
+	DeusExMachina standalone;
+	engine::core::ShardedWorld world(3);
+	for (unsigned int i = 0; i < 2; ++i)
+	{
+		standalone.AddVehicle(std::make_unique<Airplane>(5));
+		standalone.AddVehicle(std::make_unique<Boat>(5));
+		standalone.AddVehicle(std::make_unique<Motorcycle>());
+		world.AddVehicle(std::make_unique<Airplane>(5));
+		world.AddVehicle(std::make_unique<Boat>(5));
+		world.AddVehicle(std::make_unique<Motorcycle>());
+	}
+	standalone.Travel(context);
+	world.Travel(context);
+
+	assert(world.GetVehicleCount() == standalone.GetVehicleCount());
+	assert(world.GetShard(2).GetVehicleCount() == 2);
+	assert(world.GetFurthestTravelled()->GetOdo() == standalone.GetFurthestTravelled()->GetOdo());
+	assert(world.GetTopTravelled(4).back()->GetOdo() == standalone.GetTopTravelled(4).back()->GetOdo());
+
+	// Removed vehicles and released passengers wait in the graveyard; in IDLE
+	// mode until the game reclaims them.
+	{
+		DeusExMachina graves;
+		engine::core::Graveyard& graveyard = graves.GetGraveyard();
+		graveyard.SetReclaimMode(engine::core::Graveyard::ReclaimMode::IDLE);
+		engine::core::VehicleHandle doomed;
+		graves.AddVehicle(std::make_unique<Sedan>(), &doomed);
+		graves.AddVehicle(std::make_unique<Boat>(5));
+		graves.GetVehicle(doomed)->AddPassenger(std::make_unique<Person>("Doomed", 70));
+		graves.GetVehicle(graves.GetVehicleHandle(1))->AddPassenger(std::make_unique<Person>("Released", 60));
+		graves.GetVehicle(graves.GetVehicleHandle(1))->AddPassenger(std::make_unique<Person>("Released", 65));
+		graves.RemoveVehicle(doomed);
+		graveyard.Bury(graves.GetVehicle(graves.GetVehicleHandle(0))->ReleaseAllPassengers());
+		graves.Travel(engine::core::TravelContext(1));
+
+		engine::core::Graveyard::Stats graveStats = graveyard.GetStats();
+		assert(graveStats.buriedVehicles == 1 && graveStats.buriedPassengers == 3);
+		[[maybe_unused]] size_t reclaimed = graveyard.ReclaimAll();
+		assert(reclaimed == 4);
+		graveStats = graveyard.GetStats();
+		assert(graveStats.buriedVehicles == 0 && graveStats.buriedPassengers == 0);
+		assert(graveStats.reclaimedVehicles == 1 && graveStats.reclaimedPassengers == 3);
+	}
+
+	// A traced session writes one event per call, from every thread involved.
+	const char* tracePath = "machina_trace.json";
+	bool bTracing = engine::core::EngineTrace::Start(tracePath);
+	assert(bTracing == engine::core::EngineTrace::IS_ENABLED);
+	if (bTracing)
+	{
+		assert(!engine::core::EngineTrace::Start(tracePath));
+		DeusExMachina traced;
+		traced.SetTravelThreadCount(2);
+		traced.SetTravelChunkSize(64);
+		for (unsigned int i = 0; i < 256; ++i)
+		{
+			traced.AddVehicle(std::make_unique<Sedan>());
+		}
+		traced.TravelAsync(engine::core::TravelContext(1)).get();
+		Airplane tracedAirplane(5);
+		Boat tracedBoat(5);
+		[[maybe_unused]] Boatplane tracedBoatplane = tracedAirplane + tracedBoat;
+		engine::core::EngineTrace::Stop();
+
+		std::ifstream traceFile(tracePath);
+		std::stringstream traceText;
+		traceText << traceFile.rdbuf();
+		traceFile.close();
+		std::remove(tracePath);
+
+		[[maybe_unused]] std::string trace = traceText.str();
+		assert(trace.rfind("{\"traceEvents\":[", 0) == 0);
+		assert(trace.find("\"name\":\"DeusExMachina::Travel\"") != std::string::npos);
+		assert(trace.find("\"name\":\"DeusExMachina::AddVehicle\"") != std::string::npos);
+		assert(trace.find("\"name\":\"Airplane::operator+\"") != std::string::npos);
+		assert(trace.find("\"serial executor\"") != std::string::npos);
+		assert(trace.find("\"droppedEvents\":0}}") != std::string::npos);
+	}
 
 	return 0;
 }